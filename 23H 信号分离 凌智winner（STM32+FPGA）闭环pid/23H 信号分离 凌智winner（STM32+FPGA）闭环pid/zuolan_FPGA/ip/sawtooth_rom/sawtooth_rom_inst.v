@@ -1,5 +0,0 @@
-sawtooth_rom	sawtooth_rom_inst (
-	.address ( address_sig ),
-	.clock ( clock_sig ),
-	.q ( q_sig )
-	);
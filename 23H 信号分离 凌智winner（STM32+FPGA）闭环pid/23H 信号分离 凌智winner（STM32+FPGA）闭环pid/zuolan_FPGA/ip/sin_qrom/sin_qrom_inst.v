@@ -0,0 +1,8 @@
+sin_qrom	sin_qrom_inst (
+	.address_a ( address_a_sig ),
+	.address_b ( address_b_sig ),
+	.clock_a ( clock_a_sig ),
+	.clock_b ( clock_b_sig ),
+	.q_a ( q_a_sig ),
+	.q_b ( q_b_sig )
+	);
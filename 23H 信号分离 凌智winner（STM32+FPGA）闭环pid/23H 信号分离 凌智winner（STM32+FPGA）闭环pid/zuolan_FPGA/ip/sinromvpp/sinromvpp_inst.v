@@ -1,5 +0,0 @@
-sinromvpp	sinromvpp_inst (
-	.address ( address_sig ),
-	.clock ( clock_sig ),
-	.q ( q_sig )
-	);
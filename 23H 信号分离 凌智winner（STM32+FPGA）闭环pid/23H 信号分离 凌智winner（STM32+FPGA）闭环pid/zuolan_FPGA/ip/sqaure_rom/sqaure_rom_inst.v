@@ -1,5 +0,0 @@
-sqaure_rom	sqaure_rom_inst (
-	.address ( address_sig ),
-	.clock ( clock_sig ),
-	.q ( q_sig )
-	);
@@ -1,5 +0,0 @@
-triangle_rom	triangle_rom_inst (
-	.address ( address_sig ),
-	.clock ( clock_sig ),
-	.q ( q_sig )
-	);
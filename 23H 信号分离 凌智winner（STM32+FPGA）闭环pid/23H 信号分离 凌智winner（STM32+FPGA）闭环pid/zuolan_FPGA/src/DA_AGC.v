@@ -0,0 +1,258 @@
+//&----------------------------------------------------------------------------------------
+//& 模块名: DA_AGC
+//& 文件名: DA_AGC.v
+//& 作  者: 左岚
+//& 日  期: 2025-07-18
+//&
+//& 功  能: DA输出自动增益控制(AGC)。对一路AD采样数据做逐窗口峰峰值检测，
+//&         与目标峰峰值比较后经定点PI控制器得到幅度增益，直接驱动目标通道的
+//&         VOLTAGE_SCALER_CLOCKED，闭环在FPGA内完成，不需要MCU读FIFO和参与计算。
+//&         每个检测窗口结束即更新一次增益，调节周期为窗口长度 (微秒级)。
+//&
+//& 寄存器映射 (BASE 为参数, 只写):
+//&   BASE+0 : 控制字 [0] 使能
+//&                   [1] 检测源 (0=AD1, 1=AD2)
+//&                   [2] 目标通道 (0=A通道/DA1, 1=B通道/DA2)
+//&                   [3] 状态字选择 (0=峰峰值与标志, 1=当前增益)
+//&   BASE+1 : 目标峰峰值 [11:0], 与MCU读到的AD码值同单位
+//&   BASE+2 : 检测窗口长度 (AD采样点数, 至少覆盖被测信号一个周期)
+//&   BASE+3 : 比例系数 Kp (Q8.8, 单位: 增益LSB/码值)
+//&   BASE+4 : 积分系数 Ki (Q8.8, 单位: 增益LSB/码值/窗口)
+//& 状态字 (FMC读地址15):
+//&   选择0: [15] 锁定 (连续4个窗口误差不超过目标值的1/64)
+//&          [14] 输出饱和  [11:0] 最近一个窗口的峰峰值
+//&   选择1: [15:0] 当前增益 (Q1.16, 65536对应 DEFAULT_PEAK_MV)
+//&
+//& 设计说明:
+//& - 检测和PI运行在CLK(CLK_BASE)时钟域。AD采样时钟AD1_FS/AD2_FS本身是CLK域
+//&   NCO的寄存器输出，在其下降沿(AD数据稳定窗口中部)取AD引脚数据，与FIFO写入
+//&   的是同一串样点。AD引脚位序与数据相反，先做位序反转 (同 AD_DATA_DEAL)。
+//& - 关闭时积分器跟随总线设定的峰峰值 (VOLTAGE_A/B 换算成增益)，开启瞬间输出
+//&   不跳变；积分器限幅在 [0, MAX_PEAK_MV]，不会积分饱和。
+//& - 增益经请求/应答握手送入各通道的DA时钟域 (同 DA_MODULATOR)。
+//&----------------------------------------------------------------------------------------
+
+module DA_AGC #(
+    parameter BASE            = 16'h0060,  // 寄存器组起始地址
+    parameter DEFAULT_PEAK_MV = 3080,      // 增益1.0对应的峰值电压, 与 VOLTAGE_SCALER_CLOCKED 一致
+    parameter MAX_PEAK_MV     = 3000       // 输出峰值电压上限 (mV)
+) (
+    // --- 端口定义 ---
+    input             CLK,         // 系统主时钟 (CLK_BASE)
+    input             CLK_A,       // A通道DA时钟
+    input             CLK_B,       // B通道DA时钟
+    // -- 总线写控制
+    input             CS,          // 片选信号，低电平有效
+    input             WR_EN,       // 写使能信号，高电平有效
+    input      [15:0] ADDR,        // 16位地址总线
+    input      [15:0] DATA,        // 16位数据总线
+    // -- 检测输入
+    input             AD1_FS,      // AD1 采样时钟 (CLK域)
+    input             AD2_FS,      // AD2 采样时钟 (CLK域)
+    input      [11:0] AD1_INPUT,   // AD1 引脚数据 (位序反转)
+    input      [11:0] AD2_INPUT,   // AD2 引脚数据 (位序反转)
+    // -- 总线设定的峰值电压 (mV), 作为开启时的起点
+    input      [11:0] VOLTAGE_A,
+    input      [11:0] VOLTAGE_B,
+    // -- 增益输出 (接 VOLTAGE_SCALER_CLOCKED)
+    output            AGC_EN_A,    // A通道由AGC接管
+    output            AGC_EN_B,    // B通道由AGC接管
+    output     [17:0] AGC_GAIN_A,  // A通道增益 Q1.16 (CLK_A域)
+    output     [17:0] AGC_GAIN_B,  // B通道增益 Q1.16 (CLK_B域)
+    output     [15:0] STATUS       // 状态字 (FMC读地址15)
+);
+
+  // mV 到 Q1.16 增益的换算系数 (Q.16): 2^32 / DEFAULT_PEAK_MV
+  localparam [31:0] MV_TO_GAIN = (64'd1 << 32) / DEFAULT_PEAK_MV;
+  localparam [17:0] GAIN_MAX = (MV_TO_GAIN * 64'd1 * MAX_PEAK_MV) >> 16;
+  localparam signed [31:0] INTEG_MAX = {6'd0, GAIN_MAX, 8'd0};  // 积分器带8位小数
+
+  //==================================================================================
+  //== 寄存器组
+  //==================================================================================
+  reg [ 3:0] AGC_CTRL = 4'd0;
+  reg [11:0] AGC_TARGET = 12'd0;
+  reg [15:0] AGC_WIN = 16'd1024;
+  reg [15:0] AGC_KP = 16'd0;
+  reg [15:0] AGC_KI = 16'd0;
+
+  always @(posedge CLK) begin
+    if (!CS && WR_EN && (ADDR[15:4] == BASE[15:4])) begin
+      case (ADDR[3:0])
+        4'h0: AGC_CTRL <= DATA[3:0];
+        4'h1: AGC_TARGET <= DATA[11:0];
+        4'h2: AGC_WIN <= DATA;
+        4'h3: AGC_KP <= DATA;
+        4'h4: AGC_KI <= DATA;
+        default: ;
+      endcase
+    end
+  end
+
+  wire enable = AGC_CTRL[0];
+  wire src_b = AGC_CTRL[1];
+  wire target_b = AGC_CTRL[2];
+  wire status_sel = AGC_CTRL[3];
+
+  //==================================================================================
+  //== 峰峰值检测 (CLK域)
+  //==================================================================================
+  function [11:0] bit_reverse;
+    input [11:0] d;
+    integer n;
+    begin
+      for (n = 0; n < 12; n = n + 1) bit_reverse[n] = d[11-n];
+    end
+  endfunction
+
+  reg        fs_d = 1'b0;
+  reg [11:0] ad_pin = 12'd0;  // 引脚输入寄存器
+
+  always @(posedge CLK) begin
+    fs_d   <= src_b ? AD2_FS : AD1_FS;
+    ad_pin <= src_b ? AD2_INPUT : AD1_INPUT;
+  end
+
+  // 采样时钟下降沿的下一拍: ad_pin 正好是下降沿时刻的引脚数据
+  wire        sample_en = fs_d & ~(src_b ? AD2_FS : AD1_FS);
+  wire [11:0] sample = bit_reverse(ad_pin);
+  wire [15:0] win_last = (AGC_WIN == 16'd0) ? 16'd0 : AGC_WIN - 16'd1;
+
+  reg  [15:0] win_cnt = 16'd0;
+  reg  [11:0] win_max = 12'd0;
+  reg  [11:0] win_min = 12'hFFF;
+  reg  [11:0] pp = 12'd0;  // 最近一个窗口的峰峰值
+  reg         pp_valid = 1'b0;
+
+  wire [11:0] cur_max = (sample > win_max) ? sample : win_max;
+  wire [11:0] cur_min = (sample < win_min) ? sample : win_min;
+
+  always @(posedge CLK) begin
+    pp_valid <= 1'b0;
+    if (!enable) begin
+      win_cnt <= 16'd0;
+      win_max <= 12'd0;
+      win_min <= 12'hFFF;
+    end else if (sample_en) begin
+      if (win_cnt >= win_last) begin
+        pp       <= cur_max - cur_min;
+        pp_valid <= 1'b1;
+        win_cnt  <= 16'd0;
+        win_max  <= 12'd0;
+        win_min  <= 12'hFFF;
+      end else begin
+        win_cnt <= win_cnt + 16'd1;
+        win_max <= cur_max;
+        win_min <= cur_min;
+      end
+    end
+  end
+
+  //==================================================================================
+  //== PI 控制器 (CLK域, 每个窗口更新一次, 3级流水)
+  //==================================================================================
+  // 起点: 总线设定的峰值电压换算为增益
+  wire [43:0] start_prod = (target_b ? VOLTAGE_B : VOLTAGE_A) * MV_TO_GAIN;
+  wire [17:0] start_gain = (start_prod[43:16] > GAIN_MAX) ? GAIN_MAX : start_prod[33:16];
+
+  reg signed [12:0] err = 13'sd0;
+  reg signed [31:0] p_term = 32'sd0;
+  reg signed [31:0] integ = 32'sd0;  // 积分器, Q.8 增益
+  reg         [1:0] pi_stage = 2'd0;
+  reg        [17:0] gain = 18'd0;
+  reg               saturated = 1'b0;
+  reg         [2:0] lock_cnt = 3'd0;
+
+  wire signed [31:0] integ_next = integ + $signed({1'b0, AGC_KI}) * err;
+  wire signed [31:0] u = integ + p_term;
+  wire        [12:0] err_abs = err[12] ? -err : err;
+
+  always @(posedge CLK) begin
+    pi_stage <= {pi_stage[0], pp_valid};
+    if (!enable) begin
+      integ     <= $signed({6'd0, start_gain, 8'd0});
+      gain      <= start_gain;
+      saturated <= 1'b0;
+      lock_cnt  <= 3'd0;
+    end else begin
+      // 第1级: 误差
+      if (pp_valid) err <= $signed({1'b0, AGC_TARGET}) - $signed({1'b0, pp});
+      // 第2级: 比例项与积分 (积分器限幅)
+      if (pi_stage[0]) begin
+        p_term <= $signed({1'b0, AGC_KP}) * err;
+        if (integ_next < 0) integ <= 32'sd0;
+        else if (integ_next > INTEG_MAX) integ <= INTEG_MAX;
+        else integ <= integ_next;
+        if (err_abs <= (AGC_TARGET >> 6)) lock_cnt <= (lock_cnt == 3'd4) ? lock_cnt : lock_cnt + 3'd1;
+        else lock_cnt <= 3'd0;
+      end
+      // 第3级: 输出限幅
+      if (pi_stage[1]) begin
+        if (u < 0) begin
+          gain      <= 18'd0;
+          saturated <= 1'b1;
+        end else if ((u >>> 8) > GAIN_MAX) begin
+          gain      <= GAIN_MAX;
+          saturated <= 1'b1;
+        end else begin
+          gain      <= u[25:8];
+          saturated <= 1'b0;
+        end
+      end
+    end
+  end
+
+  assign STATUS = status_sel ? gain[15:0] : {(lock_cnt == 3'd4), saturated, 2'b00, pp};
+
+  //==================================================================================
+  //== 增益跨时钟域 (请求/应答握手)
+  //==================================================================================
+  // 发送端: 上一次数据被接收端取走(ack追上req)后，装载新增益并翻转req
+  reg [17:0] hold_a = 18'd0;
+  reg [17:0] hold_b = 18'd0;
+  reg req_a = 1'b0, req_b = 1'b0;
+  reg [1:0] ack_a_sync = 2'b00, ack_b_sync = 2'b00;
+  reg ack_a = 1'b0, ack_b = 1'b0;
+
+  always @(posedge CLK) begin
+    ack_a_sync <= {ack_a_sync[0], ack_a};
+    ack_b_sync <= {ack_b_sync[0], ack_b};
+    if (ack_a_sync[1] == req_a) begin
+      hold_a <= gain;
+      req_a  <= ~req_a;
+    end
+    if (ack_b_sync[1] == req_b) begin
+      hold_b <= gain;
+      req_b  <= ~req_b;
+    end
+  end
+
+  // 接收端: 检测到req翻转后采样数据并回送ack
+  reg [ 1:0] req_a_sync = 2'b00;
+  reg [ 1:0] req_b_sync = 2'b00;
+  reg [17:0] val_a = 18'd0;
+  reg [17:0] val_b = 18'd0;
+
+  always @(posedge CLK_A) begin
+    req_a_sync <= {req_a_sync[0], req_a};
+    if (req_a_sync[1] != ack_a) begin
+      val_a <= hold_a;
+      ack_a <= req_a_sync[1];
+    end
+  end
+
+  always @(posedge CLK_B) begin
+    req_b_sync <= {req_b_sync[0], req_b};
+    if (req_b_sync[1] != ack_b) begin
+      val_b <= hold_b;
+      ack_b <= req_b_sync[1];
+    end
+  end
+
+  // 控制位为准静态配置，直接在DA时钟域使用
+  assign AGC_EN_A   = enable && !target_b;
+  assign AGC_EN_B   = enable && target_b;
+  assign AGC_GAIN_A = val_a;
+  assign AGC_GAIN_B = val_b;
+
+endmodule
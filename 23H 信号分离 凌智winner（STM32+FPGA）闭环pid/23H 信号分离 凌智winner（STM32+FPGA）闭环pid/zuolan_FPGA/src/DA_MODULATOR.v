@@ -0,0 +1,172 @@
+//&----------------------------------------------------------------------------------------
+//& 模块名: DA_MODULATOR
+//& 文件名: DA_MODULATOR.v
+//& 作  者: 左岚
+//& 日  期: 2025-07-18
+//&
+//& 功  能: DA调制器。内置一个低频振荡器(LFO)，用其正弦输出对选定DA通道进行
+//&         调幅(AM)、调频(FM)或调相(PM)，调制过程中不需要MCU参与。
+//&         由 DA_PARAMETER_CTRL 实例化：
+//&           FM 输出频率字增量，叠加到目标通道的NCO频率字上；
+//&           PM 输出相位偏移，叠加到目标通道的10位相位计数器上；
+//&           AM 输出Q1.16幅度增益，由 VOLTAGE_SCALER_CLOCKED 与峰峰值增益相乘。
+//&
+//& 寄存器映射 (BASE 为参数, 只写):
+//&   BASE+0   : 控制字 [1:0] 模式 (0=关闭, 1=AM, 2=FM, 3=PM)
+//&                     [2]   目标通道 (0=A通道/DA1, 1=B通道/DA2)
+//&   BASE+1/2 : LFO频率字 高/低16位, f_lfo = word * f_CLK / 2^32
+//&   BASE+3/4 : 调制深度 高/低16位, 含义随模式不同:
+//&              AM: 低16位为调制度 (Q0.16, 65535 约等于100%)
+//&              FM: 峰值频偏, 与NCO频率字同单位 (分辨率 2^15)
+//&              PM: 低9位为峰值相偏 (0~511, 1024对应360度)
+//&
+//& 设计说明:
+//& - LFO和调制量计算运行在CLK(CLK_BASE)时钟域。AM/PM结果需要进入各通道的DA
+//&   时钟域，采用请求/应答握手跨时钟域传递，更新速率自动适应较慢的一侧，
+//&   保证多位数据不会被拆开采样。
+//& - 三种模式共用一个乘法器 (调制深度 x 正弦值)。
+//& - LFO正弦表使用一块 sin_qrom (1/4波ROM) 的A口。
+//&----------------------------------------------------------------------------------------
+
+module DA_MODULATOR #(
+    parameter BASE = 16'h0050  // 寄存器组起始地址
+) (
+    // --- 端口定义 ---
+    input                    CLK,         // 系统主时钟 (CLK_BASE)
+    input                    CLK_A,       // A通道DA时钟
+    input                    CLK_B,       // B通道DA时钟
+    // -- 总线写控制
+    input                    CS,          // 片选信号，低电平有效
+    input                    WR_EN,       // 写使能信号，高电平有效
+    input             [15:0] ADDR,        // 16位地址总线
+    input             [15:0] DATA,        // 16位数据总线
+    // -- 调制输出
+    output reg signed [31:0] FM_DELTA_A,  // A通道频率字增量 (CLK域)
+    output reg signed [31:0] FM_DELTA_B,  // B通道频率字增量 (CLK域)
+    output            [ 9:0] PM_OFS_A,    // A通道相位偏移 (CLK_A域)
+    output            [ 9:0] PM_OFS_B,    // B通道相位偏移 (CLK_B域)
+    output            [17:0] AM_GAIN_A,   // A通道幅度增益 Q1.16 (CLK_A域)
+    output            [17:0] AM_GAIN_B    // B通道幅度增益 Q1.16 (CLK_B域)
+);
+
+  localparam MODE_OFF = 2'd0;
+  localparam MODE_AM = 2'd1;
+  localparam MODE_FM = 2'd2;
+  localparam MODE_PM = 2'd3;
+
+  //==================================================================================
+  //== 寄存器组
+  //==================================================================================
+  reg [ 2:0] MOD_CTRL = 3'd0;
+  reg [31:0] LFO_WORD = 32'd0;
+  reg [31:0] DEPTH = 32'd0;
+
+  always @(posedge CLK) begin
+    if (!CS && WR_EN && (ADDR[15:4] == BASE[15:4])) begin
+      case (ADDR[3:0])
+        4'h0: MOD_CTRL <= DATA[2:0];
+        4'h1: LFO_WORD[31:16] <= DATA;
+        4'h2: LFO_WORD[15:0] <= DATA;
+        4'h3: DEPTH[31:16] <= DATA;
+        4'h4: DEPTH[15:0] <= DATA;
+        default: ;
+      endcase
+    end
+  end
+
+  wire [1:0] mode = MOD_CTRL[1:0];
+  wire       target_b = MOD_CTRL[2];
+
+  //==================================================================================
+  //== LFO 与调制量计算 (CLK域)
+  //==================================================================================
+  reg  [31:0] LFO_ACC = 32'd0;
+  reg         lfo_neg;  // 对齐ROM输出的半周标志
+  wire [ 7:0] lfo_qaddr = LFO_ACC[30] ? ~LFO_ACC[29:22] : LFO_ACC[29:22];
+  wire [12:0] lfo_mag;
+
+  reg signed [13:0] lfo_sin;  // 带符号正弦值 (+-8191)
+  reg signed [31:0] mod_prod;  // 调制深度 x 正弦值
+
+  // FM 深度取高17位，AM/PM 深度取低16位
+  wire [16:0] coef = (mode == MODE_FM) ? DEPTH[31:15] : {1'b0, DEPTH[15:0]};
+
+  sin_qrom lfo_rom (
+      .address_a(lfo_qaddr),
+      .address_b(8'd0),
+      .clock_a  (CLK),
+      .clock_b  (CLK),
+      .q_a      (lfo_mag),
+      .q_b      ()
+  );
+
+  always @(posedge CLK) begin
+    if (mode == MODE_OFF) LFO_ACC <= 32'd0;
+    else LFO_ACC <= LFO_ACC + LFO_WORD;
+    lfo_neg  <= LFO_ACC[31];
+    lfo_sin  <= lfo_neg ? -$signed({1'b0, lfo_mag}) : $signed({1'b0, lfo_mag});
+    mod_prod <= $signed({1'b0, coef}) * lfo_sin;
+  end
+
+  // 调制量: mod_prod / 8192，AM为增益增量(Q.16)，PM为相位偏移
+  wire signed [17:0] mod_val = mod_prod >>> 13;
+  // FM频偏: DEPTH[31:15] * sin / 8192 * 2^15 = mod_prod * 4
+  wire signed [31:0] fm_val = mod_prod <<< 2;
+
+  always @(posedge CLK) begin
+    FM_DELTA_A <= (mode == MODE_FM && !target_b) ? fm_val : 32'sd0;
+    FM_DELTA_B <= (mode == MODE_FM && target_b) ? fm_val : 32'sd0;
+  end
+
+  //==================================================================================
+  //== AM/PM 调制量跨时钟域 (请求/应答握手)
+  //==================================================================================
+  // 发送端: 上一次数据被接收端取走(ack追上req)后，装载新数据并翻转req
+  reg signed [17:0] hold_a = 18'sd0;
+  reg signed [17:0] hold_b = 18'sd0;
+  reg req_a = 1'b0, req_b = 1'b0;
+  reg [1:0] ack_a_sync = 2'b00, ack_b_sync = 2'b00;
+  reg ack_a = 1'b0, ack_b = 1'b0;
+
+  always @(posedge CLK) begin
+    ack_a_sync <= {ack_a_sync[0], ack_a};
+    ack_b_sync <= {ack_b_sync[0], ack_b};
+    if (ack_a_sync[1] == req_a) begin
+      hold_a <= (!target_b) ? mod_val : 18'sd0;
+      req_a  <= ~req_a;
+    end
+    if (ack_b_sync[1] == req_b) begin
+      hold_b <= target_b ? mod_val : 18'sd0;
+      req_b  <= ~req_b;
+    end
+  end
+
+  // 接收端: 检测到req翻转后采样数据并回送ack
+  reg        [1:0] req_a_sync = 2'b00;
+  reg        [1:0] req_b_sync = 2'b00;
+  reg signed [17:0] val_a = 18'sd0;
+  reg signed [17:0] val_b = 18'sd0;
+
+  always @(posedge CLK_A) begin
+    req_a_sync <= {req_a_sync[0], req_a};
+    if (req_a_sync[1] != ack_a) begin
+      val_a <= hold_a;
+      ack_a <= req_a_sync[1];
+    end
+  end
+
+  always @(posedge CLK_B) begin
+    req_b_sync <= {req_b_sync[0], req_b};
+    if (req_b_sync[1] != ack_b) begin
+      val_b <= hold_b;
+      ack_b <= req_b_sync[1];
+    end
+  end
+
+  // 模式位为准静态配置，直接在DA时钟域使用
+  assign AM_GAIN_A = (mode == MODE_AM) ? 18'd65536 + val_a : 18'd65536;
+  assign AM_GAIN_B = (mode == MODE_AM) ? 18'd65536 + val_b : 18'd65536;
+  assign PM_OFS_A  = (mode == MODE_PM) ? val_a[9:0] : 10'd0;
+  assign PM_OFS_B  = (mode == MODE_PM) ? val_b[9:0] : 10'd0;
+
+endmodule
@@ -0,0 +1,233 @@
+//&----------------------------------------------------------------------------------------
+//& 模块名: DA_MULTITONE
+//& 文件名: DA_MULTITONE.v
+//& 作  者: 左岚
+//& 日  期: 2025-07-18
+//&
+//& 功  能: 多音(谐波叠加)波形合成模块。以同一个10位基波相位为基准，合成
+//&         最多8个谐波分量并求和输出:
+//&             out = 8192 + sum( A_k * sin(2*pi*(h_k*p + phi_k)/1024) )
+//&         每个分量有独立的幅度寄存器和 相位/谐波次数 寄存器，均由FMC总线写入。
+//&         由 DA_WAVEFORM_A/B 在波形选择码为4时选用。
+//&
+//& 寄存器映射 (BASE 为参数, 每个通道占用16个地址):
+//&   BASE + 2k     : 第k个分量幅度 A_k，无符号Q0.16 (65535 约等于满幅)
+//&   BASE + 2k + 1 : [9:0]  第k个分量初相 phi_k (0~1023 对应 0~360度)
+//&                   [15:10] 谐波次数 h_k (0表示该分量关闭)
+//&   各分量幅度之和应不大于65535，超出部分在输出端饱和。
+//&
+//& 设计说明:
+//& - 所有分量都是基波相位的整数倍，合成结果只取决于10位相位p，因此不在DA时钟下
+//&   实时求和，而是在总线时钟域(CLK_BUS)把一个周期的1024点算好写入波形表RAM，
+//&   DA时钟域(CLK)只按相位查表。输出速率与分量数无关。
+//& - 波形表由一个乘加单元(MAC)分时计算：每个CLK_BUS周期处理一个(点,分量)，
+//&   1024点 x 8分量 = 8192个周期，150MHz下约55us。任一寄存器被写入后自动重建，
+//&   重建期间输出为新旧波形的混合。
+//& - 各分量相位用累加器递推 (每算完一个点加一次 h_k)，不需要计算 h_k*p；
+//&   整个模块只占用一个18x18乘法器、一块1/4波正弦ROM(sin_qrom，只用A口)
+//&   和一块1024x14双时钟RAM(2块M9K)。
+//& - 寄存器与波形表重建同在总线时钟域，只有波形表RAM跨时钟域读出。
+//& - 查表输出延迟为2个CLK周期。
+//&----------------------------------------------------------------------------------------
+
+module DA_MULTITONE #(
+    parameter BASE = 16'h0020  // 寄存器组起始地址
+) (
+    // --- 端口定义 ---
+    input             CLK,      // DA时钟 (每个时钟输出一个采样点)
+    input      [ 9:0] PHASE,    // 10位基波相位
+    // -- 总线写控制
+    input             CLK_BUS,  // 总线时钟域 (CLKBASE)
+    input             CS,       // 片选信号，低电平有效
+    input             WR_EN,    // 写使能信号，高电平有效
+    input      [15:0] ADDR,     // 16位地址总线
+    input      [15:0] DATA,     // 16位数据总线
+    // -- 输出
+    output reg [13:0] WAVE      // 14位合成波形 (0~16383，以8192为中心)
+);
+
+  localparam TONES = 8;
+
+  //==================================================================================
+  //== 寄存器组 (总线时钟域)
+  //==================================================================================
+  reg [15:0] AMP    [0:TONES-1];  // 幅度寄存器
+  reg [15:0] PH_HARM[0:TONES-1];  // [9:0]初相, [15:10]谐波次数
+
+  wire       reg_wr = !CS && WR_EN && (ADDR[15:4] == BASE[15:4]);
+
+  integer i;
+  initial begin
+    for (i = 0; i < TONES; i = i + 1) begin
+      AMP[i]     = 16'd0;
+      PH_HARM[i] = 16'd0;
+    end
+  end
+
+  always @(posedge CLK_BUS) begin
+    if (reg_wr) begin
+      if (ADDR[0]) PH_HARM[ADDR[3:1]] <= DATA;
+      else AMP[ADDR[3:1]] <= DATA;
+    end
+  end
+
+  //==================================================================================
+  //== 波形表重建 (总线时钟域)
+  //==================================================================================
+  reg        dirty = 1'b1;  // 寄存器已改变，需要重建 (上电后先建一次表)
+  reg        building = 1'b0;
+  reg [ 9:0] bld_n = 10'd0;  // 当前点
+  reg [ 2:0] bld_k = 3'd0;  // 当前分量
+  reg [ 9:0] ph_acc[0:TONES-1];  // 各分量在当前点的相位 h_k*n + phi_k
+
+  integer j;
+
+  // --- 级0: 发出(点,分量)，推进相位累加器 ---
+  always @(posedge CLK_BUS) begin
+    if (!building) begin
+      if (dirty) begin
+        building <= 1'b1;
+        bld_n    <= 10'd0;
+        bld_k    <= 3'd0;
+        for (j = 0; j < TONES; j = j + 1) ph_acc[j] <= PH_HARM[j][9:0];
+      end
+    end else begin
+      ph_acc[bld_k] <= ph_acc[bld_k] + PH_HARM[bld_k][15:10];
+      bld_k         <= bld_k + 3'd1;
+      if (bld_k == TONES - 1) begin
+        bld_n <= bld_n + 10'd1;
+        if (bld_n == 10'd1023) building <= 1'b0;
+      end
+    end
+  end
+
+  // 重建开始时清除标志；重建过程中再被写入则重建完成后再来一次
+  always @(posedge CLK_BUS) begin
+    if (reg_wr) dirty <= 1'b1;
+    else if (!building) dirty <= 1'b0;
+  end
+
+  // --- 级1: 取分量相位、幅度 ---
+  reg         [ 9:0] s1_ph;
+  reg         [15:0] s1_amp;
+  reg                s1_on;  // 谐波次数非0
+  reg                s1_v = 1'b0, s1_first, s1_last;
+  reg         [ 9:0] s1_n;
+
+  always @(posedge CLK_BUS) begin
+    s1_v     <= building;
+    s1_ph    <= ph_acc[bld_k];
+    s1_amp   <= AMP[bld_k];
+    s1_on    <= (PH_HARM[bld_k][15:10] != 6'd0);
+    s1_first <= (bld_k == 3'd0);
+    s1_last  <= (bld_k == TONES - 1);
+    s1_n     <= bld_n;
+  end
+
+  // --- 级2: ROM寻址 (ROM地址寄存，输出在本级之后有效) ---
+  wire        [ 7:0] rom_addr = s1_ph[8] ? ~s1_ph[7:0] : s1_ph[7:0];
+  wire        [12:0] rom_mag;
+
+  sin_qrom sin_qrom_inst (
+      .address_a(rom_addr),
+      .address_b(8'd0),
+      .clock_a  (CLK_BUS),
+      .clock_b  (CLK_BUS),
+      .q_a      (rom_mag),
+      .q_b      ()
+  );
+
+  reg                s2_neg;
+  reg         [15:0] s2_amp;
+  reg                s2_on;
+  reg                s2_v = 1'b0, s2_first, s2_last;
+  reg         [ 9:0] s2_n;
+
+  always @(posedge CLK_BUS) begin
+    s2_v     <= s1_v;
+    s2_neg   <= s1_ph[9];
+    s2_amp   <= s1_amp;
+    s2_on    <= s1_on;
+    s2_first <= s1_first;
+    s2_last  <= s1_last;
+    s2_n     <= s1_n;
+  end
+
+  // --- 级3: 带符号正弦值 ---
+  reg  signed [13:0] s3_sin;
+  reg         [15:0] s3_amp;
+  reg                s3_on;
+  reg                s3_v = 1'b0, s3_first, s3_last;
+  reg         [ 9:0] s3_n;
+
+  always @(posedge CLK_BUS) begin
+    s3_v     <= s2_v;
+    s3_sin   <= s2_neg ? -$signed({1'b0, rom_mag}) : $signed({1'b0, rom_mag});
+    s3_amp   <= s2_amp;
+    s3_on    <= s2_on;
+    s3_first <= s2_first;
+    s3_last  <= s2_last;
+    s3_n     <= s2_n;
+  end
+
+  // --- 级4: 乘以幅度 (唯一的乘法器) ---
+  reg  signed [30:0] s4_prod;
+  reg                s4_v = 1'b0, s4_first, s4_last;
+  reg         [ 9:0] s4_n;
+
+  always @(posedge CLK_BUS) begin
+    s4_v     <= s3_v;
+    // 谐波次数为0时该分量关闭
+    s4_prod  <= s3_on ? s3_sin * $signed({1'b0, s3_amp}) : 31'sd0;
+    s4_first <= s3_first;
+    s4_last  <= s3_last;
+    s4_n     <= s3_n;
+  end
+
+  // --- 级5: 累加一个点的所有分量 ---
+  reg  signed [33:0] s5_acc;
+  reg                s5_done = 1'b0;
+  reg         [ 9:0] s5_n;
+
+  always @(posedge CLK_BUS) begin
+    if (s4_v) s5_acc <= (s4_first ? 34'sd0 : s5_acc) + s4_prod;
+    s5_done <= s4_v && s4_last;
+    s5_n    <= s4_n;
+  end
+
+  // --- 级6: 缩放、加直流偏置并饱和 ---
+  wire signed [17:0] sum_scaled = s5_acc >>> 16;  // Q0.16 幅度还原
+  wire signed [18:0] wave_biased = sum_scaled + 19'sd8192;
+
+  reg         [13:0] s6_wave;
+  reg                s6_wr = 1'b0;
+  reg         [ 9:0] s6_n;
+
+  always @(posedge CLK_BUS) begin
+    s6_wr <= s5_done;
+    s6_n  <= s5_n;
+    if (wave_biased < 0) s6_wave <= 14'd0;
+    else if (wave_biased > 19'sd16383) s6_wave <= 14'd16383;
+    else s6_wave <= wave_biased[13:0];
+  end
+
+  //==================================================================================
+  //== 波形表 (写: 总线时钟域, 读: DA时钟域)
+  //==================================================================================
+  reg [13:0] wave_ram[0:1023];
+  reg [13:0] ram_q;
+
+  initial begin
+    for (i = 0; i < 1024; i = i + 1) wave_ram[i] = 14'd8192;
+  end
+
+  always @(posedge CLK_BUS) begin
+    if (s6_wr) wave_ram[s6_n] <= s6_wave;
+  end
+
+  always @(posedge CLK) begin
+    ram_q <= wave_ram[PHASE];
+    WAVE  <= ram_q;
+  end
+
+endmodule
@@ -9,6 +9,22 @@
 //&         2. 一个相位控制计数器级，它使用NCO生成的时钟，并根据外部设定的相位
 //&            值进行计数和相位同步调整。
 //&
+//& 扫频:
+//&   内部实例化 DA_SWEEP 扫频引擎 (寄存器组0x40~0x48)。扫频进行时，被选中通道的
+//&   NCO频率字由扫频引擎提供，总线写入的频率字暂不生效。
+//&
+//& 调制:
+//&   内部实例化 DA_MODULATOR 调制器 (寄存器组0x50~0x54)。FM时频率字增量叠加到
+//&   目标通道的NCO频率字上，PM时相位偏移叠加到目标通道的相位计数器输出上，
+//&   AM增益经 AM_GAIN_A/B 输出给幅度缩放模块。
+//&
+//& 相位抖动 (DITHER_EN=1, 主控制字bit12):
+//&   NCO输出时钟的边沿只能落在CLK_BASE的整周期上，累加器低位被截断造成的边沿
+//&   时间误差随频率字周期性重复，在DA输出频谱中形成确定性杂散。开启后在判断
+//&   累加器最高位之前加入 [0, 频率字) 内均匀分布的伪随机数(LFSR)，把杂散能量
+//&   打散为底噪。抖动量小于一个频率字，加抖动后的相位仍单调递增，每个输出周期
+//&   只翻转一次，不会产生毛刺时钟。
+//&
 //& 设计警告:
 //& 1. **严重警告 - 门控时钟 (Gated Clock)**:
 //&    本模块中的计数器(CNT_A, CNT_B)使用了NCO的输出(FREQ_OUT_A_FINAL, FREQ_OUT_B_FINAL)
@@ -24,12 +40,15 @@
 //&----------------------------------------------------------------------------------------
 
 module DA_PARAMETER_CTRL #(
-    parameter ADDR10 = 16'h000A,
-    parameter ADDR11 = 16'h000B
+    parameter ADDR10     = 16'h000A,
+    parameter ADDR11     = 16'h000B,
+    parameter SWEEP_BASE = 16'h0040,
+    parameter MOD_BASE   = 16'h0050
 ) (
     // --- 端口定义 ---
     input              CLK_BASE,          // 系统主时钟 (用于NCO)
     input              EN,                // NCO 全局使能
+    input              DITHER_EN,         // NCO 相位抖动使能
     // -- 频率控制字输入
     input       [15:0] FREQAH_W,          // 通道A 频率字高16位
     input       [15:0] FREQAL_W,          // 通道A 频率字低16位
@@ -42,6 +61,15 @@ module DA_PARAMETER_CTRL #(
     input              CS,                // 片选信号，低有效
     input              WR_EN,             // 写使能，高有效
     input       [15:0] ADDR,              // 地址总线
+    input       [15:0] DATA,              // 原始数据总线 (FPGA_DB)，用于扫频寄存器
+    // -- 扫频同步采集
+    input              AD1_FULL,          // AD1 FIFO 满标志
+    input              AD2_FULL,          // AD2 FIFO 满标志
+    output             SWEEP_CAP,         // 扫频采集使能 (接AD FIFO写请求)
+    output      [15:0] SWEEP_STATUS,      // 扫频状态字 (FMC读地址14)
+    // -- 调幅增益 (Q1.16, 接 VOLTAGE_SCALER_CLOCKED)
+    output      [17:0] AM_GAIN_A,         // A通道调幅增益 (DA1CLK域)
+    output      [17:0] AM_GAIN_B,         // B通道调幅增益 (DA2CLK域)
     // -- 最终输出
     output reg  [ 9:0] COUT_A_FINAL,      // 通道A 最终的10位相位计数器输出
     output reg  [ 9:0] COUT_B_FINAL,      // 通道B 最终的10位相位计数器输出
@@ -54,14 +82,85 @@ module DA_PARAMETER_CTRL #(
   //== 第一部分: 双通道NCO频率合成器
   //==================================================================================
 
+  // --- 扫频引擎 ---
+  wire        SWEEP_A_EN;
+  wire        SWEEP_B_EN;
+  wire [31:0] SWEEP_WORD;
+
+  DA_SWEEP #(
+      .BASE(SWEEP_BASE)
+  ) u_sweep (
+      .CLK       (CLK_BASE),
+      .CS        (CS),
+      .WR_EN     (WR_EN),
+      .ADDR      (ADDR),
+      .DATA      (DATA),
+      .AD1_FULL  (AD1_FULL),
+      .AD2_FULL  (AD2_FULL),
+      .SWEEP_A_EN(SWEEP_A_EN),
+      .SWEEP_B_EN(SWEEP_B_EN),
+      .SWEEP_WORD(SWEEP_WORD),
+      .SWEEP_CAP (SWEEP_CAP),
+      .STATUS    (SWEEP_STATUS)
+  );
+
+  // --- 调制器 ---
+  wire signed [31:0] FM_DELTA_A;
+  wire signed [31:0] FM_DELTA_B;
+  wire        [ 9:0] PM_OFS_A;
+  wire        [ 9:0] PM_OFS_B;
+
+  DA_MODULATOR #(
+      .BASE(MOD_BASE)
+  ) u_modulator (
+      .CLK       (CLK_BASE),
+      .CLK_A     (FREQ_OUT_A_FINAL),
+      .CLK_B     (FREQ_OUT_B_FINAL),
+      .CS        (CS),
+      .WR_EN     (WR_EN),
+      .ADDR      (ADDR),
+      .DATA      (DATA),
+      .FM_DELTA_A(FM_DELTA_A),
+      .FM_DELTA_B(FM_DELTA_B),
+      .PM_OFS_A  (PM_OFS_A),
+      .PM_OFS_B  (PM_OFS_B),
+      .AM_GAIN_A (AM_GAIN_A),
+      .AM_GAIN_B (AM_GAIN_B)
+  );
+
+  // --- 相位抖动源 ---
+  // 32位Galois LFSR (x^32+x^30+x^26+x^25+1)，每个时钟前进16步，
+  // 保证相邻两拍取出的16位抖动值互不相关
+  function [31:0] lfsr_step16;
+    input [31:0] s;
+    integer n;
+    begin
+      lfsr_step16 = s;
+      for (n = 0; n < 16; n = n + 1)
+        lfsr_step16 = lfsr_step16[0] ? ((lfsr_step16 >> 1) ^ 32'hA300_0000) : (lfsr_step16 >> 1);
+    end
+  endfunction
+
+  reg [31:0] LFSR_A = 32'h1ACE_B00C;
+  reg [31:0] LFSR_B = 32'h5EED_C0DE;
+  reg [31:0] DITHER_A = 32'd0;  // 通道A 抖动量, 范围 [0, FREQ_WORD_A)
+  reg [31:0] DITHER_B = 32'd0;  // 通道B 抖动量, 范围 [0, FREQ_WORD_B)
+
   // --- 通道 A NCO ---
   reg [31:0] FREQ_WORD_A;  // 通道A 32位频率控制字
   reg [31:0] ACC_A = 32'd0;  // 通道A 32位相位累加器
   reg        FREQ_OUT_A;  // 通道A 原始方波输出 (累加器最高位)
+  wire [31:0] ACC_A_DITH = ACC_A + DITHER_A;  // 加抖动后的相位
+
+  // 通道A 频率字寄存器 (扫频时由扫频引擎接管，FM时叠加频偏)
+  always @(posedge CLK_BASE) begin
+    FREQ_WORD_A <= (SWEEP_A_EN ? SWEEP_WORD : {FREQAH_W, FREQAL_W}) + FM_DELTA_A;
+  end
 
-  // 通道A 频率字寄存器
+  // 通道A 抖动量: 频率字高16位 x 16位随机数，即 FREQ_WORD_A * rand / 2^16
   always @(posedge CLK_BASE) begin
-    FREQ_WORD_A <= {FREQAH_W, FREQAL_W};
+    LFSR_A   <= lfsr_step16(LFSR_A);
+    DITHER_A <= DITHER_EN ? FREQ_WORD_A[31:16] * LFSR_A[15:0] : 32'd0;
   end
 
   // 通道A 相位累加器
@@ -69,20 +168,27 @@ module DA_PARAMETER_CTRL #(
     if (EN) begin
       ACC_A <= ACC_A + FREQ_WORD_A;
     end
-    FREQ_OUT_A <= ACC_A[31];
+    FREQ_OUT_A <= ACC_A_DITH[31];
   end
 
   // --- 通道 B NCO 与 相位接近检测 ---
   reg [31:0] FREQ_WORD_B;  // 通道B 32位频率控制字
   reg [31:0] ACC_B = 32'd0;  // 通道B 32位相位累加器
   reg        FREQ_OUT_B;  // 通道B 原始方波输出
+  wire [31:0] ACC_B_DITH = ACC_B + DITHER_B;  // 加抖动后的相位
 
   reg        flag;  // 瞬时的相位接近标志
   reg        flag_reg;  // 寄存后的相位接近标志，用于同步
 
-  // 通道B 频率字寄存器
+  // 通道B 频率字寄存器 (扫频时由扫频引擎接管，FM时叠加频偏)
+  always @(posedge CLK_BASE) begin
+    FREQ_WORD_B <= (SWEEP_B_EN ? SWEEP_WORD : {FREQBH_W, FREQBL_W}) + FM_DELTA_B;
+  end
+
+  // 通道B 抖动量
   always @(posedge CLK_BASE) begin
-    FREQ_WORD_B <= {FREQBH_W, FREQBL_W};
+    LFSR_B   <= lfsr_step16(LFSR_B);
+    DITHER_B <= DITHER_EN ? FREQ_WORD_B[31:16] * LFSR_B[15:0] : 32'd0;
   end
 
   // 通道B 相位累加器 和 相位接近检测逻辑
@@ -98,7 +204,7 @@ module DA_PARAMETER_CTRL #(
       // 将标志寄存一拍，用于下游逻辑同步
       flag_reg <= flag;
     end
-    FREQ_OUT_B <= ACC_B[31];
+    FREQ_OUT_B <= ACC_B_DITH[31];
   end
 
   // NCO最终输出信号
@@ -127,7 +233,8 @@ module DA_PARAMETER_CTRL #(
     end
     // 最终输出逻辑: 当检测到相位接近时，切换到交叉耦合的调整值COUT_A，否则使用本地计数值CNT_A
     // 注意: 此处使用了阻塞赋值(=)，在时序逻辑中非标准，但意图可能是生成一个MUX+FF
-    COUT_A_FINAL = (flag_reg == 1'b1) ? COUT_A : CNT_A;
+    // PM时叠加调制器输出的相位偏移
+    COUT_A_FINAL = ((flag_reg == 1'b1) ? COUT_A : CNT_A) + PM_OFS_A;
   end
 
   // --- 通道 B 计数器 ---
@@ -144,7 +251,7 @@ module DA_PARAMETER_CTRL #(
       CNT_B <= CNT_B + 1;  // 计数器自由加1
     end
     // 最终输出逻辑: 当检测到相位接近时，切换到交叉耦合的调整值COUT_B，否则使用本地计数值CNT_B
-    COUT_B_FINAL <= (flag_reg == 1'b1) ? COUT_B : CNT_B;
+    COUT_B_FINAL <= ((flag_reg == 1'b1) ? COUT_B : CNT_B) + PM_OFS_B;
   end
 
   //==================================================================================
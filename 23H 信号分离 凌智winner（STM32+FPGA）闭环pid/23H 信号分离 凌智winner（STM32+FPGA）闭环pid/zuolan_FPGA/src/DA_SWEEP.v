@@ -0,0 +1,192 @@
+//&----------------------------------------------------------------------------------------
+//& 模块名: DA_SWEEP
+//& 文件名: DA_SWEEP.v
+//& 作  者: 左岚
+//& 日  期: 2025-07-18
+//&
+//& 功  能: 硬件线性扫频引擎。按 起始/终止/步进 频率控制字自动步进DDS频率，
+//&         每个频点驻留 DWELL 个时钟周期后进入下一频点。
+//&         同步采集(LOCKSTEP)模式下，每个频点驻留结束后输出采集使能 SWEEP_CAP，
+//&         待两路AD FIFO写满后置位就绪标志并暂停，MCU读完FIFO后写ACK继续。
+//&         由 DA_PARAMETER_CTRL 实例化，输出的频率字覆盖对应通道的NCO频率字。
+//&
+//& 寄存器映射 (BASE 为参数, 只写):
+//&   BASE+0/1 : 起始频率字 高/低16位
+//&   BASE+2/3 : 终止频率字 高/低16位
+//&   BASE+4/5 : 步进频率字 高/低16位
+//&   BASE+6/7 : 每个频点的驻留时钟数 高/低16位 (CLK周期)
+//&   BASE+8   : 控制字 (每次写操作结束时执行一次)
+//&              [0] RUN      1=启动扫频, 0=停止扫频
+//&              [1] CH_A     扫频作用于A通道
+//&              [2] CH_B     扫频作用于B通道
+//&              [3] LOCKSTEP 每个频点触发一次AD采集并等待ACK
+//&              [4] ACK      MCU已读完本频点数据，进入下一频点
+//&              [5] REPEAT   扫到终止频率后从起始频率重新开始
+//&
+//& 状态字 STATUS (经FMC读地址14读出):
+//&   [15] BUSY  [14] READY(本频点数据已采满)  [13] DONE  [12:0] 当前频点序号
+//&----------------------------------------------------------------------------------------
+
+module DA_SWEEP #(
+    parameter BASE = 16'h0040  // 寄存器组起始地址
+) (
+    // --- 端口定义 ---
+    input             CLK,         // 系统主时钟 (CLK_BASE)
+    // -- 总线写控制
+    input             CS,          // 片选信号，低电平有效
+    input             WR_EN,       // 写使能信号，高电平有效
+    input      [15:0] ADDR,        // 16位地址总线
+    input      [15:0] DATA,        // 16位数据总线
+    // -- AD FIFO 满标志 (来自AD写时钟域)
+    input             AD1_FULL,
+    input             AD2_FULL,
+    // -- 输出
+    output            SWEEP_A_EN,  // A通道频率字由扫频引擎接管
+    output            SWEEP_B_EN,  // B通道频率字由扫频引擎接管
+    output reg [31:0] SWEEP_WORD,  // 当前扫频频率字
+    output reg        SWEEP_CAP = 1'b0,  // AD FIFO 采集使能
+    output     [15:0] STATUS       // 状态字
+);
+
+  //==================================================================================
+  //== 寄存器组
+  //==================================================================================
+  reg [31:0] START_WORD = 32'd0;
+  reg [31:0] STOP_WORD = 32'd0;
+  reg [31:0] STEP_WORD = 32'd0;
+  reg [31:0] DWELL = 32'd0;
+  reg [ 5:0] SWEEP_CTRL = 6'd0;
+
+  wire       wr_hit = !CS && WR_EN && (ADDR[15:4] == BASE[15:4]);
+
+  always @(posedge CLK) begin
+    if (wr_hit) begin
+      case (ADDR[3:0])
+        4'h0: START_WORD[31:16] <= DATA;
+        4'h1: START_WORD[15:0] <= DATA;
+        4'h2: STOP_WORD[31:16] <= DATA;
+        4'h3: STOP_WORD[15:0] <= DATA;
+        4'h4: STEP_WORD[31:16] <= DATA;
+        4'h5: STEP_WORD[15:0] <= DATA;
+        4'h6: DWELL[31:16] <= DATA;
+        4'h7: DWELL[15:0] <= DATA;
+        4'h8: SWEEP_CTRL <= DATA[5:0];
+        default: ;
+      endcase
+    end
+  end
+
+  // 一次总线写操作会持续多个CLK周期，在写结束时产生单周期命令脉冲
+  reg  ctrl_wr_d;
+  reg  ctrl_wr_dd;
+  always @(posedge CLK) begin
+    ctrl_wr_d  <= wr_hit && (ADDR[3:0] == 4'h8);
+    ctrl_wr_dd <= ctrl_wr_d;
+  end
+  wire ctrl_cmd = ctrl_wr_dd && !ctrl_wr_d;
+  wire cmd_run = ctrl_cmd && SWEEP_CTRL[0];
+  wire cmd_stop = ctrl_cmd && !SWEEP_CTRL[0];
+  wire cmd_ack = ctrl_cmd && SWEEP_CTRL[4];
+
+  // FIFO满标志同步到本时钟域
+  reg [1:0] full1_sync;
+  reg [1:0] full2_sync;
+  always @(posedge CLK) begin
+    full1_sync <= {full1_sync[0], AD1_FULL};
+    full2_sync <= {full2_sync[0], AD2_FULL};
+  end
+
+  //==================================================================================
+  //== 扫频状态机
+  //==================================================================================
+  localparam S_IDLE = 3'd0;  // 空闲
+  localparam S_DWELL = 3'd1;  // 频点驻留 (等待输出稳定)
+  localparam S_CAPTURE = 3'd2;  // 等待AD FIFO写满
+  localparam S_WAIT = 3'd3;  // 等待MCU应答
+  localparam S_NEXT = 3'd4;  // 计算下一频点
+
+  reg [ 2:0] state = S_IDLE;
+  reg [31:0] dwell_cnt;
+  reg [12:0] step_idx;
+  reg        done = 1'b0;
+  reg        ready = 1'b0;
+
+  wire [32:0] next_word = {1'b0, SWEEP_WORD} + {1'b0, STEP_WORD};
+
+  always @(posedge CLK) begin
+    if (cmd_stop) begin
+      state     <= S_IDLE;
+      SWEEP_CAP <= 1'b0;
+      ready     <= 1'b0;
+    end else begin
+      case (state)
+        S_IDLE: begin
+          SWEEP_CAP <= 1'b0;
+          ready     <= 1'b0;
+          if (cmd_run) begin
+            SWEEP_WORD <= START_WORD;
+            step_idx   <= 13'd0;
+            dwell_cnt  <= 32'd0;
+            done       <= 1'b0;
+            state      <= S_DWELL;
+          end
+        end
+
+        S_DWELL: begin
+          if (dwell_cnt >= DWELL) begin
+            dwell_cnt <= 32'd0;
+            if (SWEEP_CTRL[3]) begin
+              SWEEP_CAP <= 1'b1;
+              state     <= S_CAPTURE;
+            end else begin
+              state <= S_NEXT;
+            end
+          end else begin
+            dwell_cnt <= dwell_cnt + 1'b1;
+          end
+        end
+
+        S_CAPTURE: begin
+          if (full1_sync[1] && full2_sync[1]) begin
+            SWEEP_CAP <= 1'b0;
+            ready     <= 1'b1;
+            state     <= S_WAIT;
+          end
+        end
+
+        S_WAIT: begin
+          if (cmd_ack) begin
+            ready <= 1'b0;
+            state <= S_NEXT;
+          end
+        end
+
+        S_NEXT: begin
+          if (next_word > {1'b0, STOP_WORD} || STEP_WORD == 32'd0) begin
+            if (SWEEP_CTRL[5]) begin
+              SWEEP_WORD <= START_WORD;
+              step_idx   <= 13'd0;
+              state      <= S_DWELL;
+            end else begin
+              done  <= 1'b1;
+              state <= S_IDLE;
+            end
+          end else begin
+            SWEEP_WORD <= next_word[31:0];
+            step_idx   <= step_idx + 1'b1;
+            state      <= S_DWELL;
+          end
+        end
+
+        default: state <= S_IDLE;
+      endcase
+    end
+  end
+
+  wire busy = (state != S_IDLE);
+
+  assign SWEEP_A_EN = busy && SWEEP_CTRL[1];
+  assign SWEEP_B_EN = busy && SWEEP_CTRL[2];
+  assign STATUS     = {busy, ready, done, step_idx};
+
+endmodule
@@ -4,9 +4,19 @@
 //& 作  者: 左岚
 //& 日  期: 2025-07-18
 //&
-//& 功  能: DA波形发生器模块 (A通道)。此模块根据一个可配置的控制字，从四个
-//&         不同的波形ROM（只读存储器）中选择并输出一种波形数据。
-//&         支持的波形包括：正弦波、方波、三角波和锯齿波。
+//& 功  能: DA波形发生器模块 (A通道)。此模块根据一个可配置的控制字选择并输出
+//&         一种波形数据。支持的波形包括：正弦波、方波、三角波和锯齿波。
+//&
+//& 存储优化:
+//& - 正弦波只存储1/4周期 (256点 x 13位)，其余三个象限由对称性还原。
+//& - 方波、三角波、锯齿波直接由相位算术生成，不再占用ROM。
+//& - 1/4波正弦ROM为双口、双时钟ROM，由A、B两通道共享：A口由本模块使用，
+//&   B口通过 CLK_B / qaddr_b / qmag_b 引出给 DA_WAVEFORM_B。
+//&   两个通道合计仅占用1块M9K (原方案为8张1024x14的ROM，共16块M9K)。
+//&
+//& 多音模式:
+//& - 波形选择码为4时输出 DA_MULTITONE 合成的谐波叠加波形，寄存器组起始地址
+//&   为参数 MT_BASE (A通道默认0x0020)，详见 DA_MULTITONE.v。
 //&
 //& 设计警告:
 //& 本模块中用于写入波形选择控制字`WAVEFORM_A`的 `always @(*)` 块
@@ -15,28 +25,43 @@
 //&----------------------------------------------------------------------------------------
 
 module DA_WAVEFORM_A #(
-    parameter ADDR12 = 16'h000C  // 波形选择控制字的写入地址
+    parameter ADDR12  = 16'h000C,  // 波形选择控制字的写入地址
+    parameter MT_BASE = 16'h0020   // 多音模式寄存器组起始地址
 ) (
     // --- 端口定义 ---
     input         CLK,       // 系统主时钟
     input  [15:0] WAVEFORM,  // 从总线输入的16位数据，其中包含波形选择码
-    input  [ 9:0] addr_a,    // 10位的ROM地址输入，通常代表波形的相位
+    input  [ 9:0] addr_a,    // 10位的相位输入 (一个周期1024点)
     // -- 总线写控制
     input         CS,        // 片选信号，低电平有效
     input         WR_EN,     // 写使能信号，高电平有效
     input  [15:0] ADDR,      // 16位地址总线
+    input         CLK_BUS,   // 总线时钟 (CLKBASE)，用于多音寄存器写入
+    input  [15:0] DATA,      // 16位原始数据总线 (FPGA_DB)
+    // -- 共享正弦ROM的B口 (供B通道使用)
+    input         CLK_B,     // B通道时钟
+    input  [ 7:0] qaddr_b,   // B通道1/4波ROM地址
+    output [12:0] qmag_b,    // B通道1/4波ROM数据
     // -- 输出
     output [13:0] POW_A      // 最终的14位波形数据输出
 );
 
   // --- 内部信号定义 ---
-  wire [13:0] sin_data;  // 来自正弦波ROM的数据
-  wire [13:0] tri_data;  // 来自三角波ROM的数据
-  wire [13:0] squ_data;  // 来自方波ROM的数据
-  wire [13:0] swt_data;  // 来自锯齿波ROM的数据
+  wire [13:0] sin_data;  // 由1/4波ROM还原的正弦波数据
+  wire [13:0] tri_data;  // 算术生成的三角波数据
+  wire [13:0] squ_data;  // 算术生成的方波数据
+  wire [13:0] swt_data;  // 算术生成的锯齿波数据
+  wire [13:0] mt_data;  // 多音合成数据
+
+  wire [ 7:0] qaddr_a;  // A通道1/4波ROM地址
+  wire [12:0] qmag_a;  // A通道1/4波ROM数据 (正弦幅值的绝对值)
+  wire [ 8:0] tri_idx;  // 三角波的折叠相位
+
+  // 相位延迟一拍，与ROM的地址寄存器对齐
+  reg  [ 9:0] addr_a_d;
 
   // 波形选择控制寄存器 (会综合成锁存器)
-  // 0: 正弦波, 1: 方波, 2: 三角波, 3: 锯齿波
+  // 0: 正弦波, 1: 方波, 2: 三角波, 3: 锯齿波, 4: 多音合成
   reg  [ 7:0] WAVEFORM_A;
 
   // 两级流水线寄存器，用于缓冲输出数据，改善时序
@@ -52,35 +77,46 @@ module DA_WAVEFORM_A #(
     end
   end
 
-  // --- 波形ROM实例化 ---
-  // 每个ROM根据相同的地址(相位)输入，输出对应波形的采样点值
+  // --- 1/4波正弦ROM (A/B通道共享) ---
+  // 第2、4象限 (addr[8]=1) 地址取反，实现镜像
+  assign qaddr_a = addr_a[8] ? ~addr_a[7:0] : addr_a[7:0];
 
-  // 正弦波ROM  Sine wave ROM
-  sinromvpp sinromvpp_inst (
-      .address(addr_a),
-      .clock  (CLK),
-      .q      (sin_data)
+  sin_qrom sin_qrom_inst (
+      .address_a(qaddr_a),
+      .address_b(qaddr_b),
+      .clock_a  (CLK),
+      .clock_b  (CLK_B),
+      .q_a      (qmag_a),
+      .q_b      (qmag_b)
   );
 
-  // 方波ROM Square wave ROM
-  sqaure_rom sqaure_rom_inst (
-      .address(addr_a),
-      .clock  (CLK),
-      .q      (squ_data)
-  );
+  always @(posedge CLK) begin
+    addr_a_d <= addr_a;
+  end
 
-  // 三角波ROM Triangle wave ROM
-  triangle_rom triangle_rom_inst (
-      .address(addr_a),
-      .clock  (CLK),
-      .q      (tri_data)
-  );
+  // --- 波形还原 ---
+  // 正弦波: 前半周期 8192+|sin|，后半周期 8191-|sin|，范围0~16383
+  assign sin_data = addr_a_d[9] ? (14'd8191 - {1'b0, qmag_a}) : (14'd8192 + {1'b0, qmag_a});
+  // 方波: 前半周期输出满幅，后半周期输出0
+  assign squ_data = addr_a_d[9] ? 14'd0 : 14'd16383;
+  // 三角波: 前半周期上升，后半周期下降 (低位补高位，使端点达到0和16383)
+  assign tri_idx  = addr_a_d[9] ? ~addr_a_d[8:0] : addr_a_d[8:0];
+  assign tri_data = {tri_idx, tri_idx[8:4]};
+  // 锯齿波: 相位线性映射到0~16383
+  assign swt_data = {addr_a_d, addr_a_d[9:6]};
 
-  // 锯齿波ROM Sawtooth wave ROM
-  sawtooth_rom sawtooth_rom_inst (
-      .address(addr_a),
-      .clock  (CLK),
-      .q      (swt_data)
+  // --- 多音合成 ---
+  DA_MULTITONE #(
+      .BASE(MT_BASE)
+  ) u_multitone (
+      .CLK    (CLK),
+      .PHASE  (addr_a),
+      .CLK_BUS(CLK_BUS),
+      .CS     (CS),
+      .WR_EN  (WR_EN),
+      .ADDR   (ADDR),
+      .DATA   (DATA),
+      .WAVE   (mt_data)
   );
 
   // --- 波形选择和流水线寄存器逻辑 ---
@@ -104,6 +140,10 @@ module DA_WAVEFORM_A #(
         WAVE_DATA_A     <= swt_data;
         WAVE_DATA_A_reg <= WAVE_DATA_A;
       end
+      8'd4: begin  // 选择多音合成
+        WAVE_DATA_A     <= mt_data;
+        WAVE_DATA_A_reg <= WAVE_DATA_A;
+      end
       default: begin  // 默认选择正弦波
         WAVE_DATA_A     <= sin_data;
         WAVE_DATA_A_reg <= WAVE_DATA_A;
@@ -6,7 +6,15 @@
 //&
 //& 功  能: DA波形发生器模块 (B通道)。此模块功能与A通道类似，但它使用写入到
 //&         地址ADDR12的数据总线的**高8位**(`WAVEFORM[15:8]`)作为波形选择码。
-//&         它从四个不同的波形ROM中选择并输出一种波形数据。
+//&
+//& 存储优化:
+//& - 正弦波使用 DA_WAVEFORM_A 中共享1/4波ROM的B口：本模块输出折叠后的
+//&   ROM地址 qaddr，并由 qmag 取回幅值，再按象限还原成完整正弦波。
+//& - 方波、三角波、锯齿波直接由相位算术生成。
+//&
+//& 多音模式:
+//& - 波形选择码为4时输出 DA_MULTITONE 合成的谐波叠加波形，寄存器组起始地址
+//&   为参数 MT_BASE (B通道默认0x0030)，详见 DA_MULTITONE.v。
 //&
 //& 设计警告:
 //& 本模块中用于写入波形选择控制字`WAVEFORM_B`的 `always @(*)` 块
@@ -15,32 +23,41 @@
 //&----------------------------------------------------------------------------------------
 
 module DA_WAVEFORM_B #(
-    parameter ADDR12 = 16'h000C  // 波形选择控制字的写入地址
+    parameter ADDR12  = 16'h000C,  // 波形选择控制字的写入地址
+    parameter MT_BASE = 16'h0030   // 多音模式寄存器组起始地址
 ) (
     // --- 端口定义 ---
     input         CLK,       // 系统主时钟
     input  [15:0] WAVEFORM,  // 从总线输入的16位数据
-    input  [ 9:0] addr_b,    // 10位的ROM地址输入 (B通道相位)
+    input  [ 9:0] addr_b,    // 10位的相位输入 (B通道相位)
     // -- 总线写控制
     input         CS,        // 片选信号，低电平有效
     input         WR_EN,     // 写使能信号，高电平有效
     input  [15:0] ADDR,      // 16位地址总线
+    input         CLK_BUS,   // 总线时钟 (CLKBASE)，用于多音寄存器写入
+    input  [15:0] DATA,      // 16位原始数据总线 (FPGA_DB)
+    // -- 共享正弦ROM (位于DA_WAVEFORM_A中)
+    output [ 7:0] qaddr,     // 1/4波ROM地址
+    input  [12:0] qmag,      // 1/4波ROM数据
     // -- 输出
     output [13:0] POW_B      // B通道的14位波形数据输出
 );
 
-
   // --- 内部信号定义 ---
-  wire [13:0] sin_data;  // 来自正弦波ROM的数据
-  wire [13:0] tri_data;  // 来自三角波ROM的数据
-  wire [13:0] squ_data;  // 来自方波ROM的数据
-  wire [13:0] swt_data;  // 来自锯齿波ROM的数据
+  wire [13:0] sin_data;  // 由1/4波ROM还原的正弦波数据
+  wire [13:0] tri_data;  // 算术生成的三角波数据
+  wire [13:0] squ_data;  // 算术生成的方波数据
+  wire [13:0] swt_data;  // 算术生成的锯齿波数据
+  wire [13:0] mt_data;  // 多音合成数据
+  wire [ 8:0] tri_idx;  // 三角波的折叠相位
+
+  // 相位延迟一拍，与ROM的地址寄存器对齐
+  reg  [ 9:0] addr_b_d;
 
   // 波形选择控制寄存器 (会综合成锁存器)
-  // 0: 正弦波, 1: 方波, 2: 三角波, 3: 锯齿波
   reg  [ 7:0] WAVEFORM_B;
 
-  // 两级流水线寄存器，用于缓冲输出数据，改善时序
+  // 两级流水线寄存器
   reg  [13:0] WAVE_DATA_B;  // 流水线第一级
   reg  [13:0] WAVE_DATA_B_reg;  // 流水线第二级
 
@@ -54,40 +71,35 @@ module DA_WAVEFORM_B #(
     end
   end
 
-  // --- 波形ROM实例化 ---
-  // 每个ROM根据相同的地址(相位)输入，输出对应波形的采样点值
-
-  // 正弦波ROM Sine wave ROM
-  sinromvpp sinromvpp_inst (
-      .address(addr_b),
-      .clock  (CLK),
-      .q      (sin_data)
-  );
+  // --- 共享1/4波正弦ROM的地址折叠 ---
+  assign qaddr = addr_b[8] ? ~addr_b[7:0] : addr_b[7:0];
 
-  // 方波ROM Square wave ROM
-  sqaure_rom sqaure_rom_inst (
-      .address(addr_b),
-      .clock  (CLK),
-      .q      (squ_data)
-  );
+  always @(posedge CLK) begin
+    addr_b_d <= addr_b;
+  end
 
-  // 三角波ROM Triangle wave ROM
-  triangle_rom triangle_rom_inst (
-      .address(addr_b),
-      .clock  (CLK),
-      .q      (tri_data)
-  );
+  // --- 波形还原 (与A通道一致) ---
+  assign sin_data = addr_b_d[9] ? (14'd8191 - {1'b0, qmag}) : (14'd8192 + {1'b0, qmag});
+  assign squ_data = addr_b_d[9] ? 14'd0 : 14'd16383;
+  assign tri_idx  = addr_b_d[9] ? ~addr_b_d[8:0] : addr_b_d[8:0];
+  assign tri_data = {tri_idx, tri_idx[8:4]};
+  assign swt_data = {addr_b_d, addr_b_d[9:6]};
 
-  // 锯齿波ROM Sawtooth wave ROM
-  sawtooth_rom sawtooth_rom_inst (
-      .address(addr_b),
-      .clock  (CLK),
-      .q      (swt_data)
+  // --- 多音合成 ---
+  DA_MULTITONE #(
+      .BASE(MT_BASE)
+  ) u_multitone (
+      .CLK    (CLK),
+      .PHASE  (addr_b),
+      .CLK_BUS(CLK_BUS),
+      .CS     (CS),
+      .WR_EN  (WR_EN),
+      .ADDR   (ADDR),
+      .DATA   (DATA),
+      .WAVE   (mt_data)
   );
 
   // --- 波形选择和流水线寄存器逻辑 ---
-  // 这个时序逻辑块实现了一个多路选择器，根据WAVEFORM_B的值选择一个波形数据
-  // 并通过两级流水线寄存器输出。
   always @(posedge CLK) begin
     case (WAVEFORM_B)
       8'd0: begin  // 选择正弦波
@@ -106,6 +118,10 @@ module DA_WAVEFORM_B #(
         WAVE_DATA_B     <= swt_data;
         WAVE_DATA_B_reg <= WAVE_DATA_B;
       end
+      8'd4: begin  // 选择多音合成
+        WAVE_DATA_B     <= mt_data;
+        WAVE_DATA_B_reg <= WAVE_DATA_B;
+      end
       default: begin  // 默认选择正弦波
         WAVE_DATA_B     <= sin_data;
         WAVE_DATA_B_reg <= WAVE_DATA_B;
@@ -114,7 +130,6 @@ module DA_WAVEFORM_B #(
   end
 
   // --- 最终输出赋值 ---
-  // 将第二级流水线寄存器的值赋给模块输出
   assign POW_B = WAVE_DATA_B_reg;
 
 endmodule
@@ -6,6 +6,8 @@
 //&
 //& 功  能: 主控寄存器模块。该模块实现了一个16位的写操作寄存器，
 //&         用于接收来自总线的主控制字。
+//&         同时生成两路AD FIFO写请求: 控制位4/6 与扫频引擎的采集使能相或，
+//&         扫频同步采集时无需MCU改写控制字。
 //&
 //& 设计警告:
 //& **严重警告 - 锁存器(Latch)推断**:
@@ -27,9 +29,17 @@ module MASTER_CTRL #(
     input             WR_EN,     // 写使能信号，高电平有效
     input      [15:0] ADDR,      // 16位地址总线
     input      [15:0] DATA,      // 16位数据总线
-    output reg [15:0] CTRL_DATA  // 16位控制寄存器的输出 (将作为锁存器实现)
+    input             SWEEP_CAP, // 扫频引擎的AD采集使能
+    output reg [15:0] CTRL_DATA, // 16位控制寄存器的输出 (将作为锁存器实现)
+    output            AD1_WRREQ, // AD1 FIFO 写请求
+    output            AD2_WRREQ  // AD2 FIFO 写请求
 );
 
+  // --- AD FIFO 写请求 ---
+  // 不直接改写CTRL_DATA，避免MCU读-改-写控制字时把扫频采集位写回寄存器
+  assign AD1_WRREQ = CTRL_DATA[4] | SWEEP_CAP;
+  assign AD2_WRREQ = CTRL_DATA[6] | SWEEP_CAP;
+
   // --- 锁存器实现逻辑 ---
   // **警告**: 此 always 块描述了一个锁存器。
   // 当敏感列表中的任何信号(CS, WR_EN, ADDR)发生电平变化时，此块被触发。
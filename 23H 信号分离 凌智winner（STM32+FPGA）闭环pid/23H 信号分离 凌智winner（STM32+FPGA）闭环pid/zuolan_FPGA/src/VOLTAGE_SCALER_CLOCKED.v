@@ -8,6 +8,25 @@
 //&         本模块的功能是接收一个标准的14位波形数据(通常来自ROM)，并根据一个
 //&         可编程的目标峰值电压，对其幅度进行线性缩放。它假设输入波形数据是以
 //&         一个直流偏置(HALF_ROM_MAX)为中心的。
+//&
+//& 噪声整形 (shape_en=1, 主控制字bit12):
+//&         缩放结果需要截断回14位，截断误差与波形同周期，表现为谐波杂散。
+//&         开启后把上一拍的截断误差(16位小数)加到本拍结果上再截断(一阶误差反馈)，
+//&         误差谱被整形为高通(1-z^-1)，低频段杂散被推到奈奎斯特频率附近。
+//&         关闭时按四舍五入截断。
+//&
+//& 调幅:
+//&         am_gain 为调制器输出的Q1.16增益 (65536=1.0)，与峰峰值增益相乘后再
+//&         作用于波形数据。不调幅时保持65536。
+//&
+//& 自动增益控制:
+//&         agc_en 有效时，峰峰值增益改用 DA_AGC 闭环输出的 agc_gain (Q1.16)，
+//&         voltage_mv 不参与计算。调幅增益照常叠加。
+//&
+//& 实现说明:
+//&         缩放比例 voltage_mv/DEFAULT_PEAK_MV 先换算为Q1.16增益并寄存，
+//&         数据通路上只做一次乘法，不再逐点做除法。voltage_mv 为准静态参数，
+//&         增益计算路径可按多周期路径处理。波形数据流水线延迟为2个时钟周期。
 //&----------------------------------------------------------------------------------------
 
 module  VOLTAGE_SCALER_CLOCKED(
@@ -15,6 +34,10 @@ module  VOLTAGE_SCALER_CLOCKED(
     input wire clk,  // 时钟输入
     input wire [13:0] rom_data,  // 14位原始波形数据输入 (范围: 0 - 16383)
     input wire [11:0] voltage_mv, // 12位目标峰值电压（单位:毫伏），例如1550表示1.55V，上限3000mV
+    input wire shape_en,  // 截断噪声整形使能
+    input wire [17:0] am_gain,  // 调幅增益 Q1.16 (65536=不调幅)
+    input wire agc_en,  // 增益由AGC接管
+    input wire [17:0] agc_gain,  // AGC增益 Q1.16
 
     output reg [13:0] scaled_data  // 14位幅度缩放后的波形数据输出
 );
@@ -29,23 +52,40 @@ module  VOLTAGE_SCALER_CLOCKED(
   // 波形的正半轴在 [8191, 16383] 区间，负半轴在 [0, 8191] 区间。
   parameter HALF_ROM_MAX = ROM_MAX / 2;
 
-  // --- 幅度缩放逻辑 ---
-  // 在每个时钟的上升沿，对输入的ROM数据进行缩放并寄存输出
+  // --- 增益计算 (准静态) ---
+  // gain_q16 = voltage_mv / DEFAULT_PEAK_MV * 65536 (四舍五入)
+  reg [17:0] gain_q16 = 18'd0;
+  always @(posedge clk) begin
+    gain_q16 <= ({voltage_mv, 16'd0} + DEFAULT_PEAK_MV / 2) / DEFAULT_PEAK_MV;
+  end
+
+  // --- 调幅: 总增益 = 峰峰值增益(或AGC增益) x 调幅增益 ---
+  wire [17:0] gain_base = agc_en ? agc_gain : gain_q16;
+  wire [35:0] gain_am = gain_base * am_gain;
+  reg  [17:0] gain_total = 18'd0;
+  always @(posedge clk) begin
+    gain_total <= (gain_am[35:16] > 20'h3FFFF) ? 18'h3FFFF : gain_am[33:16];
+  end
+
+  // --- 第1级: 去直流偏置后乘以增益 ---
+  wire signed [14:0] centered = $signed({1'b0, rom_data}) - HALF_ROM_MAX;  // -8191 ~ 8192
+  reg  signed [33:0] product;  // Q.16 格式的缩放结果
+
+  always @(posedge clk) begin
+    product <= centered * $signed({1'b0, gain_total});
+  end
+
+  // --- 第2级: 截断 (四舍五入 或 一阶误差反馈) ---
+  reg         [15:0] trunc_err = 16'd0;  // 上一拍的截断误差 (Q0.16)
+  wire signed [34:0] shaped = product + (shape_en ? $signed({1'b0, trunc_err}) : 17'sd32768);
+  wire signed [18:0] amp = shaped >>> 16;  // 截断后的幅度
+  wire signed [19:0] out_v = amp + HALF_ROM_MAX;  // 加回直流偏置
+
   always @(posedge clk) begin
-    // 判断数据点在波形的正半轴还是负半轴
-    if (rom_data >= HALF_ROM_MAX) begin
-      // --- 处理正半轴 ---
-      // 1. (rom_data - HALF_ROM_MAX): 计算出原始波形距离中心点的正向幅度。
-      // 2. (... * voltage_mv / DEFAULT_PEAK_MV): 根据目标电压与参考电压的比例，对幅度进行缩放。
-      // 3. HALF_ROM_MAX + (...): 将缩放后的幅度重新加到中心值上，得到最终输出值。
-      scaled_data <= HALF_ROM_MAX + (rom_data - HALF_ROM_MAX) * voltage_mv / DEFAULT_PEAK_MV;
-    end else begin
-      // --- 处理负半轴 ---
-      // 1. (HALF_ROM_MAX - rom_data): 计算出原始波形距离中心点的负向幅度。
-      // 2. (... * voltage_mv / DEFAULT_PEAK_MV): 对该幅度进行缩放。
-      // 3. HALF_ROM_MAX - (...): 从中心值减去缩放后的幅度，得到最终输出值。
-      scaled_data <= HALF_ROM_MAX - (HALF_ROM_MAX - rom_data) * voltage_mv / DEFAULT_PEAK_MV;
-    end
+    trunc_err <= shape_en ? shaped[15:0] : 16'd0;
+    if (out_v < 0) scaled_data <= 14'd0;
+    else if (out_v > ROM_MAX) scaled_data <= 14'd16383;
+    else scaled_data <= out_v[13:0];
   end
 
 endmodule
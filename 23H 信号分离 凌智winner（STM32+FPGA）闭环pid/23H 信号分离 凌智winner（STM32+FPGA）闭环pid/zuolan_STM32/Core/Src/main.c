@@ -109,14 +109,16 @@ int main(void)
 	DA_Init();
   DA_Apply_Settings();
 	PID_Init();
+	track_pid_init();
 	fft_init(); // FFT模块初始?
-	//AD9959_Init();
+#if AMP_LOOP_ENABLE
+	AD9959_Init();
+#endif
   my_printf(&huart1,"ok!\r\n"); 
+	scheduler_init(); // 先建立任务表，否则第一次采集完成的事件会丢失
   HAL_ADC_Start(&hadc2);
 	HAL_ADCEx_MultiModeStart_DMA(&hadc1,adc_buffer,1024);
 	HAL_TIM_Base_Start(&htim2);
-  
-	scheduler_init();
   /* USER CODE END 2 */
 
   /* Infinite loop */
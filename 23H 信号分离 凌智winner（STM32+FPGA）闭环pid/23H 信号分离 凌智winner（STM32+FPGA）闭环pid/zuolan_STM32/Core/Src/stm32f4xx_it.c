@@ -22,6 +22,7 @@
 #include "stm32f4xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "scheduler.h"
 
 /* USER CODE END Includes */
 
@@ -175,7 +176,7 @@ void DebugMon_Handler(void)
 void PendSV_Handler(void)
 {
   /* USER CODE BEGIN PendSV_IRQn 0 */
-
+  scheduler_pendsv();
   /* USER CODE END PendSV_IRQn 0 */
   /* USER CODE BEGIN PendSV_IRQn 1 */
 
@@ -192,6 +193,7 @@ void SysTick_Handler(void)
   /* USER CODE END SysTick_IRQn 0 */
   HAL_IncTick();
   /* USER CODE BEGIN SysTick_IRQn 1 */
+  scheduler_tick();
 
   /* USER CODE END SysTick_IRQn 1 */
 }
@@ -251,11 +253,16 @@ void USART3_IRQHandler(void)
 void DMA2_Stream0_IRQHandler(void)
 {
   /* USER CODE BEGIN DMA2_Stream0_IRQn 0 */
-
+  /* 半传输中断时缓冲区后半段尚未写入，只在传输完成时通知；标志由 HAL_DMA_IRQHandler 清除，需先读取 */
+  uint8_t transfer_complete = (__HAL_DMA_GET_FLAG(&hdma_adc1, __HAL_DMA_GET_TC_FLAG_INDEX(&hdma_adc1)) != RESET);
   /* USER CODE END DMA2_Stream0_IRQn 0 */
   HAL_DMA_IRQHandler(&hdma_adc1);
   /* USER CODE BEGIN DMA2_Stream0_IRQn 1 */
-  adc_flag=1;
+  if(transfer_complete)
+  {
+    adc_flag=1;
+    scheduler_signal(SCHED_EVENT_ADC_DONE);
+  }
   /* USER CODE END DMA2_Stream0_IRQn 1 */
 }
 
@@ -1,66 +1,142 @@
 #include "app_pid.h"
+#include "param_store.h"
 
-PID_TypeDef PID;             // PIDʵ
+pid_ctrl_t PID;             // PIDʵ
+static pid_autotune_t amp_tune;             // Ȼ
+static volatile uint8_t amp_tune_request = 0; // 󣬿жλ
+
+/* Pid_Proc() ڵУڴӡFlashд·¼ɺ̨ PID_Report_Proc()  */
+#define AMP_REPORT_TUNE_START (1U << 0)     // ʼ
+#define AMP_REPORT_TUNE_FAIL  (1U << 1)     // ʧ
+#define AMP_REPORT_TUNE_DONE  (1U << 2)     // ɣ amp_tune_gains
+#define AMP_REPORT_TUNE_REJECT (1U << 3)    // ȻδУ󱻾ܾ
+static volatile uint32_t amp_report = 0;
+static volatile uint8_t amp_parked = 0;     // 1=̨ڲдFlash·ͣ
+static param_gains_t amp_tune_gains;        // һĽ
 
 void PID_Init(void)
 {
-    // ʼPID
-    PID.SetPoint = 3.0f;    // Ŀѹ 30V
-    PID.ActualValue = 0.0f;
-    PID.SumError = 0.0f;
-    PID.Proportion = KP;
-    PID.Integral = KI;
-    PID.Derivative = KD;
-    PID.Error = 0.0f;
-    PID.LastError = 0.0f;
-    PID.PrevError = 0.0f;
-
+    // ʼPID޷ڿڲʽ޷Ϊ׼ۼӣֱ
+    if(PID_FORM == PID_FORM_INCREMENTAL)
+        pid_init(&PID, PID_FORM_INCREMENTAL, INCR_KP, INCR_KI, INCR_KD);
+    else
+        pid_init(&PID, PID_FORM_POSITIONAL, LOCT_KP, LOCT_KI, LOCT_KD);
+    PID.out_min = PID_OUT_MIN;
+    PID.out_max = PID_OUT_MAX;
+    PID.kt = 0.5f;          // λʽ㿹
+    pid_reset(&PID, PID_OUT_MIN);
+
+    // ʹѱ
+    param_gains_t gains;
+    if(param_store_load(PARAM_LOOP_AMPLITUDE, &gains))
+    {
+        PID.kp = gains.kp;
+        PID.ki = gains.ki;
+        PID.kd = gains.kd;
+        my_printf(&huart1, "Ȼʹñ: Kp=%.4f Ki=%.4f Kd=%.4f\r\n", gains.kp, gains.ki, gains.kd);
+    }
 }
 
 /**
- * @brief       pidջ
- * @param       *PIDPIDṹַ
- * @param       Feedback_valueǰʵֵ
- * @retval      ֵ
+ * @brief       Ȼһ Pid_Proc() ʼ̵ʵ
+ * @details     AMP_LOOP_ENABLE Ϊ0ʱ Pid_Proc() ȣ󱻾ܾں̨
  */
-//ʽ PID ǵԼֵ ActualValue ʱ㣬һλʽ PID ǲһ
-int32_t increment_pid_ctrl(PID_TypeDef *PID, float Feedback_value)
+void PID_Autotune_Start(void)
 {
-    PID->Error = (float)(PID->SetPoint - Feedback_value); /* ƫ */
-
-#if INCR_LOCT_SELECT /* ʽPID */
-
-    PID->ActualValue += (PID->Proportion * (PID->Error - PID->LastError)) /*  */
-                        + (PID->Integral * PID->Error) /* ֻ */
-                        + (PID->Derivative * (PID->Error - 2 * PID->LastError + PID->PrevError)); /* ΢ֻ */
-
-    PID->PrevError = PID->LastError; /* 洢ƫ´μ */
-    PID->LastError = PID->Error;
-
-#else /* λʽPID */
+#if AMP_LOOP_ENABLE
+    amp_tune_request = 1;
+#else
+    amp_report |= AMP_REPORT_TUNE_REJECT;
+#endif
+}
 
-    PID->SumError += PID->Error;
-    PID->ActualValue = (PID->Proportion * PID->Error) /*  */
-                       + (PID->Integral * PID->SumError) /* ֻ */
-                       + (PID->Derivative * (PID->Error - PID->LastError)); /* ΢ֻ */
-    PID->LastError = PID->Error;
+/**
+ * @brief       ̵ʵ㲢Ӧ棬ͱɺ̨
+ */
+static void PID_Autotune_Finish(void)
+{
+    param_gains_t gains;
+
+    pid_reset(&PID, amp_tune.bias); // Ӽ̵ֵлPID
+    if(!pid_autotune_gains(&amp_tune, AMP_TUNE_RULE, &gains.kp, &gains.ki, &gains.kd))
+    {
+        amp_report |= AMP_REPORT_TUNE_FAIL;
+        return;
+    }
+
+    PID.kp = gains.kp;
+    PID.ki = gains.ki;
+    PID.kd = gains.kd;
+    amp_tune_gains = gains;
+    amp_report |= AMP_REPORT_TUNE_DONE;
+}
 
+/**
+ * @brief       ̨񣺴ӡȻ¼
+ * @details     FlashڼCPUͣԼ1~2룬ͣ· ()ӵǰŻָ
+ */
+void PID_Report_Proc(void)
+{
+    uint32_t events;
+
+    __disable_irq();
+    events = amp_report;
+    amp_report = 0;
+    __enable_irq();
+
+    if(events & AMP_REPORT_TUNE_REJECT)
+        my_printf(&huart1, "Ȼδ (AMP_LOOP_ENABLE=0)\r\n");
+    if(events & AMP_REPORT_TUNE_START)
+        my_printf(&huart1, "Ȼʼ\r\n");
+    if(events & AMP_REPORT_TUNE_FAIL)
+        my_printf(&huart1, "Ȼʧܣԭ\r\n");
+    if(events & AMP_REPORT_TUNE_DONE)
+    {
+        param_gains_t gains = amp_tune_gains;
+        my_printf(&huart1, "Ȼ: Ku=%.4f Tu=%.1f -> Kp=%.4f Ki=%.4f Kd=%.4f\r\n",
+                  amp_tune.ku, amp_tune.tu, gains.kp, gains.ki, gains.kd);
+#if PID_TUNE_SAVE
+        uint8_t ok;
+        amp_parked = 1;
+        ok = param_store_save(PARAM_LOOP_AMPLITUDE, &gains);
+        pid_reset(&PID, PID.output);
+        amp_parked = 0;
+        my_printf(&huart1, ok ? "ѱ\r\n" : "汣ʧ\r\n");
 #endif
-    return ((int32_t)(PID->ActualValue)); /* ؼֵ */
+    }
 }
 
 int32_t output=38;
 float vin;
+static amp_sample_t pid_amp;                // Ƽʹõ·ֵ
 void Pid_Proc(void)
 {
-
-
-    vin=vol_amp2/2*10;
-    output = increment_pid_ctrl(&PID,vin);
-    if(output>1023)
-			output=1023;
-		else if(output<38)
-			output=38;
+    // ̨дFlashڼ䱣
+    if(amp_parked)
+        return;
+
+    // ˮȡµķֵûʱһ
+    SPSC_POP(amp_queue, pid_amp);
+    vin=pid_amp.amp2/2*10;
+    if(amp_tune_request)
+    {
+        amp_tune_request = 0;
+        // ̵ԵǰΪģ඼Χ
+        float bias = fmaxf(fminf(PID.output, PID_OUT_MAX - AMP_TUNE_AMPLITUDE), PID_OUT_MIN + AMP_TUNE_AMPLITUDE);
+        pid_autotune_start(&amp_tune, PID_SETPOINT, bias, AMP_TUNE_AMPLITUDE, AMP_TUNE_HYSTERESIS);
+        amp_report |= AMP_REPORT_TUNE_START;
+    }
+
+    if(amp_tune.state == AUTOTUNE_RUNNING)
+    {
+        output = (int32_t)pid_autotune_update(&amp_tune, vin);
+        if(amp_tune.state != AUTOTUNE_RUNNING)
+            PID_Autotune_Finish();
+    }
+    else
+    {
+        output = (int32_t)pid_update(&PID, PID_SETPOINT, vin, 0.0f);
+    }
     pid_vin=output;
 }
 
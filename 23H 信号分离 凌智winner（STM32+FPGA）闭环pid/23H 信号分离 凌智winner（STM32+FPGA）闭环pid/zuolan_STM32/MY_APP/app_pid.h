@@ -2,38 +2,40 @@
 #define APP_APP_PID_H_
 
 #include "bsp_system.h"
+#include "pid_controller.h"
+#include "pid_autotune.h"
+
+/* Ȼأ1=ʼAD9959 Pid_Proc/AD9959_proc0=зȻܾ */
+#define AMP_LOOP_ENABLE 0
 
 /* PIDز */
-#define INCR_LOCT_SELECT 1          /* 0λʽ 1ʽ */
-#if INCR_LOCT_SELECT
+#define PID_FORM PID_FORM_INCREMENTAL   /* PID_FORM_POSITIONALλʽ PID_FORM_INCREMENTALʽ */
 /* ʽPIDغ */
-#define KP 0.8f                /* P*/
-#define KI 0.7f                /* I*/
-#define KD 0.20f                /* D*/
-#define SMAPLSE_PID_SPEED 1    /*  λms*/
-#else
+#define INCR_KP 0.8f                /* P*/
+#define INCR_KI 0.7f                /* I*/
+#define INCR_KD 0.20f               /* D*/
+#define INCR_SAMPLE_MS 1            /*  λms*/
 /* λʽPIDغ */
-#define KP 10.0f                /* P*/
-#define KI 0.5f                 /* I*/
-#define KD 6.00f                /* D*/
-#define SMAPLSE_PID_SPEED 10    /*  λms*/
-#endif
-/* PIDṹ */
-typedef struct
-{
-    __IO float SetPoint;            /* 趨Ŀ */
-    __IO float ActualValue;         /* ֵ */
-    __IO float SumError;            /* ۼ */
-    __IO float Proportion;          /*  P */
-    __IO float Integral;            /* ֳ I */
-    __IO float Derivative;          /* ΢ֳ D */
-    __IO float Error;               /* Error[1] */
-    __IO float LastError;           /* Error[-1] */
-    __IO float PrevError;           /* Error[-2] */
-} PID_TypeDef;
+#define LOCT_KP 10.0f               /* P*/
+#define LOCT_KI 0.5f                /* I*/
+#define LOCT_KD 6.00f               /* D*/
+#define LOCT_SAMPLE_MS 10           /*  λms*/
+
+#define PID_SETPOINT 3.0f           /* Ŀѹ 30V */
+#define PID_OUT_MIN 38              /*  */
+#define PID_OUT_MAX 1023            /*  */
+
+/* ز */
+#define AMP_TUNE_AMPLITUDE 100.0f   /* ̵ */
+#define AMP_TUNE_HYSTERESIS 0.05f   /* زӦvin */
+#define AMP_TUNE_RULE AUTOTUNE_RULE_NO_OVERSHOOT  /*  */
+#define PID_TUNE_SAVE 1             /* 1浽FlashϵʱԶȡ */
 
+extern pid_ctrl_t PID;              /* PIDʵ */
 
 void Pid_Proc(void);
 void PID_Init(void);
+void PID_Autotune_Start(void);
+void PID_Report_Proc(void);
 
 #endif /* APP_APP_PID_H_ */
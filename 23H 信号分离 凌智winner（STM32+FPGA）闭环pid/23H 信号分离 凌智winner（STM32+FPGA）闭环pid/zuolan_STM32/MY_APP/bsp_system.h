@@ -50,12 +50,14 @@
 #include "string.h"
 #include "my_usart_pack.h"
 #include "da_output.h"
+#include "da_sweep.h"
 #include "phase_measure.h"
 #include "AD9959.h"
 #include "my_filter.h"
 #include "arm_math.h"
 #include "commond_init.h"
 #include "app_pid.h"
+#include "pipeline.h"
 #include "key_app.h"
 #include "da_output.h"
 #include "kalman.h"
@@ -70,4 +72,12 @@ extern int32_t output;
 extern u32 pid_vin;
 extern float detected_freq;
 extern u16 fifo_data1[FIFO_SIZE], fifo_data2[FIFO_SIZE];       // 
+
+// DMAʵĻ .dma_buffer Σɷɢļ zuolan_STM32.sct ̶SRAM1ʼ
+// Ӵʱ .ANY ܰ䵽CCM (0x10000000)DMA޷CCM
+#if defined(__CC_ARM)
+#define DMA_BUFFER __attribute__((section(".dma_buffer"), zero_init))
+#else
+#define DMA_BUFFER __attribute__((section(".dma_buffer")))
+#endif
 #endif
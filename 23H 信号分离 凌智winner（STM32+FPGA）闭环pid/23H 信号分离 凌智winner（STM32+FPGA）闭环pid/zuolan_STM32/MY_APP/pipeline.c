@@ -0,0 +1,14 @@
+#include "pipeline.h"
+#include "bsp_system.h"
+
+SPSC_QUEUE_DEFINE(ad_frame_queue, ad_frame_t, 3, SPSC_LATEST_VALUE);
+SPSC_QUEUE_DEFINE(amp_queue, amp_sample_t, 3, SPSC_LATEST_VALUE);
+
+/* ͨڴӡеĻѹͶ (ֵΪ)  */
+void pipeline_report(void)
+{
+    my_printf(&huart1, " ad_frame: δ%lu %lu\r\n",
+              (unsigned long)spsc_count(&ad_frame_queue), (unsigned long)ad_frame_queue.dropped);
+    my_printf(&huart1, " amp: δ%lu %lu\r\n",
+              (unsigned long)spsc_count(&amp_queue), (unsigned long)amp_queue.dropped);
+}
@@ -0,0 +1,41 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "commond_init.h"
+#include "spsc_queue.h"
+
+/*
+ * ʴˮߣɵԵʺȼ ( scheduler.c )
+ * ֻͨ/߶дݣֱӶдԷȫֻ
+ * ٵķٵĲɼͿƣɼҲڷ;идõݡ
+ *
+ *   ɼ ad_proc (1msȼ)
+ *     |-- ad_frame_queue (ֵ) -->  key_proc 2/4 (裬̨)
+ *     `-- amp_queue      (ֵ) -->  Pid_Proc (1msȼAMP_LOOP_ENABLE Ϊ1ʱŵ)
+ *
+ * ÿݴʱ̣߿ɾݴжʱЧ
+ * ɨƵ (0x0C) FPGA֣ͣ ad_proc ֱӶFIFO
+ * ˮߣԭ da_sweep.h
+ */
+
+/* ɼ -> һ֡AD1 */
+typedef struct
+{
+    float samples[FIFO_SIZE]; /* AD1 (V) */
+    uint32_t tick;            /* ɼʱ (ms) */
+} ad_frame_t;
+
+/* ɼ -> Ƽ·ֵ */
+typedef struct
+{
+    float amp1;               /* AD1ֵ (V) */
+    float amp2;               /* AD2ֵ (V) */
+    uint32_t tick;            /* ɼʱ (ms) */
+} amp_sample_t;
+
+extern spsc_queue_t ad_frame_queue;
+extern spsc_queue_t amp_queue;
+
+void pipeline_report(void);
+
+#endif
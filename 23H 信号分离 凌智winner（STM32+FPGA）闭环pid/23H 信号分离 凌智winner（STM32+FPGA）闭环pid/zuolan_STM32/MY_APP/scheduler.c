@@ -1,13 +1,49 @@
 #include "scheduler.h"
 
+#define SCHED_SWI_HIGH_IRQn SPI6_IRQn /* δʹõжȼж */
+#define SCHED_SWI_MID_IRQn SAI1_IRQn  /* δʹõжȼж */
+#define SCHED_PRIO_HIGH 4
+#define SCHED_PRIO_MID 8
+#define SCHED_PRIO_LOW 14
+#define SCHED_STACK_SIZE 0x2000       /* ջСļе Stack_Size һ */
+#define SCHED_ISR_STACK 512           /* жϺSysTickǶջ */
+#define SCHED_HIST_BINS 8             /* ִʱֱͼ */
+#define SCHED_TASK(func) func, #func  /*  */
+
+/* ִʱֱͼϽ (us)һΪȫ */
+static const uint32_t sched_hist_edges[SCHED_HIST_BINS - 1] = {10, 50, 100, 250, 500, 1000, 2000};
 
 uint8_t task_num;
+static volatile uint8_t report_request = 0; /* ͳƴӡ󣬿жλ */
 typedef struct {
-    void (*task_func)(void);  
-    uint32_t rate_ms;         
-    uint32_t last_run;      
+    void (*task_func)(void);
+    const char *name;          /*  */
+    sched_level_t level;       /* ȼ */
+    uint32_t rate_ms;          /* ڣ0=ʱͷţ¼Ϊѯ */
+    uint32_t events;           /* ͷŸ¼־0=ֻͷ */
+    uint32_t deadline_ms;      /* Խֹʱ (ͷŵ)0=ڣ¼ */
+    uint32_t stack;            /* ջ (ֽ) */
+    uint32_t last_run;         /* һεͷʱ */
+    uint32_t release;          /* ǰҵͷʱ (DWT) */
+    volatile uint8_t ready;    /* ͷšδʼ */
+    volatile uint8_t running;  /*  (ܱȼռ) */
+    uint32_t runs;             /* ɴ */
+    uint32_t misses;           /* ʱֹʱĴ */
+    uint32_t overruns;         /* ͷʱʱһҵδɡͷűĴ */
+    /* ʱΪDWT */
+    uint32_t max_response;     /* Ӧʱ (ͷŵ) */
+    uint32_t max_jitter;       /* ӳ (ͷŵʼ) */
+    uint32_t max_exec;         /* ִʱ (ռʱ) */
+    uint64_t sum_jitter;       /* ӳۼƣƽ */
+    uint64_t sum_exec;         /* ִʱۼ */
+    uint64_t window_exec;      /* ͳƴڵִʱ䣬CPUռ */
+    uint32_t hist[SCHED_HIST_BINS]; /* ͳƴڵִʱֱͼ */
 } task_t;
 
+static uint32_t sched_task_cycles;   /* ҵִʱ֮ͣڿ۳ռʱ */
+static uint32_t sched_cycles_per_us; /* ÿ΢DWT */
+static uint32_t sched_window_start;  /* ͳƴڿʼʱ (ms) */
+
 u32 i=0;
 
 
@@ -20,39 +56,279 @@ void uart_proc(void)
 
 static task_t scheduler_task[] =
 {
-    {ad_proc, 1, 0},        
-		{key_proc,10,0},
-		{stm32_adc_proc,1,0}
+    /*                       ȼ                    ¼                  ֹ ջ */
+    {SCHED_TASK(stm32_adc_proc), SCHED_LEVEL_HIGH,       10, SCHED_EVENT_ADC_DONE, 2,  1024},  /* λ/໷ɼУ10msѯ adc_flag¼ʧʱֹͣɼ */
+    {SCHED_TASK(ad_proc),        SCHED_LEVEL_LOW,        1,  0,                    5,  256},   /* ADֵæȴ */
+#if AMP_LOOP_ENABLE
+    {SCHED_TASK(Pid_Proc),       SCHED_LEVEL_LOW,        1,  0,                    5,  256},   /* Ȼȡ ad_proc ·ֵ */
+    {SCHED_TASK(AD9959_proc),    SCHED_LEVEL_LOW,        1,  0,                    5,  256},   /* Ȼ pid_vin дAD9959 */
+#endif
+    {SCHED_TASK(key_proc),       SCHED_LEVEL_BACKGROUND, 10, 0,                    50, 1024},  /* Ҫʱ (PD6PB6EXTI6ȫΪж) */
+    {SCHED_TASK(stm32_report_proc), SCHED_LEVEL_BACKGROUND, 10, 0,                 2500, 512}, /* λ/໷Ĵڱ汣 (FlashԼ1~2) */
+    {SCHED_TASK(PID_Report_Proc), SCHED_LEVEL_BACKGROUND, 10, 0,                   2500, 512}, /* ȻĴڱ汣 */
+    {SCHED_TASK(uart_cmd_proc),  SCHED_LEVEL_BACKGROUND, 10, 0,                    3000, 1024}, /* ĺ̨ (ɨƵԼ2) */
 		// {wave_test,20,0},  
    // {DA_proc, 10, 0},        
-    //{AD9959_proc, 1200, 0},   
     //{uart_proc, 10, 0},  
-		//{Pid_Proc,1,0},
 };
 
 
+/* ĳȼĵ쳣 */
+static void scheduler_pend(sched_level_t level)
+{
+    switch(level)
+    {
+        case SCHED_LEVEL_HIGH: NVIC_SetPendingIRQ(SCHED_SWI_HIGH_IRQn); break;
+        case SCHED_LEVEL_MID:  NVIC_SetPendingIRQ(SCHED_SWI_MID_IRQn); break;
+        case SCHED_LEVEL_LOW:  SCB->ICSR = SCB_ICSR_PENDSVSET_Msk; break;
+        default: break; /* ̨ѭѯ */
+    }
+}
+
+/* ¼һҵӳ١ִʱӦʱ */
+static void scheduler_account(task_t *task, uint32_t start, uint32_t end, uint32_t preempted)
+{
+    uint32_t jitter = start - task->release;
+    uint32_t exec = end - start - preempted;
+    uint32_t response = end - task->release;
+    uint32_t deadline = (task->deadline_ms ? task->deadline_ms : task->rate_ms) * 1000U * sched_cycles_per_us;
+    uint8_t bin = 0;
+
+    task->runs++;
+    task->sum_jitter += jitter;
+    task->sum_exec += exec;
+    task->window_exec += exec;
+    if (jitter > task->max_jitter)
+        task->max_jitter = jitter;
+    if (exec > task->max_exec)
+        task->max_exec = exec;
+    if (response > task->max_response)
+        task->max_response = response;
+    if (response > deadline)
+        task->misses++;
+
+    while (bin < SCHED_HIST_BINS - 1 && exec >= sched_hist_edges[bin] * sched_cycles_per_us)
+        bin++;
+    task->hist[bin]++;
+}
+
+/* ĳȼͷŵ񣬲ͳʱ
+ * ִʱ = ʼ - ڼȼҵִʱ ( sched_task_cycles õ) */
+static void scheduler_dispatch(sched_level_t level)
+{
+    for (uint8_t i = 0; i < task_num; i++)
+    {
+        task_t *task = &scheduler_task[i];
+        if (task->level != level || !task->ready)
+            continue;
+
+        /* ȡʱ sched_task_cycles ֮䲻ܱռռҵᱻؿ۳ */
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        task->ready = 0;
+        task->running = 1;
+        uint32_t base = sched_task_cycles;
+        uint32_t start = DWT->CYCCNT;
+        __set_PRIMASK(primask);
+
+        task->task_func();
+
+        __disable_irq();
+        uint32_t end = DWT->CYCCNT;
+        uint32_t preempted = sched_task_cycles - base;
+        sched_task_cycles += end - start - preempted;
+        task->running = 0;
+        __set_PRIMASK(primask);
+
+        scheduler_account(task, start, end, preempted);
+    }
+}
+
 void scheduler_init(void)
 { 
+    uint32_t level_stack[SCHED_LEVEL_COUNT] = {0};
+    uint32_t stack = SCHED_ISR_STACK;
+
     task_num = sizeof(scheduler_task) / sizeof(task_t);
+
+    /* ȼͬʱǶףջΪÿջ֮ */
+    for (uint8_t i = 0; i < task_num; i++)
+    {
+        if (scheduler_task[i].stack > level_stack[scheduler_task[i].level])
+            level_stack[scheduler_task[i].level] = scheduler_task[i].stack;
+    }
+    for (uint8_t l = 0; l < SCHED_LEVEL_COUNT; l++)
+        stack += level_stack[l];
+    if (stack > SCHED_STACK_SIZE)
+        my_printf(&huart1, ": ջ%luֽڳջ%uֽ\r\n", (unsigned long)stack, SCHED_STACK_SIZE);
+
+    /* DWTڼ */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    sched_cycles_per_us = SystemCoreClock / 1000000U;
+    sched_window_start = HAL_GetTick();
+
+    HAL_NVIC_SetPriority(SCHED_SWI_HIGH_IRQn, SCHED_PRIO_HIGH, 0);
+    HAL_NVIC_EnableIRQ(SCHED_SWI_HIGH_IRQn);
+    HAL_NVIC_SetPriority(SCHED_SWI_MID_IRQn, SCHED_PRIO_MID, 0);
+    HAL_NVIC_EnableIRQ(SCHED_SWI_MID_IRQn);
+    HAL_NVIC_SetPriority(PendSV_IRQn, SCHED_PRIO_LOW, 0);
+}
+
+/* ͷһҵһҵδʱͷűϲΪ
+ * ͬʱSysTickжеãжϱ */
+static void scheduler_release(task_t *task)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (task->ready || task->running)
+    {
+        task->overruns++;
+    }
+    else
+    {
+        task->release = DWT->CYCCNT;
+        task->ready = 1;
+        scheduler_pend(task->level);
+    }
+    __set_PRIMASK(primask);
 }
 
+/* ÿ1msSysTickжеãͷŵڵ */
+void scheduler_tick(void)
+{
+    uint32_t now_time = HAL_GetTick();
 
+    for (uint8_t i = 0; i < task_num; i++)
+    {
+        task_t *task = &scheduler_task[i];
+        if (task->rate_ms == 0 || now_time - task->last_run < task->rate_ms)
+            continue;
 
-void scheduler_run(void)
+        task->last_run = now_time;
+        /* ѯʱҵ¼ͷţ */
+        if (task->events && (task->ready || task->running))
+            continue;
+        scheduler_release(task);
+    }
+}
+
+/* жеãͷŵȴЩ¼ */
+void scheduler_signal(uint32_t events)
+{
+    for (uint8_t i = 0; i < task_num; i++)
+    {
+        if (scheduler_task[i].events & events)
+            scheduler_release(&scheduler_task[i]);
+    }
+}
+
+/* Ƿͷŵĺ̨ */
+static uint8_t scheduler_background_ready(void)
+{
+    for (uint8_t i = 0; i < task_num; i++)
+    {
+        if (scheduler_task[i].level == SCHED_LEVEL_BACKGROUND && scheduler_task[i].ready)
+            return 1;
+    }
+    return report_request;
+}
+
+/* ͨڴӡtopͳƱ֮ʼµͳƴ
+ * CPUռʺֱͼΪڵݣΪϵۼƣʱ䵥λΪus
+ * ͳжеĵджϸƿղ㴰ݣٴӡ */
+static void scheduler_print(void)
 {
+    task_t snapshot[sizeof(scheduler_task) / sizeof(task_t)];
+    uint32_t now;
+
+    __disable_irq();
+    memcpy(snapshot, scheduler_task, sizeof(snapshot));
+    for (uint8_t i = 0; i < task_num; i++)
+    {
+        scheduler_task[i].window_exec = 0;
+        memset(scheduler_task[i].hist, 0, sizeof(scheduler_task[i].hist));
+    }
+    now = HAL_GetTick();
+    float window_us = (float)(now - sched_window_start) * 1000.0f;
+    sched_window_start = now;
+    __enable_irq();
+
+    if (window_us <= 0.0f)
+        window_us = 1.0f;
+
+    my_printf(&huart1, "              CPU%%   ִоֵ/   ֵ/   Ӧ  д ʱ \r\n");
+    for (uint8_t i = 0; i < task_num; i++)
+    {
+        task_t *task = &snapshot[i];
+        float runs = task->runs ? (float)task->runs : 1.0f;
+        float us = (float)sched_cycles_per_us;
+
+        my_printf(&huart1, "%-15s %2d %4lu %5.1f %7.1f/%-7.1f %7.1f/%-7.1f %9.1f %9lu %4lu %4lu\r\n",
+                  task->name, task->level, (unsigned long)task->rate_ms,
+                  100.0f * (float)task->window_exec / us / window_us,
+                  (float)task->sum_exec / us / runs, (float)task->max_exec / us,
+                  (float)task->sum_jitter / us / runs, (float)task->max_jitter / us,
+                  (float)task->max_response / us,
+                  (unsigned long)task->runs, (unsigned long)task->misses, (unsigned long)task->overruns);
+    }
+
+    float busy = 0.0f;
+    for (uint8_t i = 0; i < task_num; i++)
+        busy += (float)snapshot[i].window_exec / (float)sched_cycles_per_us;
+    my_printf(&huart1, " (ж) %.1f%%\r\n", 100.0f * (1.0f - busy / window_us));
+
+    my_printf(&huart1, "ִʱֲ(us) <10 <50 <100 <250 <500 <1000 <2000 >=2000\r\n");
     for (uint8_t i = 0; i < task_num; i++)
     {
-        
-        uint32_t now_time = HAL_GetTick();
+        my_printf(&huart1, "%-15s", snapshot[i].name);
+        for (uint8_t b = 0; b < SCHED_HIST_BINS; b++)
+            my_printf(&huart1, " %lu", (unsigned long)snapshot[i].hist[b]);
+        my_printf(&huart1, "\r\n");
+    }
 
-       
-        if (now_time >= scheduler_task[i].rate_ms + scheduler_task[i].last_run)
-        {
-            
-            scheduler_task[i].last_run = now_time;
+    pipeline_report();
+}
 
-           
-            scheduler_task[i].task_func();
-        }
+/* ѭеãк̨ûпеʱ˯
+ * жϺWFI֮жԻỽCPUжϺӦᶪʧ¼ */
+void scheduler_run(void)
+{
+    scheduler_dispatch(SCHED_LEVEL_BACKGROUND);
+    if (report_request)
+    {
+        report_request = 0;
+        scheduler_print();
     }
+
+    __disable_irq();
+    if (!scheduler_background_ready())
+    {
+        __DSB();
+        __WFI();
+    }
+    __enable_irq();
+}
+
+/* PendSV_Handler е */
+void scheduler_pendsv(void)
+{
+    scheduler_dispatch(SCHED_LEVEL_LOW);
+}
+
+void SAI1_IRQHandler(void)
+{
+    scheduler_dispatch(SCHED_LEVEL_MID);
+}
+
+void SPI6_IRQHandler(void)
+{
+    scheduler_dispatch(SCHED_LEVEL_HIGH);
+}
+
+/* ӡͳƣں̨ӡռжʱ */
+void scheduler_report(void)
+{
+    report_request = 1;
 }
@@ -4,7 +4,31 @@
 #include "bsp_system.h"
 #include "stm_sig.h"
 
+/*
+ * ռʽȼȣSysTickͷţȼڶӦ쳣У
+ * ȼռȼͬһȼ˳ (ռ)
+ * еĺջջɸȼջ֮͡
+ * SysTickȼΪ1 ()HAL_GetTick()HAL_Delay()ʹڳʱճ
+ * ԰ͷţҲжϵ scheduler_signal() ¼־ͷţ
+ * ûпеʱѭִWFI˯ߣһжϻѡ
+ */
+typedef enum
+{
+    SCHED_LEVEL_BACKGROUND = 0, /* ̨ѭ scheduler_run()  */
+    SCHED_LEVEL_LOW,            /* ͣPendSVNVICȼ14 */
+    SCHED_LEVEL_MID,            /* Уж (SAI1ж)NVICȼ8 */
+    SCHED_LEVEL_HIGH,           /* ߣж (SPI6ж)NVICȼ4 */
+    SCHED_LEVEL_COUNT
+} sched_level_t;
+
+/* ¼־ */
+#define SCHED_EVENT_ADC_DONE (1U << 0) /* ˫ADCDMAɼ */
+
 void scheduler_init(void);
 void scheduler_run(void);
+void scheduler_tick(void);
+void scheduler_signal(uint32_t events);
+void scheduler_pendsv(void);
+void scheduler_report(void);
 
 #endif
@@ -5,14 +5,30 @@
 #include "ad_measure.h"
 #include "my_fft.h"
 #include "da_output.h"
+#include "sine_fit.h"
+#include "pid_controller.h"
+#include "pid_autotune.h"
+#include "param_store.h"
+#include "dpll.h"
+#include "gain_schedule.h"
 #define FFT_LEN 1024
+#define FIT_LEN 256 // λʹõ
+#define DPLL_FIT_LEN 1024           // ໷ʹõƵʲӦ fs/DPLL_FIT_LEN
+#define DPLL_BANDWIDTH 5.0f         // ໷ (Hz)
+#define DPLL_MAX_OFFSET 50.0f       // ໷Ƶƫ (Hz)
+#define DPLL_PERIOD 0.005f          // ·ڳֵ (s)ʵ
+#define DPLL_REPORT_MS 1000         // ໷״̬ϱ (ms)
+#define TRACK_TUNE_AMPLITUDE 0.5f   // ʱDAƵʵļ̵ƫ (Hz)
+#define TRACK_TUNE_HYSTERESIS 0.02f // ز (rad)
+#define TRACK_TUNE_SAVE 1           // 1浽Flash
 #define pi 3.1415926
 
 uint16_t adc1_buf[1024];
 uint16_t adc2_buf[1024];
-uint32_t adc_buffer[1024];
+DMA_BUFFER uint32_t adc_buffer[1024]; // ADC1/ADC2˫ģʽDMAĿ
 float32_t windows[FFT_LEN];
 float32_t window_compensation_factor;
+// ϵҲ (ǰFFT_LEN)ʧܺ stm32_adc_fft() д
 float fft_cfft_input1[2048];
 float fft_cfft_input2[2048];
 float fft_cfft_output1[1024];
@@ -183,6 +199,36 @@ float stm32_fft_phasedifferance_calculate(){
 			else 
 				return 0;
 }
+// ADC = TIM2ʱ / ((PSC+1)*(ARR+1))APB1ƵΪ1ʱʱʱΪPCLK12
+float stm32_adc_sampling_freq(){
+	uint32_t clock = HAL_RCC_GetPCLK1Freq();
+	if((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_HCLK_DIV1) clock *= 2;
+	return (float)clock / ((htim2.Init.Prescaler + 1) * (htim2.Init.Period + 1));
+}
+
+// ϼλֻȡǰFIT_LENҪFFTʹ
+// DAƵΪֵͨ1Ĳϣͨ2ϳƵ
+uint8_t stm32_fit_phasedifferance_calculate(float freq, float *delta){
+	sine_fit_result_t fit1, fit2;
+	float fs = stm32_adc_sampling_freq();
+	uint16_t i;
+	for(i=0;i<FIT_LEN;i++){
+		fft_cfft_input1[i]=(float)(adc_buffer[i] & 0xFFFF)*3.3f/65536.0f;
+		fft_cfft_input2[i]=(float)(adc_buffer[i]>>16)*3.3f/65536.0f;
+	}
+	if(!sine_fit_4param(fft_cfft_input1, FIT_LEN, fs, freq, &fit1) || !fit1.converged) return 0;
+	if(!sine_fit_3param(fft_cfft_input2, FIT_LEN, fs, fit1.frequency, &fit2)) return 0;
+
+	phase1 = fit1.phase;
+	phase2 = fit2.phase;
+	float delta_phase = phase1 - phase2;
+	while (delta_phase > PI) delta_phase -= 2 * PI;
+	while (delta_phase < -PI) delta_phase += 2 * PI;
+	phase_calculate_ok=1;
+	*delta = delta_phase;
+	return 1;
+}
+
 float calculate_median(float*num){
   uint16_t i=0;
 	float max=0.0;
@@ -194,45 +240,205 @@ float calculate_median(float*num){
 	return (max+min)/2.0;
 }
 
-// PIDṹ壨ȫֱ
-typedef struct {
-    float Kp;
-    float Ki;
-    float Kd;
-    float integral;
-    float prev_error;
-    float max_integral;
-} TrackingPID;
-
-TrackingPID track_pid = {
-    .Kp = 0.05f,     // ϵ
-    .Ki = 0,    // ϵ
-    .Kd = 0.6f,     // ΢ϵ
-    .integral = 0,
-    .prev_error = 0,
-    .max_integral = 0.2f
+// λPIDȫֱΪÿڵDAƵʵ
+// ޷ track_schedule DAƵʵȣֵΪ20kHzĳֵ
+pid_ctrl_t track_pid = {
+    .form = PID_FORM_POSITIONAL,
+    .kp = 0.05f,              // ϵ
+    .ki = 0,                  // ϵ
+    .kd = 0.6f,               // ΢ϵ
+    .d_alpha = 0.5f,          // ΢һ˲ϵλ
+    .kt = 0,                  // 㿹棬ϵΪ0ʱҪ
+    .integral_limit = 0.2f,   // ޷
+    .out_min = -0.5f,         // ÿƵʵ޷ (Hz)
+    .out_max = 0.5f
 };
 
-// PID
-float track_pid_update(TrackingPID* pid, float error) {
-    // £޷
-    pid->integral += pid->Ki * error;
-    pid->integral = fmaxf(fminf(pid->integral, pid->max_integral), -pid->max_integral);
-    
-    // ΢
-    float derivative = pid->Kd * (error - pid->prev_error);
-    pid->prev_error = error;
-    
-    return pid->Kp * error + pid->integral + derivative;
+// λٻȱ (ֵֹƵθ)
+// ƵʳֵƵƯƴƵʳȣÿƵʵ޷Լ25ppmãʹƵβʱ
+static const gain_point_t track_schedule_default[PARAM_PHASE_BANDS] = {
+    // Ƶ(Hz)   Kp      Ki    Kd    ޷(Hz)
+    {10000.0f,  0.05f,  0.0f, 0.6f, 0.25f},
+    {30000.0f,  0.05f,  0.0f, 0.6f, 0.75f},
+    {60000.0f,  0.05f,  0.0f, 0.6f, 1.5f},
+    {100000.0f, 0.05f,  0.0f, 0.6f, 2.5f},
+};
+static gain_schedule_t track_schedule;
+
+static pid_autotune_t track_tune;               // λ
+static volatile uint8_t track_tune_request = 0; // 󣬿жλ
+
+// stm32_adc_proc() ڸȼУܵĴڴӡFlashд
+//  track_report м¼ɺ̨ stm32_report_proc() ӡͱ
+#define TRACK_REPORT_TUNE_START (1U << 0) // ʼ
+#define TRACK_REPORT_TUNE_FAIL  (1U << 1) // ʧ
+#define TRACK_REPORT_TUNE_DONE  (1U << 2) // ɣ track_tune_gains / track_tune_band
+#define TRACK_REPORT_DPLL_START (1U << 3) // ໷
+#define TRACK_REPORT_DPLL_STOP  (1U << 4) // ໷ֹͣ
+#define TRACK_REPORT_DPLL_STATUS (1U << 5) // ໷ʱ״̬ϱ
+#define TRACK_REPORT_DPLL_LOCK(k)   (1U << (8 + (k)))  // DA(k+1)  dpll_event_jitter[k]
+#define TRACK_REPORT_DPLL_UNLOCK(k) (1U << (12 + (k))) // DA(k+1) ʧ
+static volatile uint32_t track_report = 0;
+static volatile uint8_t track_parked = 0;       // 1=̨ڲдFlash·ͣ
+static param_gains_t track_tune_gains;          // һĽ
+static uint8_t track_tune_band;                 // ڵƵ
+
+// ȱȡƵα棬ǰDAƵֱлӦ
+void track_pid_init(void) {
+    param_gains_t gains;
+    uint8_t k;
+    gain_schedule_init(&track_schedule, track_schedule_default, PARAM_PHASE_BANDS);
+    for(k=0;k<PARAM_PHASE_BANDS;k++) {
+        if(param_store_load((param_loop_t)(PARAM_LOOP_PHASE + k), &gains)) {
+            gain_schedule_tune(&track_schedule, k, gains.kp, gains.ki, gains.kd);
+            my_printf(&huart1, "λ%.0fHzƵʹñ: Kp=%.4f Ki=%.4f Kd=%.4f\r\n",
+                      track_schedule.points[k].frequency, gains.kp, gains.ki, gains.kd);
+        }
+    }
+    gain_schedule_apply(&track_schedule, &track_pid, da_channels[0].frequency, 1.0f);
+}
+
+// λһβɼʱʼ̵ʵ
+void track_pid_autotune_start(void) {
+    track_tune_request = 1;
+}
+
+// ̵ʵDAƵΪ롢λΪʶƵ->λPI Kp_fKi_f
+// track_pid ۼӵDAƵϣƵ = kp*sum(e) + kd*e
+//  track_pid.kp = Ki_ftrack_pid.kd = Kp_fд̵ƵڵƵΡ
+// ͱɺ̨
+static void track_pid_autotune_finish(void) {
+    float kp_f, ki_f, kd_f;
+    uint8_t band = gain_schedule_band(&track_schedule, track_tune.bias);
+
+    pid_reset(&track_pid, 0.0f);
+    if(!pid_autotune_gains(&track_tune, AUTOTUNE_RULE_ZN_PI, &kp_f, &ki_f, &kd_f)) {
+        track_report |= TRACK_REPORT_TUNE_FAIL;
+        return;
+    }
+
+    track_tune_gains.kp = ki_f;
+    track_tune_gains.ki = 0.0f;
+    track_tune_gains.kd = kp_f;
+    track_tune_band = band;
+    gain_schedule_tune(&track_schedule, band, track_tune_gains.kp, track_tune_gains.ki, track_tune_gains.kd);
+    gain_schedule_apply(&track_schedule, &track_pid, track_tune.bias, 1.0f);
+    track_report |= TRACK_REPORT_TUNE_DONE;
+}
+
+static dpll_t dpll[NUM_DA_CHANNELS];       // ·DAһ໷
+static volatile uint8_t dpll_request = 0; // 1=2=ֹͣжλ
+static uint8_t dpll_active = 0;
+static uint32_t dpll_tick;                // һλ·µʱ (ms)
+static uint32_t dpll_report_tick;         // һ״̬ϱʱ (ms)
+static float dpll_period;                 // ʵ⻷· (s)
+static float dpll_event_jitter[NUM_DA_CHANNELS]; // /ʧʱ̵Ķ (rad)̨
+
+// ໷ģʽ·DAֱƵȡǰDAƵ
+void stm32_dpll_start(void) {
+    dpll_request = 1;
+}
+
+// ˳໷ģʽصͨλ
+void stm32_dpll_stop(void) {
+    dpll_request = 2;
+}
+
+// ໷ࣺͨ1·DA֮ͣͨ2Դźţ
+// ͨ·DAƵ˫ϣ e = phase_Source - phase_DA
+static uint8_t stm32_dpll_phase_errors(float *errors) {
+    sine_fit_result_t da[NUM_DA_CHANNELS], src[NUM_DA_CHANNELS];
+    float fs = stm32_adc_sampling_freq();
+    uint16_t i;
+    for(i=0;i<DPLL_FIT_LEN;i++){
+        fft_cfft_input1[i]=(float)(adc_buffer[i] & 0xFFFF)*3.3f/65536.0f;
+        fft_cfft_input2[i]=(float)(adc_buffer[i]>>16)*3.3f/65536.0f;
+    }
+    phase_calculate_ok=1; // ȡʧҲҪ²ɼ
+    if(!sine_fit_2tone(fft_cfft_input1, DPLL_FIT_LEN, fs, dpll[0].frequency, dpll[1].frequency, da)) return 0;
+    if(!sine_fit_2tone(fft_cfft_input2, DPLL_FIT_LEN, fs, dpll[0].frequency, dpll[1].frequency, src)) return 0;
+
+    for(i=0;i<NUM_DA_CHANNELS;i++){
+        float e = src[i].phase - da[i].phase;
+        while (e > PI) e -= 2 * PI;
+        while (e < -PI) e += 2 * PI;
+        errors[i] = e;
+    }
+    return 1;
+}
+
+// ໷ͣ
+static void stm32_dpll_request(void) {
+    uint8_t k;
+    if(dpll_request == 1) {
+        for(k=0;k<NUM_DA_CHANNELS;k++)
+            dpll_init(&dpll[k], da_channels[k].frequency, DPLL_BANDWIDTH, DPLL_DEFAULT_DAMPING, DPLL_PERIOD, DPLL_MAX_OFFSET);
+        dpll_period = DPLL_PERIOD;
+        dpll_tick = HAL_GetTick();
+        dpll_report_tick = dpll_tick;
+        dpll_active = 1;
+        track_report |= TRACK_REPORT_DPLL_START;
+    } else if(dpll_request == 2 && dpll_active) {
+        dpll_active = 0;
+        track_report |= TRACK_REPORT_DPLL_STOP;
+    }
+    dpll_request = 0;
+}
+
+// ໷ģʽһλ·£ࡢ·˲ֻдƵ (λ)ϱ״̬
+static void stm32_dpll_proc(void) {
+    float errors[NUM_DA_CHANNELS];
+    uint32_t now = HAL_GetTick();
+    uint8_t k;
+
+    // ·ɲɼͼʱmsʱָƽ
+    dpll_period += 0.1f * ((now - dpll_tick) * 0.001f - dpll_period);
+    dpll_tick = now;
+
+    if(!stm32_dpll_phase_errors(errors)) return;
+
+    for(k=0;k<NUM_DA_CHANNELS;k++) {
+        uint8_t was_locked = dpll[k].locked;
+        dpll_set_period(&dpll[k], dpll_period);
+        DA_SetFrequency(k, dpll_update(&dpll[k], errors[k]));
+
+        if(dpll[k].locked != was_locked) {
+            dpll_event_jitter[k] = dpll[k].jitter;
+            track_report |= dpll[k].locked ? TRACK_REPORT_DPLL_LOCK(k) : TRACK_REPORT_DPLL_UNLOCK(k);
+        }
+    }
+
+    if(now - dpll_report_tick >= DPLL_REPORT_MS) {
+        dpll_report_tick = now;
+        track_report |= TRACK_REPORT_DPLL_STATUS;
+    }
 }
 
 void stm32_adc_proc() {
+    if(adc_flag && track_parked) {
+        // ̨дFlashڼ䶪ɼݣDAƵʲ
+        adc_flag = 0;
+        phase_calculate_ok = 1;
+        stm32_adc_restart();
+        return;
+    }
     if(adc_flag) {
-        stm32_adc_fft();
-        
-        // 1. ȡǰDAƵʺλ
+        if(dpll_request) stm32_dpll_request();
+        if(dpll_active) {
+            stm32_dpll_proc();
+            adc_flag = 0;
+            stm32_adc_restart();
+            return;
+        }
+
+
+        // 1. ȡǰDAƵʺλʧʱ˻FFT
         float current_freq = da_channels[0].frequency;
-        float diff = stm32_fft_phasedifferance_calculate();
+        float diff;
+        if(!stm32_fit_phasedifferance_calculate(current_freq, &diff)) {
+            stm32_adc_fft();
+            diff = stm32_fft_phasedifferance_calculate();
+        }
         
         // 2. λ壨ؼ
         // diff = phase_DA - phase_Source
@@ -240,12 +446,24 @@ void stm32_adc_proc() {
         // DAźͺԴźʱdiff < 0  ҪDAƵ
         float error = -diff;  // ת
         
-        // 3. ʹPIDƵʵ
-        float freq_adjust = track_pid_update(&track_pid, error);
+        // 3. ʱDAƵ f0d ̵֮лPIDƵʵ޷
+        if(track_tune_request) {
+            track_tune_request = 0;
+            pid_autotune_start(&track_tune, 0.0f, current_freq, TRACK_TUNE_AMPLITUDE, TRACK_TUNE_HYSTERESIS);
+            track_report |= TRACK_REPORT_TUNE_START;
+        }
         
-        // 4. ӦõƵʣ޷
-        float new_freq = current_freq + freq_adjust;
-        new_freq = fmaxf(fminf(new_freq, current_freq + 0.5f), current_freq - 0.5f);
+        // 4. ӦõƵ
+        float new_freq;
+        if(track_tune.state == AUTOTUNE_RUNNING) {
+            new_freq = pid_autotune_update(&track_tune, diff); //  = 0 - diff = error
+            if(track_tune.state != AUTOTUNE_RUNNING)
+                track_pid_autotune_finish();
+        } else {
+            // ǰƵʵ޷Ƶʱ𲽹
+            gain_schedule_apply(&track_schedule, &track_pid, current_freq, GAIN_SCHEDULE_BLEND);
+            new_freq = current_freq + pid_update(&track_pid, error, 0.0f, 0.0f);
+        }
         
         // 5. DA
         da_channels[0].frequency = new_freq;
@@ -255,4 +473,54 @@ void stm32_adc_proc() {
         adc_flag = 0;
         stm32_adc_restart();
     }
-}
\ No newline at end of file
+}
+
+// ̨񣺴ӡȼµ¼ (໷ͣ//״̬)
+// 밴̨ӡִУڴHALϳͻ
+// FlashڼCPUͣԼ1~2룬ͣ·ָʱû·ʱPID״̬ͣٲ
+void stm32_report_proc(void) {
+    uint32_t events;
+    uint8_t k;
+
+    __disable_irq();
+    events = track_report;
+    track_report = 0;
+    __enable_irq();
+
+    if(events & TRACK_REPORT_TUNE_START)
+        my_printf(&huart1, "λʼ\r\n");
+    if(events & TRACK_REPORT_TUNE_FAIL)
+        my_printf(&huart1, "λʧܣԭ\r\n");
+    if(events & TRACK_REPORT_TUNE_DONE) {
+        param_gains_t gains = track_tune_gains;
+        uint8_t band = track_tune_band;
+        my_printf(&huart1, "λ(%.0fHzƵ): Ku=%.4f Tu=%.1f -> Kp=%.4f Kd=%.4f\r\n",
+                  track_schedule.points[band].frequency, track_tune.ku, track_tune.tu, gains.kp, gains.kd);
+#if TRACK_TUNE_SAVE
+        uint8_t ok;
+        track_parked = 1;
+        ok = param_store_save((param_loop_t)(PARAM_LOOP_PHASE + band), &gains);
+        pid_reset(&track_pid, 0.0f);
+        dpll_tick = HAL_GetTick();
+        track_parked = 0;
+        my_printf(&huart1, ok ? "ѱ\r\n" : "汣ʧ\r\n");
+#endif
+    }
+
+    // ໷ƵʡΪֱֳ̨Ӷȡֵ
+    if(events & TRACK_REPORT_DPLL_START)
+        my_printf(&huart1, "໷: DA1=%.1fHz DA2=%.1fHz\r\n", dpll[0].center, dpll[1].center);
+    for(k=0;k<NUM_DA_CHANNELS;k++) {
+        if(events & TRACK_REPORT_DPLL_LOCK(k))
+            my_printf(&huart1, "DA%d : ʱ%.1fms %.2f\r\n", k + 1, dpll[k].lock_time * 1000.0f, dpll_event_jitter[k] * 180.0f / PI);
+        if(events & TRACK_REPORT_DPLL_UNLOCK(k))
+            my_printf(&huart1, "DA%d ʧ: %.2f\r\n", k + 1, dpll_event_jitter[k] * 180.0f / PI);
+    }
+    if(events & TRACK_REPORT_DPLL_STATUS) {
+        for(k=0;k<NUM_DA_CHANNELS;k++)
+            my_printf(&huart1, "DA%d %s f=%.3fHz %.2f\r\n", k + 1, dpll[k].locked ? "" : "",
+                      dpll[k].frequency, dpll[k].jitter * 180.0f / PI);
+    }
+    if(events & TRACK_REPORT_DPLL_STOP)
+        my_printf(&huart1, "໷ֹͣ\r\n");
+}
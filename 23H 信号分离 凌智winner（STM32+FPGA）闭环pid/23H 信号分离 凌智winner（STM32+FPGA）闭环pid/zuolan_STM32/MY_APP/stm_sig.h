@@ -8,4 +8,9 @@
 #include "fmc.h"
 #include "bsp_system.h"   // 弶ְ֧ϵͳ壬ܰӲصĺ
 void stm32_adc_proc(void);
+void track_pid_init(void);
+void track_pid_autotune_start(void);
+void stm32_report_proc(void);
+void stm32_dpll_start(void);
+void stm32_dpll_stop(void);
 
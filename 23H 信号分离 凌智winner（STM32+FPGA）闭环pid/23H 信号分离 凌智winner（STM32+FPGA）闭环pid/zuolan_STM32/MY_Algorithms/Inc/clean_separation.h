@@ -0,0 +1,71 @@
+/**
+ * @file clean_separation.h
+ * @brief 逐个扣除、重新估计 (CLEAN) 的分量分离
+ * @details
+ * 频谱重叠时 (一个分量的谐波落在另一个分量基波附近，或两个频率只相差几个bin)，
+ * 单次寻峰会选错第二个峰值，也无法去除第一个分量的泄漏。本模块在时域上迭代分离：
+ * 1. 检测：对残差做加窗FFT，取最强峰值，估计其频率并用最小二乘拟合幅度和相位，
+ *    从残差中扣除后再找下一个；属于已有分量的谐波或残留的峰值只扣除、不计为新分量。
+ * 2. 细化：按 classify_waveforms() 判定的波形重建各分量 (含谐波)，
+ *    每个分量在扣除其他分量后的数据上重新估计频率、幅度和相位，交替进行固定轮数。
+ * 迭代次数有上限，向量运算均使用CMSIS-DSP函数。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#ifndef __CLEAN_SEPARATION_H__
+#define __CLEAN_SEPARATION_H__
+
+#include "my_fft.h"
+#include "waveform_classifier.h"
+
+#define CLEAN_MAX_LENGTH FFT_MAX_LENGTH // 参与分离的最大样本数，工作缓冲区借用 fft_scratch
+#define CLEAN_MIN_LENGTH 256    // 参与分离的最少样本数
+#define CLEAN_MAX_COMPONENTS 2  // 最多分离的分量数
+#define CLEAN_MAX_ITERATIONS 8  // 检测阶段最多扣除的峰值数
+#define CLEAN_REFINE_SWEEPS 3   // 细化阶段的交替估计轮数
+#define CLEAN_MERGE_BINS 1.0f   // 新峰值与已有分量 (或其谐波) 相距小于该值 (bin) 时视为同一分量的残留
+
+/**
+ * @brief 分离出的单个分量
+ */
+typedef struct
+{
+    float frequency;        // 频率 (Hz)
+    float amplitude;        // 基波峰值幅度 (V)
+    float phase;            // 基波初相 (rad，正弦参考，以第一个样本为零时刻)
+    waveform_class_t shape; // 波形分类结果，决定重建时的谐波
+} clean_component_t;
+
+/**
+ * @brief 分离结果
+ */
+typedef struct
+{
+    uint8_t count;                                      // 分离出的分量数
+    uint8_t iterations;                                 // 检测阶段实际扣除的峰值数
+    uint16_t length;                                    // 实际使用的样本数
+    float signal_rms;                                   // 去直流后信号的均方根值 (V)
+    float residual_rms;                                 // 扣除全部分量后残差的均方根值 (V)
+    clean_component_t components[CLEAN_MAX_COMPONENTS]; // 分量，按幅度降序
+} clean_result_t;
+
+/**
+ * @brief 迭代分离信号中的分量
+ * @param data 时域数据 (V)
+ * @param length 数据长度，使用其中不超过 CLEAN_MAX_LENGTH 的最大2的幂个样本
+ * @param sampling_freq 采样率 (Hz)
+ * @param min_threshold 相对最强分量的幅度阈值 (0~1)，低于此值的峰值不作为分量
+ * @param result 输出分离结果
+ * @return 分离出的分量数
+ */
+uint8_t clean_separate(const float* data, uint16_t length, float sampling_freq, float min_threshold,
+                       clean_result_t* result);
+
+/**
+ * @brief 用分离结果替换双峰检测结果
+ * @details 峰值按频率升序排列，bin_index 按当前FFT长度换算。
+ */
+void clean_to_dual_peaks(const clean_result_t* result, float sampling_freq, dual_peak_result_t* peaks);
+
+#endif // __CLEAN_SEPARATION_H__
@@ -0,0 +1,78 @@
+/**
+ * @file dpll.h
+ * @brief 二阶数字锁相环 (鉴相 -> PI环路滤波 -> DA频率字NCO)
+ * @details
+ * 每个环路跟踪一个分离出的信号分量，每次采集调用一次：
+ * - 鉴相：由调用者给出相位误差 e = phase_Source - phase_DA (rad，-pi~pi)，e > 0 表示DA滞后；
+ * - 环路滤波：位置式PI，输出为相对中心频率的频率偏移 (Hz)，NCO频率 = center + 偏移；
+ * - 参数设计：按噪声带宽 Bn (Hz) 和阻尼系数 zeta 计算，
+ *   wn = 2*Bn / (zeta + 1/(4*zeta))，Kp = 2*zeta*wn / (2*pi)，Ki = wn^2 * T / (2*pi)，T 为环路更新周期 (s)；
+ *   Bn*T 应小于约0.05，否则离散化误差和一拍测量延迟会使环路欠阻尼甚至失稳；
+ * - 锁定检测：误差平方的指数平均 (均方根即相位抖动) 连续 DPLL_LOCK_COUNT 次小于锁定门限判为锁定，
+ *   大于失锁门限判为失锁，两门限之间保持原状态 (迟滞)。锁定时间从启动或上次失锁开始计。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#ifndef __DPLL_H__
+#define __DPLL_H__
+
+#include "pid_controller.h"
+
+#define DPLL_DEFAULT_DAMPING 0.707f // 默认阻尼系数
+#define DPLL_LOCK_THRESHOLD 0.1f    // 锁定门限 (rad，相位误差均方根)
+#define DPLL_UNLOCK_THRESHOLD 0.3f  // 失锁门限 (rad)
+#define DPLL_LOCK_COUNT 8           // 判为锁定所需的连续次数
+#define DPLL_ERROR_ALPHA 0.1f       // 误差平方指数平均系数
+
+/**
+ * @brief 数字锁相环
+ */
+typedef struct
+{
+    // 参数
+    float center;       // NCO中心频率 (Hz)
+    float bandwidth;    // 环路噪声带宽 Bn (Hz)
+    float damping;      // 阻尼系数 zeta
+    float period;       // 环路更新周期 T (s)
+    float max_offset;   // 最大频率偏移 (Hz)，即捕获范围
+
+    // 状态
+    pid_ctrl_t filter;  // 环路滤波器 (PI)
+    float frequency;    // 当前NCO频率 (Hz)
+    float error_power;  // 误差平方的指数平均 (rad^2)
+    uint8_t locked;     // 1=已锁定
+    uint8_t lock_count; // 连续低于锁定门限的次数
+    float elapsed;      // 本次捕获已用时间 (s)
+
+    // 统计
+    float lock_time;    // 最近一次捕获所用时间 (s)
+    float jitter;       // 相位抖动 (rad，误差均方根)
+} dpll_t;
+
+/**
+ * @brief 初始化锁相环
+ * @param dpll 锁相环
+ * @param center NCO中心频率 (Hz)
+ * @param bandwidth 环路噪声带宽 (Hz)
+ * @param damping 阻尼系数
+ * @param period 环路更新周期 (s)
+ * @param max_offset 最大频率偏移 (Hz)
+ */
+void dpll_init(dpll_t* dpll, float center, float bandwidth, float damping, float period, float max_offset);
+
+/**
+ * @brief 更新环路周期并重新计算积分增益
+ * @details 环路周期由采集和计算耗时决定，运行中实测后调用，积分项保持不变。
+ */
+void dpll_set_period(dpll_t* dpll, float period);
+
+/**
+ * @brief 执行一次环路更新
+ * @param dpll 锁相环
+ * @param phase_error 相位误差 (rad)，phase_Source - phase_DA
+ * @return 新的NCO频率 (Hz)
+ */
+float dpll_update(dpll_t* dpll, float phase_error);
+
+#endif // __DPLL_H__
@@ -0,0 +1,82 @@
+/**
+ * @file gain_schedule.h
+ * @brief 按工作频率调度PID增益和输出限幅
+ * @details
+ * 调度表由若干个按频率升序排列的工作点组成，每个工作点给出该频率下的 Kp、Ki、Kd 和输出限幅 (±limit)。
+ * 工作频率落在两点之间时按频率线性插值，超出表的范围时取端点值。
+ * 应用到控制器时每次只向目标值靠近 blend 的比例，频率跨越频段时增益平滑过渡；
+ * 同时按新旧 Kd 之比缩放微分状态，位置式且 Ki 不为0时用积分项抵消 Kp 变化引起的输出跳变，实现无扰切换。
+ * 工作点可以手工填写，也可以由自整定结果按频段写入。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#ifndef __GAIN_SCHEDULE_H__
+#define __GAIN_SCHEDULE_H__
+
+#include "pid_controller.h"
+
+#define GAIN_SCHEDULE_MAX_POINTS 8 // 调度表最大工作点数
+#define GAIN_SCHEDULE_BLEND 0.2f   // 默认每次更新向目标增益靠近的比例
+
+/**
+ * @brief 调度表工作点
+ */
+typedef struct
+{
+    float frequency; // 工作频率 (Hz)
+    float kp;        // 比例增益
+    float ki;        // 积分增益 (每周期)
+    float kd;        // 微分增益 (每周期)
+    float limit;     // 输出限幅，控制器输出范围为 ±limit
+} gain_point_t;
+
+/**
+ * @brief 增益调度器
+ */
+typedef struct
+{
+    gain_point_t points[GAIN_SCHEDULE_MAX_POINTS]; // 按频率升序排列
+    uint8_t count;                                 // 工作点数
+    uint8_t band;                                  // 当前所在频段 (最近的工作点序号)
+} gain_schedule_t;
+
+/**
+ * @brief 初始化调度表
+ * @param schedule 调度器
+ * @param points 工作点数组，频率必须严格升序
+ * @param count 工作点数 (1 ~ GAIN_SCHEDULE_MAX_POINTS)
+ * @return 1=成功，0=点数无效或频率未升序
+ */
+uint8_t gain_schedule_init(gain_schedule_t* schedule, const gain_point_t* points, uint8_t count);
+
+/**
+ * @brief 查找与频率最近的工作点序号
+ */
+uint8_t gain_schedule_band(const gain_schedule_t* schedule, float frequency);
+
+/**
+ * @brief 按频率插值得到目标增益和限幅
+ * @param schedule 调度器
+ * @param frequency 工作频率 (Hz)
+ * @param point 输出插值结果，frequency 字段为输入频率
+ */
+void gain_schedule_lookup(const gain_schedule_t* schedule, float frequency, gain_point_t* point);
+
+/**
+ * @brief 把调度结果无扰地应用到控制器
+ * @param schedule 调度器
+ * @param pid 控制器
+ * @param frequency 当前工作频率 (Hz)
+ * @param blend 本次向目标值靠近的比例 (0~1]，1=直接切换 (用于启动时)
+ * @return 1=所在频段发生变化
+ */
+uint8_t gain_schedule_apply(gain_schedule_t* schedule, pid_ctrl_t* pid, float frequency, float blend);
+
+/**
+ * @brief 修改某个工作点的增益 (限幅不变)，供自整定或手工调整使用
+ * @return 1=成功，0=序号无效
+ */
+uint8_t gain_schedule_tune(gain_schedule_t* schedule, uint8_t band, float kp, float ki, float kd);
+
+#endif // __GAIN_SCHEDULE_H__
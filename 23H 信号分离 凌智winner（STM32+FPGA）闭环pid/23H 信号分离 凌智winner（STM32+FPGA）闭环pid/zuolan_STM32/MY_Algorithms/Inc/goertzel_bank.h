@@ -0,0 +1,89 @@
+/**
+ * @file goertzel_bank.h
+ * @brief 候选频率网格上的Goertzel滤波器组
+ * @details
+ * 信号分离题目中各分量的频率位于已知网格上 (起始频率 + k * 网格间隔)，
+ * 因此不必计算全部FFT bin，只需在网格频点及其2、3、5次谐波处各运行一个Goertzel滤波器：
+ * - 记录长度取网格周期 (fs / 网格间隔) 的整数倍，所有网格频率在记录内都是整周期，
+ *   用矩形窗即可互相正交，不存在网格与FFT bin不对齐造成的泄漏和幅度误差；
+ * - 每个频点的代价为记录长度次乘加，总计算量 = 候选数 * 记录长度；
+ * - 由谐波与基波的幅度比判断波形类型 (正弦/三角/方波/锯齿)；
+ * - 检测到的分量 (含谐波) 能量不足信号总能量的 GRID_MIN_EXPLAINED 时判为无效，
+ *   说明信号不在网格上，应改用FFT分析。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#ifndef __GOERTZEL_BANK_H__
+#define __GOERTZEL_BANK_H__
+
+#include "bsp_system.h"
+#include "da_output.h"
+
+#define GRID_MAX_CANDIDATES 64      // 网格候选频点的最大数量
+#define GRID_MAX_COMPONENTS 2       // 最多检测的分量数
+#define GRID_DEFAULT_START 10000.0f // 默认网格起始频率 (Hz)
+#define GRID_DEFAULT_STEP 5000.0f   // 默认网格间隔 (Hz)
+#define GRID_DEFAULT_COUNT 19       // 默认候选数 (10kHz ~ 100kHz)
+#define GRID_DEFAULT_PERIODS 1      // 默认记录长度 (网格周期数)
+#define GRID_MIN_EXPLAINED 0.8f     // 检测结果有效所需的最低能量占比
+
+/**
+ * @brief 网格上检测到的单个分量
+ */
+typedef struct
+{
+    float frequency;      // 网格频率 (Hz)
+    float magnitude;      // 基波峰值幅度 (V)
+    float harmonic_score; // 谐波评分：各可用奇次谐波的 (A_h * h^2 / A_1) 平均值，正弦约0，三角约1，方波约4
+    float even_ratio;     // 偶次比：A_2 * 2 / A_1，锯齿波约1，其他波形约0
+    Waveform_t waveform;  // 判定的波形类型
+} grid_component_t;
+
+/**
+ * @brief 网格检测结果
+ */
+typedef struct
+{
+    uint8_t count;                                   // 检测到的分量数
+    uint8_t valid;                                   // 1=分量能解释信号能量，结果可信
+    uint16_t record_length;                          // 实际使用的样本数
+    float explained;                                 // 检测分量 (含谐波) 能量占信号总能量的比例
+    grid_component_t components[GRID_MAX_COMPONENTS]; // 分量，按频率升序
+} grid_result_t;
+
+/**
+ * @brief 设置候选频率网格
+ * @param start 起始频率 (Hz)
+ * @param step 网格间隔 (Hz)
+ * @param count 候选数，不超过 GRID_MAX_CANDIDATES
+ * @param periods 记录长度包含的网格周期数，越多抗噪越好，计算量成比例增加
+ * @return 1=成功，0=参数无效
+ */
+uint8_t goertzel_bank_set_grid(float start, float step, uint16_t count, uint8_t periods);
+
+/**
+ * @brief 在候选网格上检测信号分量及其波形类型
+ * @param data 时域数据 (V)
+ * @param length 数据长度
+ * @param sampling_freq 采样率 (Hz)
+ * @param min_threshold 相对最大分量的幅度阈值 (0~1)
+ * @param result 输出检测结果
+ * @return 检测到的分量数
+ */
+uint8_t goertzel_bank_detect(const float* data, uint16_t length, float sampling_freq,
+                             float min_threshold, grid_result_t* result);
+
+/**
+ * @brief 输出网格检测结果到串口
+ */
+void goertzel_bank_output(const grid_result_t* result);
+
+/**
+ * @brief 根据网格检测结果配置DA输出
+ * @details 频率较低的分量输出到DA1，较高的输出到DA2，波形类型取检测结果。
+ * @return 1=已配置，0=结果无效未配置
+ */
+uint8_t configure_da_output_from_grid(const grid_result_t* result);
+
+#endif // __GOERTZEL_BANK_H__
@@ -3,9 +3,31 @@
 
 #include "bsp_system.h"
 #include "arm_math.h"
+#include "commond_init.h"
 
-#define FFT_LENGTH 1024
+#define FFT_LENGTH 1024     // 默认FFT长度
+#define FFT_MAX_LENGTH FIFO_SIZE // 支持的最大FFT长度，等于一次采集的点数，决定各缓冲区大小
+#define FFT_SCRATCH_COUNT 3 // 后台分析共用临时缓冲区的个数 (CLEAN分离需要3个)
 #define MAX_PEAKS 10  // 最大峰值数量
+#define SPECTRUM_START_BIN 5    // 寻峰和功率统计的起始bin，避开直流及其窗函数泄漏
+#define SPECTRUM_MIN_SEPARATION 10 // 两个峰值之间的最小间隔 (bin)
+#define SPECTRUM_LOBE_BINS 4    // 计算单个分量功率时包含的邻近bin数 (Hanning窗主瓣±2 bin及近端旁瓣)
+#define SPECTRUM_MAX_HARMONIC 10 // 计算THD时统计的最高谐波次数
+#define ZOOM_STEPS_PER_BIN 8    // 细化频谱每个FFT bin内的计算点数
+#define ZOOM_MIN_SEPARATION 2.0f // 细化频谱中可分辨的最小峰值间隔 (bin)，约为Hanning窗主瓣半宽
+#define ZOOM_MAX_POINTS (2 * SPECTRUM_MIN_SEPARATION * ZOOM_STEPS_PER_BIN + 1) // 细化频谱最大点数
+#define PEAK_SNAP_TOLERANCE_HZ 20.0f // 细化后的频率与1kHz整数倍相差小于该值时取整
+
+// 窗函数类型
+typedef enum {
+    WINDOW_RECT = 0,        // 矩形窗
+    WINDOW_HANNING,         // Hanning窗
+    WINDOW_HAMMING,         // Hamming窗
+    WINDOW_BLACKMAN,        // Blackman窗
+    WINDOW_BLACKMAN_HARRIS, // 4项Blackman-Harris窗，旁瓣低，适合小信号检测
+    WINDOW_FLATTOP,         // 平顶窗，幅度测量误差最小
+    WINDOW_TYPE_COUNT
+} window_type_t;
 
 // 峰值结构体
 typedef struct {
@@ -23,10 +45,36 @@ typedef struct {
     float freq_separation;   // 两个峰值的频率间隔
 } dual_peak_result_t;
 
-extern float fft_input_buffer[FFT_LENGTH * 2]; // 复数输入缓冲区
-extern float fft_magnitude[FFT_LENGTH];
-extern float window_buffer[FFT_LENGTH]; // 窗函数缓冲区
+// FFT上下文，保存运行时选择的FFT长度及对应的CMSIS实例
+typedef struct {
+    uint16_t length;                 // 当前FFT长度（点数）
+    arm_rfft_fast_instance_f32 rfft; // 对应长度的CMSIS实数FFT实例
+} fft_context_t;
+
+// 频谱特征记录，每次FFT后由一次遍历生成，所有分析和输出均读取此记录
+typedef struct {
+    peak_info_t peaks[MAX_PEAKS]; // 幅度最大的若干个峰值，按幅度降序
+    uint8_t peak_count;      // 有效峰值数量
+    uint8_t valid;           // 1=记录与当前频谱一致，0=频谱已更新需重新提取
+    float sampling_freq;     // 生成记录时的采样频率 (Hz)
+    float freq_resolution;   // 频率分辨率 (Hz)
+    float dc;                // 直流分量 (V)
+    float max_magnitude;     // 起始bin以上的最大幅度 (V)
+    float noise_floor;       // 噪底，噪声功率的单bin平均值对应的幅度 (V)
+    float thd;               // 总谐波失真 (%)
+    float snr;               // 信噪比 (dB)，不含谐波
+    float sinad;             // 信纳比 (dB)，噪声+谐波
+    float sfdr;              // 无杂散动态范围 (dBc)
+    float enob;              // 有效位数 (bit)
+} spectrum_features_t;
+
+extern fft_context_t fft_context;      // 当前FFT长度及对应的CMSIS实例
+extern float fft_spectrum_buffer[FFT_MAX_LENGTH]; // 实数FFT输出（打包格式的复数频谱）
+extern float fft_magnitude[FFT_MAX_LENGTH]; // 幅度谱，前N/2+1点有效
+extern float window_buffer[FFT_MAX_LENGTH]; // 窗函数缓冲区
+extern float fft_scratch[FFT_SCRATCH_COUNT][FFT_MAX_LENGTH]; // 后台分析共用的临时缓冲区，见 my_fft.c
 extern dual_peak_result_t dual_peaks;   // 双峰检测结果
+extern spectrum_features_t spectrum_features; // 频谱特征记录
 
 // 全局变量储存双峰检测结果
 extern float peak1_frequency;   // 第一个峰值的频率 (Hz)
@@ -35,17 +83,29 @@ extern float peak2_frequency;   // 第二个峰值的频率 (Hz)
 extern float peak2_magnitude;   // 第二个峰值的幅度 (V)
 
 void fft_init(void);
+uint8_t fft_set_length(uint16_t length);
+uint16_t fft_get_length(void);
 void calculate_fft_spectrum(float* input_data, uint16_t data_length);
 void output_fft_spectrum(void);
 void generate_hanning_window(void);
+void generate_window(window_type_t type, float* buffer, uint16_t length);
+uint8_t window_lobe_bins(window_type_t type);
 float get_precise_peak_frequency(float sampling_freq);
 float round_to_nearest_k(float frequency);
 float calculate_thd(float fundamental_freq, float sampling_freq);
 
+// 频谱特征提取
+void extract_spectrum_features(float sampling_freq);
+const spectrum_features_t* get_spectrum_features(float sampling_freq);
+void output_spectrum_features_hmi(void);
+
 // 新增寻峰功能函数
-uint8_t find_spectrum_peaks(peak_info_t* peaks, uint8_t max_peaks, float sampling_freq, float min_threshold);
-dual_peak_result_t find_dual_peaks(float sampling_freq, float min_threshold);
+uint8_t find_spectrum_peaks(peak_info_t* peaks, uint8_t max_peaks, float sampling_freq, float min_threshold,
+                            uint8_t psd_gate);
+dual_peak_result_t find_dual_peaks(float sampling_freq, float min_threshold, uint8_t psd_gate);
 float calculate_precise_frequency(uint16_t bin_index, float sampling_freq);
+uint16_t zoom_spectrum(float f_start, float f_stop, uint16_t points, float sampling_freq, float* magnitude);
+void zoom_refine_peak(peak_info_t* peak, float sampling_freq);
 void output_dual_peaks_info(void);
 void perform_dual_peak_analysis(float* input_data, uint16_t data_length);
 
@@ -57,5 +117,6 @@ float get_peak2_magnitude(void);
 
 // DA输出配置函数
 void configure_da_output_from_peaks(void);
+uint8_t configure_da_multitone_from_spectrum(uint8_t channel_index, uint16_t fundamental_bin);
 
 #endif /*__FFT_H*/
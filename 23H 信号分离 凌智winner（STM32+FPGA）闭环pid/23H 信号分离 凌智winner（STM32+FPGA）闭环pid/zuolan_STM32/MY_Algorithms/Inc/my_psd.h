@@ -0,0 +1,126 @@
+/**
+ * @file my_psd.h
+ * @brief Welch法功率谱密度(PSD)估计
+ * @details
+ * 将采集数据分成相互重叠的若干段，每段去直流、加窗后做实数FFT，
+ * 对各段的周期图进行线性或指数平均，得到方差更小的功率谱估计。
+ * 平均可以跨越多次采集连续进行，输出为校准后的单边PSD (V^2/Hz)。
+ * 在平均后的谱上按噪声统计分布设置检测门限，可用较低的门限稳定地检测小信号。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#ifndef __MY_PSD_H__
+#define __MY_PSD_H__
+
+#include "my_fft.h"
+
+#define PSD_MAX_SEGMENT FFT_MAX_LENGTH // 最大分段长度 (点)，分段缓冲区借用 fft_scratch
+#define PSD_DEFAULT_Z 3.7f   // 默认检测门限对应的标准正态分位数 (单bin虚警概率约1e-4)
+#define PSD_ANALYSIS_SEGMENT 512 // 双峰分析所用平均功率谱的分段长度 (点)
+#define PSD_ANALYSIS_ALPHA 0.25f // 双峰分析所用平均功率谱的指数平均权重，一帧(3段)后新数据占约58%
+
+/**
+ * @brief 平均方式
+ */
+typedef enum
+{
+    PSD_AVERAGE_LINEAR = 0, // 线性平均：所有段等权，段数越多方差越小
+    PSD_AVERAGE_EXPONENTIAL // 指数平均：新段权重为alpha，可跟踪缓慢变化的信号
+} psd_average_t;
+
+/**
+ * @brief PSD估计器状态
+ */
+typedef struct
+{
+    uint16_t segment_length;   // 分段长度 (点)
+    uint16_t segment_step;     // 相邻分段的起点间隔 (点)，= 分段长度 - 重叠点数
+    window_type_t window;      // 窗函数类型
+    psd_average_t average;     // 平均方式
+    float alpha;               // 指数平均的新段权重 (0~1)
+    float sampling_freq;       // 当前平均所对应的采样率 (Hz)
+    uint32_t segments;         // 已平均的分段数
+    float window_power;        // 窗函数平方和 S2 = sum(w^2)，用于PSD校准
+    arm_rfft_fast_instance_f32 rfft;
+    float window_buffer[PSD_MAX_SEGMENT];
+    float psd[PSD_MAX_SEGMENT / 2 + 1]; // 单边PSD (V^2/Hz)
+} psd_state_t;
+
+extern psd_state_t psd_state;
+
+/**
+ * @brief 配置PSD估计器并清空平均结果
+ * @param segment_length 分段长度，取 256/512/1024
+ * @param overlap 重叠比例 (0~0.9)，Hanning窗通常取0.5
+ * @param window 窗函数类型
+ * @param average 平均方式
+ * @param alpha 指数平均的新段权重 (0~1)，线性平均时忽略
+ * @return 1=成功，0=参数不支持
+ */
+uint8_t psd_init(uint16_t segment_length, float overlap, window_type_t window, psd_average_t average, float alpha);
+
+/**
+ * @brief 清空平均结果，保留配置
+ */
+void psd_reset(void);
+
+/**
+ * @brief 将一次采集的数据并入平均功率谱
+ * @details 采样率与已有结果不同时自动清空重新平均。
+ * @param data 时域数据 (V)
+ * @param length 数据长度，不小于分段长度
+ * @param sampling_freq 采样率 (Hz)
+ * @return 本次并入的分段数
+ */
+uint16_t psd_update(const float* data, uint16_t length, float sampling_freq);
+
+/**
+ * @brief 获取频率分辨率 (bin宽度, Hz)
+ */
+float psd_bin_width(void);
+
+/**
+ * @brief 计算频带内的均方根值
+ * @param f_low 频带下限 (Hz)
+ * @param f_high 频带上限 (Hz)
+ * @return 频带内信号的均方根值 (Vrms)
+ */
+float psd_band_rms(float f_low, float f_high);
+
+/**
+ * @brief 计算单个频谱分量的均方根值 (累加该bin两侧窗函数主瓣内的功率)
+ * @param bin 分量所在的bin
+ * @return 分量的均方根值 (Vrms)
+ */
+float psd_tone_rms(uint16_t bin);
+
+/**
+ * @brief 估计噪声底 (平均后每个bin的噪声PSD期望值)
+ * @details 以PSD的中位数估计，并按平均段数对应的分布换算为均值，少量信号分量不影响结果。
+ * @return 噪声PSD (V^2/Hz)
+ */
+float psd_noise_floor(void);
+
+/**
+ * @brief 计算给定虚警水平下的检测门限
+ * @details
+ * 平均K段后噪声bin的PSD服从自由度2K的卡方分布 (乘以噪底/2K)，
+ * 用Wilson-Hilferty近似求出分位数。平均段数越多，门限越接近噪底。
+ * @param z 标准正态分位数，越大虚警越少 (PSD_DEFAULT_Z 约对应单bin虚警概率1e-4)
+ * @return 门限 (V^2/Hz)
+ */
+float psd_detection_threshold(float z);
+
+/**
+ * @brief 在平均功率谱中寻找超过检测门限的峰值
+ * @details 峰值按幅度降序排列，magnitude 为扣除噪声后的正弦波峰值幅度 (V)，
+ *          precise_frequency 为插值后的频率。
+ * @param peaks 峰值数组
+ * @param max_peaks 最大峰值数量
+ * @param z 检测门限的正态分位数 (见 psd_detection_threshold)
+ * @return 找到的峰值数量
+ */
+uint8_t psd_find_peaks(peak_info_t* peaks, uint8_t max_peaks, float z);
+
+#endif // __MY_PSD_H__
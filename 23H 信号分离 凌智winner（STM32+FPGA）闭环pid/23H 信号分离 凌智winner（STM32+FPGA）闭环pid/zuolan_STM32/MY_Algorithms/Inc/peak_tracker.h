@@ -0,0 +1,78 @@
+/**
+ * @file peak_tracker.h
+ * @brief 多帧频谱峰值跟踪器
+ * @details
+ * 把连续多次频谱分析得到的峰值按频率关联成"轨迹"，每条轨迹用两个标量卡尔曼滤波器
+ * (kalman_state) 分别平滑频率和幅度，并管理轨迹的产生、确认和消亡：
+ * - 新峰值未能关联到已有轨迹时产生新轨迹；
+ * - 连续命中 TRACKER_CONFIRM_HITS 帧且置信度足够后确认为稳定轨迹；
+ * - 连续丢失超过 TRACKER_MAX_MISSES 帧或置信度过低时删除。
+ * 置信度为每帧是否命中的指数平均 (0~1)。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#ifndef __PEAK_TRACKER_H__
+#define __PEAK_TRACKER_H__
+
+#include "kalman.h"
+#include "my_fft.h"
+
+#define TRACKER_MAX_TRACKS 4      // 同时跟踪的最大轨迹数
+#define TRACKER_CONFIRM_HITS 3    // 确认轨迹所需的最少命中帧数
+#define TRACKER_MAX_MISSES 3      // 连续丢失超过该帧数后删除轨迹
+#define TRACKER_GATE_BINS 2.0f    // 关联门限 (FFT bin)，预测频率与测量频率之差超过此值不关联
+#define TRACKER_CONFIRM_LEVEL 0.6f // 确认轨迹所需的最低置信度
+#define TRACKER_DROP_LEVEL 0.15f   // 置信度低于此值时删除轨迹
+#define TRACKER_CONF_ALPHA 0.3f    // 置信度指数平均的系数
+
+/**
+ * @brief 单条峰值轨迹
+ */
+typedef struct
+{
+    uint8_t active;      // 1=轨迹存在
+    uint8_t confirmed;   // 1=已确认为稳定轨迹
+    uint8_t misses;      // 连续丢失帧数
+    uint16_t hits;       // 累计命中帧数
+    uint16_t id;         // 轨迹编号 (产生时分配，递增)
+    float confidence;    // 置信度 (0~1)
+    kalman_state freq;   // 频率滤波器，x为滤波后的频率 (Hz)
+    kalman_state amp;    // 幅度滤波器，x为滤波后的幅度 (V)
+} peak_track_t;
+
+extern peak_track_t peak_tracks[TRACKER_MAX_TRACKS];
+
+/**
+ * @brief 清除所有轨迹
+ */
+void peak_tracker_reset(void);
+
+/**
+ * @brief 用一帧频谱的峰值更新轨迹
+ * @details 频率分辨率变化 (采样率或FFT长度改变) 时自动清除旧轨迹。
+ * @param peaks 本帧峰值 (使用 precise_frequency 和 magnitude)
+ * @param count 峰值数量
+ * @param bin_width 本帧FFT的频率分辨率 (Hz)
+ * @return 当前已确认的轨迹数量
+ */
+uint8_t peak_tracker_update(const peak_info_t* peaks, uint8_t count, float bin_width);
+
+/**
+ * @brief 按幅度降序获取本帧命中的已确认轨迹 (丢失中的轨迹不输出)
+ * @param tracks 输出轨迹指针数组
+ * @param max_tracks 最多输出的轨迹数
+ * @return 输出的轨迹数量
+ */
+uint8_t peak_tracker_get_confirmed(const peak_track_t** tracks, uint8_t max_tracks);
+
+/**
+ * @brief 用已确认轨迹的滤波结果替换双峰检测结果
+ * @details 只有本帧命中的确认轨迹才替换与之关联的峰值，其余峰值保留原始检测结果；
+ *          输入信号改变后旧轨迹不再命中，结果立即跟随新的检测。替换后两个峰值仍按频率升序排列。
+ * @param result 双峰检测结果
+ * @return 1=已替换，0=未替换
+ */
+uint8_t peak_tracker_apply(dual_peak_result_t* result);
+
+#endif // __PEAK_TRACKER_H__
@@ -0,0 +1,97 @@
+/**
+ * @file pid_autotune.h
+ * @brief 继电反馈 (Astrom-Hagglund) PID自整定
+ * @details
+ * 自整定期间用继电器代替控制器：误差大于回差时输出 bias + d，小于负回差时输出 bias - d，
+ * 闭环在临界频率附近形成稳定的极限环。测量若干个完整振荡周期的平均周期 Tu 和输出半峰峰值 a，
+ * 由描述函数得到临界增益 Ku = 4d / (pi*a)，再按整定规则换算PID增益。
+ * 增益为离散形式 (每周期)，Tu 以控制周期数计，可直接用于 pid_ctrl_t。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#ifndef __PID_AUTOTUNE_H__
+#define __PID_AUTOTUNE_H__
+
+#include "pid_controller.h"
+
+#define AUTOTUNE_DEFAULT_CYCLES 4     // 默认参与平均的振荡周期数
+#define AUTOTUNE_SETTLE_CYCLES 1      // 开始测量前丢弃的振荡周期数 (过渡过程)
+#define AUTOTUNE_DEFAULT_TIMEOUT 5000 // 默认超时 (控制周期数)
+
+/**
+ * @brief 自整定状态
+ */
+typedef enum
+{
+    AUTOTUNE_IDLE = 0, // 未运行
+    AUTOTUNE_RUNNING,  // 继电实验进行中
+    AUTOTUNE_DONE,     // 完成，Ku/Tu有效
+    AUTOTUNE_FAILED    // 超时或未形成振荡
+} autotune_state_t;
+
+/**
+ * @brief 整定规则
+ */
+typedef enum
+{
+    AUTOTUNE_RULE_ZN_PI = 0,     // Ziegler-Nichols PI：Kp = 0.45Ku，Ti = Tu/1.2
+    AUTOTUNE_RULE_ZN_PID,        // Ziegler-Nichols PID：Kp = 0.6Ku，Ti = Tu/2，Td = Tu/8
+    AUTOTUNE_RULE_NO_OVERSHOOT   // 无超调PID：Kp = 0.2Ku，Ti = Tu/2，Td = Tu/3
+} autotune_rule_t;
+
+/**
+ * @brief 自整定器
+ */
+typedef struct
+{
+    // 参数
+    float setpoint;       // 设定值
+    float bias;           // 继电输出中心值
+    float amplitude;      // 继电输出幅度 d
+    float hysteresis;     // 回差 (与误差同单位)，应大于测量噪声
+    uint8_t cycles;       // 参与平均的振荡周期数
+    uint32_t timeout;     // 超时 (控制周期数)
+
+    // 状态
+    autotune_state_t state;
+    int8_t relay;         // 当前继电方向 (+1/-1)
+    uint32_t samples;     // 已运行的控制周期数
+    uint32_t last_rise;   // 上一次切换到正向输出时的周期数
+    uint8_t rises;        // 切换到正向输出的次数
+    float y_max;          // 本周期测量值最大值
+    float y_min;          // 本周期测量值最小值
+    float period_sum;     // 已测量周期之和
+    float swing_sum;      // 已测量半峰峰值之和
+    uint8_t measured;     // 已测量的周期数
+
+    // 结果
+    float ku;             // 临界增益
+    float tu;             // 临界周期 (控制周期数)
+} pid_autotune_t;
+
+/**
+ * @brief 开始继电实验
+ * @param tune 自整定器
+ * @param setpoint 设定值
+ * @param bias 继电输出中心值，通常取当前稳态输出
+ * @param amplitude 继电输出幅度
+ * @param hysteresis 回差
+ */
+void pid_autotune_start(pid_autotune_t* tune, float setpoint, float bias, float amplitude, float hysteresis);
+
+/**
+ * @brief 执行一个控制周期
+ * @param tune 自整定器
+ * @param measurement 测量值
+ * @return 本周期的继电输出，完成或失败后返回 bias
+ */
+float pid_autotune_update(pid_autotune_t* tune, float measurement);
+
+/**
+ * @brief 按整定规则计算离散PID增益
+ * @return 1=成功，0=自整定未完成
+ */
+uint8_t pid_autotune_gains(const pid_autotune_t* tune, autotune_rule_t rule, float* kp, float* ki, float* kd);
+
+#endif // __PID_AUTOTUNE_H__
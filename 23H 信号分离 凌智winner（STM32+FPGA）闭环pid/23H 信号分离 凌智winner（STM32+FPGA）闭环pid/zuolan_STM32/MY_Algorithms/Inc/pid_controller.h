@@ -0,0 +1,120 @@
+/**
+ * @file pid_controller.h
+ * @brief 定周期PID控制器 (位置式/增量式，浮点/Q31)
+ * @details
+ * 控制器按固定周期调用，增益均为离散形式 (每次调用)：
+ * - 位置式：u = Kp*e + I + D + ff，I += Ki*e；
+ * - 增量式：u += Kp*(e - e1) + Ki*e + (D - D1) + (ff - ff1)，以上一次限幅后的输出为基准，天然不会积分饱和；
+ * - 微分：D = D1 + alpha*(Kd*(e - e1) - D1)，alpha = 1 时不滤波，越小滤波越强；
+ * - 抗积分饱和：位置式按反计算法 I += Kt*(u - u_unsat)，另可对积分项单独限幅；
+ * - 输出先按每周期最大变化量 (slew) 限制，再按上下限限幅。
+ * 参数直接写结构体字段，pid_init() 给出不限幅、不滤波的默认值。
+ * Q31版本的信号归一化到 [-1, 1)，由浮点配置换算得到，只用整数乘加，适合在高频中断中运行。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#ifndef __PID_CONTROLLER_H__
+#define __PID_CONTROLLER_H__
+
+#include <stdint.h>
+#include "arm_math.h" // 不包含 bsp_system.h：app_pid.h 经由 bsp_system.h 包含本文件
+
+/**
+ * @brief 控制器形式
+ */
+typedef enum
+{
+    PID_FORM_POSITIONAL = 0, // 位置式：输出控制量
+    PID_FORM_INCREMENTAL     // 增量式：输出控制量的累加
+} pid_form_t;
+
+/**
+ * @brief 浮点PID控制器
+ */
+typedef struct
+{
+    // 参数
+    pid_form_t form;      // 控制器形式
+    float kp;             // 比例增益
+    float ki;             // 积分增益 (每周期)
+    float kd;             // 微分增益 (每周期)
+    float d_alpha;        // 微分滤波系数 (0~1]，1=不滤波
+    float kt;             // 反计算抗饱和增益 (0=不使用，仅位置式)
+    float integral_limit; // 积分项限幅 (0=不限，仅位置式)
+    float out_min;        // 输出下限
+    float out_max;        // 输出上限
+    float slew;           // 每周期输出最大变化量 (0=不限)
+
+    // 状态
+    float integral;       // 积分项
+    float derivative;     // 滤波后的微分项
+    float prev_error;     // e[k-1]
+    float feedforward;    // 上一周期的前馈量 (增量式)
+    float output;         // 上一周期的输出
+} pid_ctrl_t;
+
+/**
+ * @brief Q31 PID控制器
+ * @details 增益 = k * 2^shift / 2^31，shift 由 pid_init_q31() 按最大增益选定。
+ */
+typedef struct
+{
+    pid_form_t form;
+    uint8_t shift;        // 增益的左移位数
+    q31_t kp;
+    q31_t ki;
+    q31_t kd;
+    q31_t kt;
+    q31_t d_alpha;        // 微分滤波系数 (Q31，不移位)
+    q31_t integral_limit; // 0=不限
+    q31_t out_min;
+    q31_t out_max;
+    q31_t slew;           // 0=不限
+
+    q31_t integral;
+    q31_t derivative;
+    q31_t prev_error;
+    q31_t feedforward;
+    q31_t output;
+} pid_ctrl_q31_t;
+
+/**
+ * @brief 初始化浮点控制器
+ * @details 不限幅、不限速率、不滤波、不使用反计算，状态清零。其余参数初始化后直接修改字段。
+ */
+void pid_init(pid_ctrl_t* pid, pid_form_t form, float kp, float ki, float kd);
+
+/**
+ * @brief 清除状态，输出和积分项 (位置式) 预置为指定值，用于无扰切换
+ */
+void pid_reset(pid_ctrl_t* pid, float output);
+
+/**
+ * @brief 执行一个控制周期
+ * @param setpoint 设定值
+ * @param measurement 测量值
+ * @param feedforward 前馈量，直接叠加到输出
+ * @return 限幅后的输出
+ */
+float pid_update(pid_ctrl_t* pid, float setpoint, float measurement, float feedforward);
+
+/**
+ * @brief 由浮点配置初始化Q31控制器
+ * @details 信号按 [-1, 1) 归一化，限幅、slew 超出范围时饱和；增益最大可到 2^31。
+ * @param pid Q31控制器
+ * @param config 浮点控制器 (只使用参数字段)
+ */
+void pid_init_q31(pid_ctrl_q31_t* pid, const pid_ctrl_t* config);
+
+/**
+ * @brief 清除Q31控制器状态，输出和积分项预置为指定值
+ */
+void pid_reset_q31(pid_ctrl_q31_t* pid, q31_t output);
+
+/**
+ * @brief 执行一个Q31控制周期
+ */
+q31_t pid_update_q31(pid_ctrl_q31_t* pid, q31_t setpoint, q31_t measurement, q31_t feedforward);
+
+#endif // __PID_CONTROLLER_H__
@@ -0,0 +1,81 @@
+/**
+ * @file sine_fit.h
+ * @brief 正弦波最小二乘拟合 (IEEE 1057 三参数/四参数法)
+ * @details
+ * 以已知 (或粗略估计的) 频率为初值，在时域上直接拟合 y(n) = a*cos(w*n) + b*sin(w*n) + c：
+ * - 三参数法：频率已知，一次求解3x3正规方程得到幅度、相位和直流偏置；
+ * - 四参数法：在三参数结果上把频率修正量线性化为第四个参数，迭代求解直至收敛；
+ * - 双音法：两个频率均已知，一次求解5x5正规方程得到两个分量各自的幅度和相位。
+ * 不需要加窗，也不要求整周期或2的幂长度，几百个样本即可得到准确的幅度和相位，
+ * 适合记录较短、需要较高循环速率的相位测量。正规方程各项用CMSIS-DSP点积计算。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#ifndef __SINE_FIT_H__
+#define __SINE_FIT_H__
+
+#include "bsp_system.h"
+
+#define SINE_FIT_MAX_LENGTH 1024    // 最大拟合样本数
+#define SINE_FIT_MIN_LENGTH 16      // 最少拟合样本数
+#define SINE_FIT_MAX_ITERATIONS 8   // 四参数法最大迭代次数
+#define SINE_FIT_TOLERANCE 1e-4f    // 四参数法收敛门限：频率修正量小于该值 (bin，以记录长度计)
+
+/**
+ * @brief 拟合结果
+ * @details 拟合模型为 y(n) = amplitude * sin(2*pi*frequency*n/fs + phase) + offset，以第一个样本为零时刻。
+ */
+typedef struct
+{
+    float frequency;    // 频率 (Hz)，三参数法即为输入频率
+    float amplitude;    // 峰值幅度 (V)
+    float phase;        // 初相 (rad，正弦参考，-pi~pi)
+    float offset;       // 直流偏置 (V)
+    float residual_rms; // 拟合残差的均方根值 (V)
+    uint8_t iterations; // 四参数法实际迭代次数
+    uint8_t converged;  // 四参数法是否收敛
+} sine_fit_result_t;
+
+/**
+ * @brief 三参数正弦拟合 (频率已知)
+ * @param data 时域数据 (V)
+ * @param length 数据长度 (SINE_FIT_MIN_LENGTH ~ SINE_FIT_MAX_LENGTH)
+ * @param sampling_freq 采样率 (Hz)
+ * @param frequency 信号频率 (Hz)
+ * @param result 输出拟合结果
+ * @return 1=成功，0=参数无效或正规方程奇异
+ */
+uint8_t sine_fit_3param(const float* data, uint16_t length, float sampling_freq, float frequency,
+                        sine_fit_result_t* result);
+
+/**
+ * @brief 四参数正弦拟合 (同时估计频率)
+ * @details 频率初值误差应小于约半个bin (fs/length)，否则可能收敛到错误的频率或发散。
+ * @param data 时域数据 (V)
+ * @param length 数据长度 (SINE_FIT_MIN_LENGTH ~ SINE_FIT_MAX_LENGTH)
+ * @param sampling_freq 采样率 (Hz)
+ * @param frequency 频率初值 (Hz)
+ * @param result 输出拟合结果，未收敛时为最后一次迭代的结果
+ * @return 1=成功，0=参数无效、正规方程奇异或频率超出 (0, fs/2)
+ */
+uint8_t sine_fit_4param(const float* data, uint16_t length, float sampling_freq, float frequency,
+                        sine_fit_result_t* result);
+
+/**
+ * @brief 双音正弦拟合 (两个频率均已知)
+ * @details
+ * 联合拟合 y(n) = A1*sin(w1*n + phi1) + A2*sin(w2*n + phi2) + c，两个分量互不泄漏，
+ * 适合从混合信号中同时测量两个分量的相位。两频率之差应大于约 fs/length。
+ * @param data 时域数据 (V)
+ * @param length 数据长度 (SINE_FIT_MIN_LENGTH ~ SINE_FIT_MAX_LENGTH)
+ * @param sampling_freq 采样率 (Hz)
+ * @param frequency1 第一个分量的频率 (Hz)
+ * @param frequency2 第二个分量的频率 (Hz)
+ * @param result 输出两个分量的拟合结果，偏置和残差两者相同
+ * @return 1=成功，0=参数无效或正规方程奇异
+ */
+uint8_t sine_fit_2tone(const float* data, uint16_t length, float sampling_freq, float frequency1, float frequency2,
+                       sine_fit_result_t result[2]);
+
+#endif // __SINE_FIT_H__
@@ -0,0 +1,69 @@
+/**
+ * @file waveform_classifier.h
+ * @brief 基于谐波特征的波形分类器
+ * @details
+ * 对每个已分离的基波，测量其2~7次谐波相对基波的幅度比和相位 (以正弦为参考，换算到基波初相为0)，
+ * 与各波形的傅里叶级数模板比较，取距离最小者：
+ * - 正弦波：无谐波；
+ * - 三角波：奇次谐波 1/n^2，符号 +,-,+,... (3次为负，5次为正，7次为负)；
+ * - 方波：  奇次谐波 1/n，符号全正；
+ * - 锯齿波：全部谐波 1/n，上升沿为 +,-,+,... 交替，下降沿全正。
+ * 两个分量的谐波碰撞时 (如B的频率是A的3倍)，按对方已判定的模板扣除其在重合频点上的贡献，
+ * 频率相近但不重合、无法扣除的谐波不参与比较；两个分量交替判定几轮直至稳定。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#ifndef __WAVEFORM_CLASSIFIER_H__
+#define __WAVEFORM_CLASSIFIER_H__
+
+#include "bsp_system.h"
+#include "da_output.h"
+
+#define WAVE_CLASS_MAX_HARMONIC 7   // 参与比较的最高谐波次数
+#define WAVE_CLASS_MAX_COMPONENTS 2 // 同时分类的最大分量数
+#define WAVE_CLASS_COLLISION_BINS 2.0f // 两个频率相距小于该值 (Hanning窗bin) 时视为碰撞
+
+/**
+ * @brief 单个分量的分类结果
+ */
+typedef struct
+{
+    Waveform_t waveform;                          // 判定的波形类型
+    uint8_t shape;                                // 匹配的模板 (区分锯齿波的上升沿/下降沿)，供 waveform_class_coefficient() 使用
+    float distance;                               // 与最佳模板的距离 (复数比值差的平方和)
+    float magnitude;                              // 扣除其他分量谐波后的基波幅度 (V)
+    float ratio[WAVE_CLASS_MAX_HARMONIC + 1];     // 各次谐波与基波的幅度比，下标为谐波次数
+    float phase[WAVE_CLASS_MAX_HARMONIC + 1];     // 各次谐波的相对相位 (度，正弦参考)
+    uint8_t usable;                               // 参与比较的谐波位图，bit n 对应n次谐波
+} waveform_class_t;
+
+/**
+ * @brief 对已分离的分量进行波形分类
+ * @details 一次遍历样本，同时计算所有分量全部谐波处的加Hanning窗DTFT。
+ * @param data 时域数据 (V)
+ * @param length 数据长度
+ * @param sampling_freq 采样率 (Hz)
+ * @param frequencies 各分量基波频率 (Hz)，不大于0的分量判为正弦波
+ * @param count 分量数，不超过 WAVE_CLASS_MAX_COMPONENTS
+ * @param results 输出分类结果
+ * @return 完成分类的分量数
+ */
+uint8_t classify_waveforms(const float* data, uint16_t length, float sampling_freq,
+                           const float* frequencies, uint8_t count, waveform_class_t* results);
+
+/**
+ * @brief 获取分类结果所匹配模板的n次谐波系数
+ * @details 波形为 sum(c_n * sin(n*theta))，c_1 = 1，可用于按判定的波形重建分量。
+ * @param result 分类结果
+ * @param n 谐波次数
+ * @return 谐波系数 (相对基波，正弦参考)
+ */
+float waveform_class_coefficient(const waveform_class_t* result, uint8_t n);
+
+/**
+ * @brief 波形类型名称
+ */
+const char* waveform_name(Waveform_t waveform);
+
+#endif // __WAVEFORM_CLASSIFIER_H__
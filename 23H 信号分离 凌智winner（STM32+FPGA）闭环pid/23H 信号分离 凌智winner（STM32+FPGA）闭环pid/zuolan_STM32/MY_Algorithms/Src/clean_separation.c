@@ -0,0 +1,427 @@
+/**
+ * @file clean_separation.c
+ * @brief 逐个扣除、重新估计 (CLEAN) 的分量分离实现
+ * @details
+ * 1. 频率：残差加Hanning窗后做实数FFT，在幅度谱最大值处用Hanning窗两点插值
+ *    delta = (2r - 1) / (1 + r)，r 为较大邻点与峰值之比，对单音无偏。
+ * 2. 幅度/相位：在 cos(w*n)、sin(w*n) 两个基向量上做最小二乘拟合 (2x2正规方程)，
+ *    非整周期记录下两个基向量不正交，正规方程仍给出准确结果。
+ * 3. 重建：x(n) = A * sum(c_h * sin(h*(w*n + phi)))，c_h 取自波形分类结果，
+ *    超过Nyquist频率的谐波不重建。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#include "clean_separation.h"
+#include <math.h>
+
+#define CLEAN_REFINE_BINS 2 // 细化阶段在原频率两侧搜索峰值的范围 (bin)
+
+// 残差、FFT输入/幅度谱、FFT输出，拟合时后两者兼作基向量缓冲区 (借用 fft_scratch，只在 clean_separate() 内有效)
+static float* const clean_residual = fft_scratch[0];
+static float* const clean_work = fft_scratch[1];
+static float* const clean_spectrum = fft_scratch[2];
+static float clean_window[CLEAN_MAX_LENGTH];
+
+static arm_rfft_fast_instance_f32 clean_rfft;
+static uint16_t clean_length = 0; // 当前FFT实例和窗函数对应的长度
+static float clean_fs = 0.0f;
+
+/**
+ * @brief 准备指定长度的FFT实例和窗函数
+ */
+static uint8_t clean_prepare(uint16_t length)
+{
+    if(length == clean_length)
+    {
+        return 1;
+    }
+    if(arm_rfft_fast_init_f32(&clean_rfft, length) != ARM_MATH_SUCCESS)
+    {
+        return 0;
+    }
+
+    generate_window(WINDOW_HANNING, clean_window, length);
+    clean_length = length;
+    return 1;
+}
+
+/**
+ * @brief 计算残差的加窗幅度谱，结果存于 clean_work[0..N/2-1] (未归一化)
+ */
+static void clean_residual_spectrum(void)
+{
+    arm_mult_f32(clean_residual, clean_window, clean_work, clean_length);
+    arm_rfft_fast_f32(&clean_rfft, clean_work, clean_spectrum, 0);
+    arm_cmplx_mag_f32(clean_spectrum, clean_work, clean_length / 2);
+    clean_work[0] = 0.0f; // 打包的直流和Nyquist分量，不参与寻峰
+}
+
+/**
+ * @brief 在幅度谱的指定范围内寻找最大值并插值
+ * @return 插值后的bin位置 (可为小数)，范围无效时返回-1
+ */
+static float clean_find_peak(int32_t lo, int32_t hi)
+{
+    float value;
+    uint32_t index;
+
+    if(lo < 1) lo = 1;
+    if(hi > clean_length / 2 - 2) hi = clean_length / 2 - 2;
+    if(hi < lo)
+    {
+        return -1.0f;
+    }
+
+    arm_max_f32(&clean_work[lo], hi - lo + 1, &value, &index);
+    uint16_t k = lo + index;
+    if(value <= 0.0f)
+    {
+        return -1.0f;
+    }
+
+    float left = clean_work[k - 1];
+    float right = clean_work[k + 1];
+    float delta;
+    if(right > left)
+    {
+        float r = right / value;
+        delta = (2.0f * r - 1.0f) / (1.0f + r);
+    }
+    else
+    {
+        float r = left / value;
+        delta = -(2.0f * r - 1.0f) / (1.0f + r);
+    }
+    if(delta > 0.5f) delta = 0.5f;
+    if(delta < -0.5f) delta = -0.5f;
+
+    return k + delta;
+}
+
+/**
+ * @brief 在残差上用最小二乘拟合指定频率的正弦分量
+ * @param frequency 频率 (Hz)
+ * @param amplitude 输出峰值幅度 (V)
+ * @param phase 输出初相 (rad，正弦参考)
+ */
+static void clean_fit(float frequency, float* amplitude, float* phase)
+{
+    float cycles = frequency / clean_fs;
+
+    for(uint16_t n = 0; n < clean_length; n++)
+    {
+        float t = cycles * n;
+        float angle = 2.0f * PI * (t - floorf(t));
+        clean_work[n] = arm_cos_f32(angle);
+        clean_spectrum[n] = arm_sin_f32(angle);
+    }
+
+    float rc, rs, cc, ss, cs;
+    arm_dot_prod_f32(clean_residual, clean_work, clean_length, &rc);
+    arm_dot_prod_f32(clean_residual, clean_spectrum, clean_length, &rs);
+    arm_dot_prod_f32(clean_work, clean_work, clean_length, &cc);
+    arm_dot_prod_f32(clean_spectrum, clean_spectrum, clean_length, &ss);
+    arm_dot_prod_f32(clean_work, clean_spectrum, clean_length, &cs);
+
+    // [cc cs; cs ss] * [a; b] = [rc; rs]，分量为 a*cos + b*sin = A*sin(w*n + phi)
+    float det = cc * ss - cs * cs;
+    float a = 0.0f;
+    float b = 0.0f;
+    if(fabsf(det) > 1e-12f)
+    {
+        a = (rc * ss - rs * cs) / det;
+        b = (rs * cc - rc * cs) / det;
+    }
+
+    *amplitude = sqrtf(a * a + b * b);
+    *phase = atan2f(a, b);
+}
+
+/**
+ * @brief 从残差中扣除分量的重建波形
+ * @param comp 分量
+ * @param first_harmonic 从第几次谐波开始扣除 (1=完整波形，2=只扣除谐波)
+ */
+static void clean_subtract(const clean_component_t* comp, uint8_t first_harmonic)
+{
+    float cycles = comp->frequency / clean_fs;
+    uint8_t harmonics = 0;
+
+    arm_fill_f32(0.0f, clean_work, clean_length);
+    for(uint8_t h = first_harmonic; h <= WAVE_CLASS_MAX_HARMONIC; h++)
+    {
+        float c = waveform_class_coefficient(&comp->shape, h);
+        if(c == 0.0f)
+        {
+            continue;
+        }
+        if(h * comp->frequency >= 0.5f * clean_fs)
+        {
+            break;
+        }
+
+        float scale = c * comp->amplitude;
+        float offset = h * comp->phase;
+        for(uint16_t n = 0; n < clean_length; n++)
+        {
+            float t = h * cycles * n;
+            clean_work[n] += scale * arm_sin_f32(2.0f * PI * (t - floorf(t)) + offset);
+        }
+        harmonics++;
+    }
+
+    if(harmonics > 0)
+    {
+        arm_sub_f32(clean_residual, clean_work, clean_residual, clean_length);
+    }
+}
+
+/**
+ * @brief 判断频率是否是已有分量的残留或谐波
+ * @return 0=与已有分量无关，1=已有分量基波的残留，h>=2=已有分量的h次谐波
+ */
+static uint8_t clean_relation(const clean_result_t* result, float frequency, float bin_width, uint8_t* owner)
+{
+    for(uint8_t i = 0; i < result->count; i++)
+    {
+        const clean_component_t* comp = &result->components[i];
+        uint8_t h = (uint8_t)(frequency / comp->frequency + 0.5f);
+        if(h > 0 && fabsf(frequency - h * comp->frequency) < CLEAN_MERGE_BINS * bin_width)
+        {
+            *owner = i;
+            return h;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief 检验落在已有分量谐波上的峰值是否包含另一个分量
+ * @details 以 (已有分量, 候选频率) 两个分量调用 classify_waveforms()：已有分量的波形由其余谐波判定，
+ *          候选频点扣除该波形预测的谐波后剩余的幅度即为另一个分量的幅度。
+ * @return 剩余幅度与已有分量基波幅度之比
+ */
+static float clean_candidate_ratio(const float* data, const clean_component_t* owner, float frequency)
+{
+    float frequencies[2] = {owner->frequency, frequency};
+    waveform_class_t shapes[2];
+
+    classify_waveforms(data, clean_length, clean_fs, frequencies, 2, shapes);
+    if(shapes[0].magnitude <= 0.0f)
+    {
+        return 0.0f;
+    }
+
+    return shapes[1].magnitude / shapes[0].magnitude;
+}
+
+/**
+ * @brief 用全部分量的当前估计对原始数据重新分类波形
+ */
+static void clean_classify(const float* data, clean_result_t* result)
+{
+    float frequencies[CLEAN_MAX_COMPONENTS];
+    waveform_class_t shapes[CLEAN_MAX_COMPONENTS];
+
+    for(uint8_t i = 0; i < result->count; i++)
+    {
+        frequencies[i] = result->components[i].frequency;
+    }
+    classify_waveforms(data, clean_length, clean_fs, frequencies, result->count, shapes);
+    for(uint8_t i = 0; i < result->count; i++)
+    {
+        result->components[i].shape = shapes[i];
+    }
+}
+
+uint8_t clean_separate(const float* data, uint16_t length, float sampling_freq, float min_threshold,
+                       clean_result_t* result)
+{
+    memset(result, 0, sizeof(clean_result_t));
+    if(data == NULL || sampling_freq <= 0.0f || length < CLEAN_MIN_LENGTH)
+    {
+        return 0;
+    }
+
+    // 取不超过数据长度的最大2的幂
+    uint16_t n = CLEAN_MAX_LENGTH;
+    while(n > length)
+    {
+        n >>= 1;
+    }
+    if(!clean_prepare(n))
+    {
+        return 0;
+    }
+    clean_fs = sampling_freq;
+    result->length = n;
+
+    float bin_width = sampling_freq / n;
+    float mean;
+    arm_mean_f32(data, n, &mean);
+    arm_offset_f32(data, -mean, clean_residual, n);
+    arm_rms_f32(clean_residual, n, &result->signal_rms);
+
+    // 检测：逐个扣除最强峰值
+    float reference = 0.0f;
+    float candidate_freq[CLEAN_MAX_ITERATIONS];
+    uint8_t candidate_owner[CLEAN_MAX_ITERATIONS];
+    uint8_t candidates = 0;
+    while(result->iterations < CLEAN_MAX_ITERATIONS && result->count < CLEAN_MAX_COMPONENTS)
+    {
+        clean_residual_spectrum();
+        float bin_pos = clean_find_peak(SPECTRUM_START_BIN, n / 2);
+        if(bin_pos < 0.0f)
+        {
+            break;
+        }
+
+        clean_component_t peak;
+        memset(&peak, 0, sizeof(peak));
+        peak.frequency = bin_pos * bin_width;
+        clean_fit(peak.frequency, &peak.amplitude, &peak.phase);
+        if(result->count > 0 && peak.amplitude < min_threshold * reference)
+        {
+            break;
+        }
+
+        uint8_t owner = 0;
+        uint8_t relation = clean_relation(result, peak.frequency, bin_width, &owner);
+        clean_subtract(&peak, 1); // 分类结果清零即正弦模板，只扣除该峰值本身
+        result->iterations++;
+
+        if(relation == 0)
+        {
+            if(result->count == 0)
+            {
+                reference = peak.amplitude;
+            }
+            result->components[result->count++] = peak;
+        }
+        else if(relation >= 2 && candidates < CLEAN_MAX_ITERATIONS)
+        {
+            // 谐波上可能还叠加着另一个分量，检测结束后再判断
+            candidate_freq[candidates] = peak.frequency;
+            candidate_owner[candidates] = owner;
+            candidates++;
+        }
+    }
+
+    if(result->count == 0)
+    {
+        return 0;
+    }
+
+    // 分量数不足时，在谐波候选中找扣除谐波后剩余幅度最大且超过阈值的一个
+    if(result->count < CLEAN_MAX_COMPONENTS && candidates > 0)
+    {
+        float best_ratio = 0.0f;
+        uint8_t best = 0;
+        for(uint8_t c = 0; c < candidates; c++)
+        {
+            float ratio = clean_candidate_ratio(data, &result->components[candidate_owner[c]], candidate_freq[c]);
+            if(ratio > best_ratio)
+            {
+                best_ratio = ratio;
+                best = c;
+            }
+        }
+
+        const clean_component_t* owner = &result->components[candidate_owner[best]];
+        if(best_ratio * owner->amplitude >= min_threshold * reference)
+        {
+            // 按已有分量的完整波形扣除后拟合新分量的幅度和相位
+            clean_component_t* comp = &result->components[result->count++];
+            memset(comp, 0, sizeof(clean_component_t));
+            comp->frequency = candidate_freq[best];
+            clean_classify(data, result);
+            arm_offset_f32(data, -mean, clean_residual, n);
+            clean_subtract(owner, 1);
+            clean_fit(comp->frequency, &comp->amplitude, &comp->phase);
+        }
+    }
+
+    // 细化：每个分量在扣除其他分量 (完整波形) 和自身谐波后的数据上重新估计
+    clean_classify(data, result);
+    for(uint8_t sweep = 0; sweep < CLEAN_REFINE_SWEEPS; sweep++)
+    {
+        for(uint8_t i = 0; i < result->count; i++)
+        {
+            clean_component_t* comp = &result->components[i];
+
+            arm_offset_f32(data, -mean, clean_residual, n);
+            for(uint8_t j = 0; j < result->count; j++)
+            {
+                clean_subtract(&result->components[j], (j == i) ? 2 : 1);
+            }
+
+            clean_residual_spectrum();
+            int32_t center = (int32_t)(comp->frequency / bin_width + 0.5f);
+            float bin_pos = clean_find_peak(center - CLEAN_REFINE_BINS, center + CLEAN_REFINE_BINS);
+            if(bin_pos > 0.0f)
+            {
+                comp->frequency = bin_pos * bin_width;
+            }
+            clean_fit(comp->frequency, &comp->amplitude, &comp->phase);
+        }
+        clean_classify(data, result);
+    }
+
+    // 残差
+    arm_offset_f32(data, -mean, clean_residual, n);
+    for(uint8_t j = 0; j < result->count; j++)
+    {
+        clean_subtract(&result->components[j], 1);
+    }
+    arm_rms_f32(clean_residual, n, &result->residual_rms);
+
+    // 按幅度降序
+    if(result->count == 2 && result->components[0].amplitude < result->components[1].amplitude)
+    {
+        clean_component_t temp = result->components[0];
+        result->components[0] = result->components[1];
+        result->components[1] = temp;
+    }
+
+    return result->count;
+}
+
+/**
+ * @brief 由分量生成峰值信息
+ */
+static void clean_to_peak(const clean_component_t* comp, float fft_bin_width, peak_info_t* peak)
+{
+    peak->precise_frequency = comp->frequency;
+    peak->magnitude = comp->amplitude;
+    peak->bin_index = (uint16_t)(comp->frequency / fft_bin_width + 0.5f);
+    peak->frequency = peak->bin_index * fft_bin_width;
+}
+
+void clean_to_dual_peaks(const clean_result_t* result, float sampling_freq, dual_peak_result_t* peaks)
+{
+    float fft_bin_width = sampling_freq / fft_context.length;
+
+    memset(peaks, 0, sizeof(dual_peak_result_t));
+    peaks->peaks_found = result->count;
+    if(result->count == 0)
+    {
+        return;
+    }
+
+    clean_to_peak(&result->components[0], fft_bin_width, &peaks->peak1);
+    if(result->count >= 2)
+    {
+        clean_to_peak(&result->components[1], fft_bin_width, &peaks->peak2);
+        peaks->freq_separation = fabsf(peaks->peak1.precise_frequency - peaks->peak2.precise_frequency);
+
+        // 保持peak1的频率小于peak2
+        if(peaks->peak1.precise_frequency > peaks->peak2.precise_frequency)
+        {
+            peak_info_t temp = peaks->peak1;
+            peaks->peak1 = peaks->peak2;
+            peaks->peak2 = temp;
+        }
+    }
+}
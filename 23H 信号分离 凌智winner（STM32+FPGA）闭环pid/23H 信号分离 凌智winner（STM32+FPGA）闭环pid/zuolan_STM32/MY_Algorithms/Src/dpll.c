@@ -0,0 +1,91 @@
+/**
+ * @file dpll.c
+ * @brief 二阶数字锁相环实现
+ * @details
+ * 环路滤波器即位置式 pid_ctrl_t (Kd = 0)，积分项和输出都限制在 ±max_offset 内，
+ * 输出被限幅时按反计算回退积分项，捕获范围外的大误差不会使积分项饱和。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#include "dpll.h"
+#include <math.h>
+
+/**
+ * @brief 由带宽、阻尼和周期计算PI增益
+ */
+static void dpll_design(dpll_t* dpll)
+{
+    float wn = 2.0f * dpll->bandwidth / (dpll->damping + 0.25f / dpll->damping);
+
+    dpll->filter.kp = 2.0f * dpll->damping * wn / (2.0f * PI);
+    dpll->filter.ki = wn * wn * dpll->period / (2.0f * PI);
+}
+
+void dpll_init(dpll_t* dpll, float center, float bandwidth, float damping, float period, float max_offset)
+{
+    dpll->center = center;
+    dpll->bandwidth = bandwidth;
+    dpll->damping = (damping > 0.0f) ? damping : DPLL_DEFAULT_DAMPING;
+    dpll->period = period;
+    dpll->max_offset = max_offset;
+
+    pid_init(&dpll->filter, PID_FORM_POSITIONAL, 0.0f, 0.0f, 0.0f);
+    dpll->filter.kt = 1.0f;
+    dpll->filter.integral_limit = max_offset;
+    dpll->filter.out_min = -max_offset;
+    dpll->filter.out_max = max_offset;
+    dpll_design(dpll);
+    pid_reset(&dpll->filter, 0.0f);
+
+    dpll->frequency = center;
+    dpll->error_power = DPLL_UNLOCK_THRESHOLD * DPLL_UNLOCK_THRESHOLD; // 从失锁状态开始
+    dpll->locked = 0;
+    dpll->lock_count = 0;
+    dpll->elapsed = 0.0f;
+    dpll->lock_time = 0.0f;
+    dpll->jitter = 0.0f;
+}
+
+void dpll_set_period(dpll_t* dpll, float period)
+{
+    if(period > 0.0f)
+    {
+        dpll->period = period;
+        dpll_design(dpll);
+    }
+}
+
+float dpll_update(dpll_t* dpll, float phase_error)
+{
+    dpll->frequency = dpll->center + pid_update(&dpll->filter, phase_error, 0.0f, 0.0f);
+
+    // 锁定检测
+    dpll->error_power += DPLL_ERROR_ALPHA * (phase_error * phase_error - dpll->error_power);
+    dpll->jitter = sqrtf(dpll->error_power);
+    dpll->elapsed += dpll->period;
+
+    if(dpll->locked)
+    {
+        if(dpll->jitter > DPLL_UNLOCK_THRESHOLD)
+        {
+            dpll->locked = 0;
+            dpll->lock_count = 0;
+            dpll->elapsed = 0.0f;
+        }
+    }
+    else if(dpll->jitter < DPLL_LOCK_THRESHOLD)
+    {
+        if(++dpll->lock_count >= DPLL_LOCK_COUNT)
+        {
+            dpll->locked = 1;
+            dpll->lock_time = dpll->elapsed;
+        }
+    }
+    else
+    {
+        dpll->lock_count = 0;
+    }
+
+    return dpll->frequency;
+}
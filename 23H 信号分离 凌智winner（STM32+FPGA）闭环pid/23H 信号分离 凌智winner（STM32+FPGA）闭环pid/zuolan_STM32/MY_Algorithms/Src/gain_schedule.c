@@ -0,0 +1,117 @@
+/**
+ * @file gain_schedule.c
+ * @brief 增益调度实现
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#include "gain_schedule.h"
+#include <string.h>
+
+uint8_t gain_schedule_init(gain_schedule_t* schedule, const gain_point_t* points, uint8_t count)
+{
+    if(count == 0 || count > GAIN_SCHEDULE_MAX_POINTS)
+    {
+        return 0;
+    }
+    for(uint8_t i = 1; i < count; i++)
+    {
+        if(points[i].frequency <= points[i - 1].frequency)
+        {
+            return 0;
+        }
+    }
+
+    memcpy(schedule->points, points, count * sizeof(gain_point_t));
+    schedule->count = count;
+    schedule->band = 0;
+    return 1;
+}
+
+uint8_t gain_schedule_band(const gain_schedule_t* schedule, float frequency)
+{
+    uint8_t band = 0;
+
+    // 以相邻工作点的中点为频段分界
+    while(band + 1 < schedule->count &&
+          frequency > 0.5f * (schedule->points[band].frequency + schedule->points[band + 1].frequency))
+    {
+        band++;
+    }
+    return band;
+}
+
+void gain_schedule_lookup(const gain_schedule_t* schedule, float frequency, gain_point_t* point)
+{
+    const gain_point_t* p = schedule->points;
+    uint8_t last = schedule->count - 1;
+
+    if(frequency <= p[0].frequency || last == 0)
+    {
+        *point = p[0];
+    }
+    else if(frequency >= p[last].frequency)
+    {
+        *point = p[last];
+    }
+    else
+    {
+        uint8_t i = 0;
+        while(frequency > p[i + 1].frequency)
+        {
+            i++;
+        }
+
+        float t = (frequency - p[i].frequency) / (p[i + 1].frequency - p[i].frequency);
+        point->kp = p[i].kp + t * (p[i + 1].kp - p[i].kp);
+        point->ki = p[i].ki + t * (p[i + 1].ki - p[i].ki);
+        point->kd = p[i].kd + t * (p[i + 1].kd - p[i].kd);
+        point->limit = p[i].limit + t * (p[i + 1].limit - p[i].limit);
+    }
+    point->frequency = frequency;
+}
+
+uint8_t gain_schedule_apply(gain_schedule_t* schedule, pid_ctrl_t* pid, float frequency, float blend)
+{
+    gain_point_t target;
+    uint8_t band = gain_schedule_band(schedule, frequency);
+    uint8_t changed = (band != schedule->band);
+
+    gain_schedule_lookup(schedule, frequency, &target);
+    schedule->band = band;
+
+    float kp = pid->kp + blend * (target.kp - pid->kp);
+    float kd = pid->kd + blend * (target.kd - pid->kd);
+    float limit = pid->out_max + blend * (target.limit - pid->out_max);
+
+    // 微分状态中包含 Kd，按新旧之比缩放
+    if(pid->kd != 0.0f)
+    {
+        pid->derivative *= kd / pid->kd;
+    }
+    // 位置式输出 = Kp*e + I + D：由积分项吸收 Kp 变化量，Ki = 0 时积分项不会回落，不做补偿
+    if(pid->form == PID_FORM_POSITIONAL && pid->ki != 0.0f)
+    {
+        pid->integral += (pid->kp - kp) * pid->prev_error;
+    }
+
+    pid->kp = kp;
+    pid->ki += blend * (target.ki - pid->ki);
+    pid->kd = kd;
+    pid->out_min = -limit;
+    pid->out_max = limit;
+    return changed;
+}
+
+uint8_t gain_schedule_tune(gain_schedule_t* schedule, uint8_t band, float kp, float ki, float kd)
+{
+    if(band >= schedule->count)
+    {
+        return 0;
+    }
+
+    schedule->points[band].kp = kp;
+    schedule->points[band].ki = ki;
+    schedule->points[band].kd = kd;
+    return 1;
+}
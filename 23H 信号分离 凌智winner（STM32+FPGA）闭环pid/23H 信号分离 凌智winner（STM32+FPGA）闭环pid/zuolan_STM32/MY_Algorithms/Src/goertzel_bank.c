@@ -0,0 +1,401 @@
+/**
+ * @file goertzel_bank.c
+ * @brief 候选频率网格上的Goertzel滤波器组实现
+ * @details
+ * 1. 记录长度：L = m * fs / 网格间隔 (m个网格周期)，数据不足一个网格周期时使用全部数据。
+ * 2. 对每个候选频点运行Goertzel，幅度 A = 2|X| / L (矩形窗)。
+ * 3. 依次选出幅度最大的分量；已选分量的整数倍频点不再作为候选，其余频点先扣除已选分量谐波的预期幅度，
+ *    避免把谐波误判为另一个分量。频率恰为另一分量整数倍的信号因此检测不全，能量占比不足，
+ *    判为无效后由FFT分析处理。
+ * 4. 波形判定：测量2、3、5次谐波 (与其他分量基波重合的谐波不使用，与其他分量谐波重合的扣除预期幅度)：
+ *    - 偶次比 = A_2 * 2 / A_1，锯齿波约1 (A_h = A_1/h，含偶次谐波)，其他波形约0；
+ *    - 奇次谐波评分 = mean(A_h * h^2 / A_1)，正弦约0，三角波约1 (A_h = A_1/h^2)，方波约4 (A_h = A_1/h)。
+ * 5. 有效性：按波形计算各分量的全部谐波功率 (Parseval)，与信号总功率比较。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#include "goertzel_bank.h"
+#include "waveform_classifier.h"
+#include <math.h>
+
+#define GRID_SCORE_TRIANGLE 0.5f // 谐波评分不低于此值判为三角波
+#define GRID_SCORE_SQUARE 2.0f   // 谐波评分不低于此值判为方波
+#define GRID_EVEN_SAWTOOTH 0.5f  // 偶次比不低于此值判为锯齿波
+// 全部谐波功率与基波功率之比：三角波 pi^4/96，方波 pi^2/8，锯齿波 pi^2/6
+#define GRID_POWER_TRIANGLE 1.01468f
+#define GRID_POWER_SQUARE 1.23370f
+#define GRID_POWER_SAWTOOTH 1.64493f
+
+static const uint8_t grid_odd_harmonics[] = {3, 5}; // 用于奇次谐波评分的谐波次数
+
+static float grid_start = GRID_DEFAULT_START;
+static float grid_step = GRID_DEFAULT_STEP;
+static uint16_t grid_count = GRID_DEFAULT_COUNT;
+static uint8_t grid_periods = GRID_DEFAULT_PERIODS;
+
+static float grid_magnitude[GRID_MAX_CANDIDATES]; // 各候选频点的幅度
+
+// 当前检测使用的数据
+static const float* grid_data = NULL;
+static uint16_t grid_length = 0;
+static float grid_mean = 0.0f;
+static float grid_fs = 0.0f;
+
+uint8_t goertzel_bank_set_grid(float start, float step, uint16_t count, uint8_t periods)
+{
+    if(start <= 0.0f || step <= 0.0f || count == 0 || count > GRID_MAX_CANDIDATES || periods == 0)
+    {
+        return 0;
+    }
+
+    grid_start = start;
+    grid_step = step;
+    grid_count = count;
+    grid_periods = periods;
+    return 1;
+}
+
+/**
+ * @brief 在任意频率处计算去直流后数据的正弦分量幅度
+ * @param frequency 频率 (Hz)
+ * @return 峰值幅度 (V)
+ */
+static float grid_goertzel(float frequency)
+{
+    float w = 2.0f * PI * frequency / grid_fs;
+    float coeff = 2.0f * cosf(w);
+    float s1 = 0.0f;
+    float s2 = 0.0f;
+
+    for(uint16_t i = 0; i < grid_length; i++)
+    {
+        float s0 = (grid_data[i] - grid_mean) + coeff * s1 - s2;
+        s2 = s1;
+        s1 = s0;
+    }
+
+    float power = s1 * s1 + s2 * s2 - coeff * s1 * s2;
+    if(power < 0.0f)
+    {
+        power = 0.0f;
+    }
+
+    return sqrtf(power) * 2.0f / grid_length;
+}
+
+/**
+ * @brief 频率所对应的网格候选下标
+ * @return 下标，不在网格上时返回-1
+ */
+static int16_t grid_index_of(float frequency)
+{
+    float pos = (frequency - grid_start) / grid_step;
+    int32_t index = (int32_t)floorf(pos + 0.5f);
+
+    if(index < 0 || index >= grid_count || fabsf(pos - index) > 0.25f)
+    {
+        return -1;
+    }
+
+    return (int16_t)index;
+}
+
+/**
+ * @brief 获取任意频率处的幅度，网格频点直接取已计算的结果
+ */
+static float grid_amplitude_at(float frequency)
+{
+    int16_t index = grid_index_of(frequency);
+
+    return (index >= 0) ? grid_magnitude[index] : grid_goertzel(frequency);
+}
+
+/**
+ * @brief 按波形类型预测分量在其h次谐波处的幅度
+ */
+static float grid_expected_harmonic(const grid_component_t* comp, uint8_t h)
+{
+    switch(comp->waveform)
+    {
+        case WAVE_TRIANGLE:
+            return (h & 1) ? comp->magnitude / (h * h) : 0.0f;
+        case WAVE_SQUARE:
+            return (h & 1) ? comp->magnitude / h : 0.0f;
+        case WAVE_SAWTOOTH:
+            return comp->magnitude / h;
+        default:
+            return 0.0f;
+    }
+}
+
+/**
+ * @brief 频率是否为某个已选分量的整数倍 (2次及以上谐波)
+ */
+static uint8_t grid_is_harmonic(float frequency, const grid_component_t* comps, uint8_t count)
+{
+    for(uint8_t j = 0; j < count; j++)
+    {
+        float ratio = frequency / comps[j].frequency;
+        uint8_t h = (uint8_t)(ratio + 0.5f);
+        if(h >= 2 && fabsf(ratio - h) * comps[j].frequency <= 0.25f * grid_step)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief 计算频率处除去其他分量贡献后的幅度
+ * @param frequency 频率 (Hz)
+ * @param comps 已检测的分量
+ * @param count 分量数
+ * @param self 当前分量的下标，不扣除自身
+ * @return 剩余幅度，与其他分量基波重合时返回-1 (不可用)
+ */
+static float grid_residual_amplitude(float frequency, const grid_component_t* comps, uint8_t count, uint8_t self)
+{
+    float amplitude = grid_amplitude_at(frequency);
+
+    for(uint8_t j = 0; j < count; j++)
+    {
+        if(j == self)
+        {
+            continue;
+        }
+
+        float ratio = frequency / comps[j].frequency;
+        uint8_t h = (uint8_t)(ratio + 0.5f);
+        if(h == 0 || fabsf(ratio - h) * comps[j].frequency > 0.25f * grid_step)
+        {
+            continue;
+        }
+        if(h == 1)
+        {
+            return -1.0f;
+        }
+        amplitude -= grid_expected_harmonic(&comps[j], h);
+    }
+
+    return (amplitude > 0.0f) ? amplitude : 0.0f;
+}
+
+/**
+ * @brief 由谐波幅度判定分量的波形类型
+ */
+static void grid_classify(grid_component_t* comps, uint8_t count, uint8_t self)
+{
+    grid_component_t* comp = &comps[self];
+    float score = 0.0f;
+    uint8_t used = 0;
+
+    // 偶次谐波只有锯齿波才有，2次谐波不可用时按无偶次谐波处理
+    float even = 0.0f;
+    if(2.0f * comp->frequency < 0.5f * grid_fs)
+    {
+        float amplitude = grid_residual_amplitude(2.0f * comp->frequency, comps, count, self);
+        if(amplitude > 0.0f)
+        {
+            even = amplitude * 2.0f / comp->magnitude;
+        }
+    }
+
+    for(uint8_t i = 0; i < sizeof(grid_odd_harmonics); i++)
+    {
+        uint8_t h = grid_odd_harmonics[i];
+        float frequency = h * comp->frequency;
+        if(frequency >= 0.5f * grid_fs)
+        {
+            break;
+        }
+
+        float amplitude = grid_residual_amplitude(frequency, comps, count, self);
+        if(amplitude < 0.0f)
+        {
+            continue;
+        }
+        score += amplitude * h * h / comp->magnitude;
+        used++;
+    }
+
+    comp->harmonic_score = (used > 0) ? score / used : 0.0f;
+    comp->even_ratio = even;
+    if(even >= GRID_EVEN_SAWTOOTH)
+    {
+        comp->waveform = WAVE_SAWTOOTH;
+    }
+    else if(comp->harmonic_score >= GRID_SCORE_SQUARE)
+    {
+        comp->waveform = WAVE_SQUARE;
+    }
+    else if(comp->harmonic_score >= GRID_SCORE_TRIANGLE)
+    {
+        comp->waveform = WAVE_TRIANGLE;
+    }
+    else
+    {
+        comp->waveform = WAVE_SINE;
+    }
+}
+
+uint8_t goertzel_bank_detect(const float* data, uint16_t length, float sampling_freq,
+                             float min_threshold, grid_result_t* result)
+{
+    memset(result, 0, sizeof(grid_result_t));
+    if(data == NULL || length == 0 || sampling_freq <= 0.0f)
+    {
+        return 0;
+    }
+
+    // 记录长度取网格周期的整数倍，使所有网格频率都是整周期
+    float period = sampling_freq / grid_step;
+    uint16_t record = length;
+    if(period <= length)
+    {
+        uint16_t m = (uint16_t)(length / period);
+        if(m > grid_periods)
+        {
+            m = grid_periods;
+        }
+        record = (uint16_t)(m * period + 0.5f);
+        if(record > length)
+        {
+            record = length;
+        }
+    }
+
+    grid_data = data;
+    grid_length = record;
+    grid_fs = sampling_freq;
+    result->record_length = record;
+
+    // 直流和信号总功率
+    float sum = 0.0f;
+    for(uint16_t i = 0; i < record; i++)
+    {
+        sum += data[i];
+    }
+    grid_mean = sum / record;
+
+    float total_power = 0.0f;
+    for(uint16_t i = 0; i < record; i++)
+    {
+        float v = data[i] - grid_mean;
+        total_power += v * v;
+    }
+    total_power /= record;
+
+    // 滤波器组：每个候选频点一个Goertzel
+    for(uint16_t k = 0; k < grid_count; k++)
+    {
+        float frequency = grid_start + k * grid_step;
+        grid_magnitude[k] = (frequency < 0.5f * sampling_freq) ? grid_goertzel(frequency) : 0.0f;
+    }
+
+    // 依次选出扣除已选分量谐波后幅度最大的候选
+    grid_component_t* comps = result->components;
+    uint8_t count = 0;
+    float reference = 0.0f;
+    while(count < GRID_MAX_COMPONENTS)
+    {
+        int16_t best = -1;
+        float best_amplitude = 0.0f;
+
+        for(uint16_t k = 0; k < grid_count; k++)
+        {
+            float frequency = grid_start + k * grid_step;
+            if(grid_is_harmonic(frequency, comps, count))
+            {
+                continue;
+            }
+            float amplitude = grid_residual_amplitude(frequency, comps, count, 0xFF);
+            if(amplitude > best_amplitude)
+            {
+                best_amplitude = amplitude;
+                best = k;
+            }
+        }
+
+        if(best < 0 || (count > 0 && best_amplitude < min_threshold * reference))
+        {
+            break;
+        }
+        if(count == 0)
+        {
+            reference = best_amplitude;
+        }
+
+        comps[count].frequency = grid_start + best * grid_step;
+        comps[count].magnitude = best_amplitude;
+        count++;
+        grid_classify(comps, count, count - 1);
+    }
+
+    // 所有分量确定后重新判定，排除后检测分量对先检测分量谐波的影响
+    for(uint8_t i = 0; i + 1 < count; i++)
+    {
+        grid_classify(comps, count, i);
+    }
+
+    // 检测分量 (含全部谐波) 能量占比
+    float explained = 0.0f;
+    for(uint8_t i = 0; i < count; i++)
+    {
+        float factor = 1.0f;
+        if(comps[i].waveform == WAVE_TRIANGLE) factor = GRID_POWER_TRIANGLE;
+        if(comps[i].waveform == WAVE_SQUARE) factor = GRID_POWER_SQUARE;
+        if(comps[i].waveform == WAVE_SAWTOOTH) factor = GRID_POWER_SAWTOOTH;
+        explained += 0.5f * comps[i].magnitude * comps[i].magnitude * factor;
+    }
+    result->explained = (total_power > 0.0f) ? explained / total_power : 0.0f;
+    result->valid = (count > 0 && result->explained >= GRID_MIN_EXPLAINED);
+
+    // 按频率升序排列
+    if(count == 2 && comps[0].frequency > comps[1].frequency)
+    {
+        grid_component_t temp = comps[0];
+        comps[0] = comps[1];
+        comps[1] = temp;
+    }
+
+    result->count = count;
+    return count;
+}
+
+void goertzel_bank_output(const grid_result_t* result)
+{
+    my_printf(&huart1, "=== Grid Goertzel Detection ===\r\n");
+    my_printf(&huart1, "Grid: %.0f Hz + k*%.0f Hz, %d points, %d samples\r\n",
+              grid_start, grid_step, grid_count, result->record_length);
+
+    for(uint8_t i = 0; i < result->count; i++)
+    {
+        const grid_component_t* comp = &result->components[i];
+        my_printf(&huart1, "Component %d: %.0f Hz, %.4fV, %s (score %.2f, even %.2f)\r\n",
+                  i + 1, comp->frequency, comp->magnitude, waveform_name(comp->waveform), comp->harmonic_score,
+                  comp->even_ratio);
+    }
+
+    my_printf(&huart1, "Explained: %.1f%% %s\r\n", result->explained * 100.0f,
+              result->valid ? "(valid)" : "(off grid, use FFT)");
+}
+
+uint8_t configure_da_output_from_grid(const grid_result_t* result)
+{
+    if(!result->valid)
+    {
+        return 0;
+    }
+
+    for(uint8_t i = 0; i < result->count && i < NUM_DA_CHANNELS; i++)
+    {
+        const grid_component_t* comp = &result->components[i];
+        DA_SetConfig(i, comp->frequency, 1000, 0, comp->waveform);
+        my_printf(&huart1, "%c: %s, DA%d: %.0f Hz\r\n", 'A' + i, waveform_name(comp->waveform), i + 1, comp->frequency);
+    }
+
+    DA_Apply_Settings();
+    return 1;
+}
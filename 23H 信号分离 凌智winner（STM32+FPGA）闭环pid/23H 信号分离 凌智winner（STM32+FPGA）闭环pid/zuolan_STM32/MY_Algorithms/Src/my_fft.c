@@ -1,14 +1,27 @@
 #include "my_fft.h"
 #include "da_output.h"
+#include "my_hmi.h"
+#include "peak_tracker.h"
+#include "waveform_classifier.h"
+#include "clean_separation.h"
+#include "my_psd.h"
 #include <math.h>
 #include <stdlib.h>
 
 // FFT相关变量
-arm_cfft_radix4_instance_f32 fft_instance;
-float fft_input_buffer[FFT_LENGTH * 2]; // 复数输入缓冲区，实部和虚部交错存储
-float fft_magnitude[FFT_LENGTH];
-float window_buffer[FFT_LENGTH]; // 窗函数缓冲区
+fft_context_t fft_context;      // 当前FFT长度及对应的CMSIS实例
+float fft_spectrum_buffer[FFT_MAX_LENGTH]; // 实数FFT输出，CMSIS打包格式的复数频谱
+float fft_magnitude[FFT_MAX_LENGTH]; // 幅度谱 (前N/2+1点有效)，FFT计算期间兼作加窗数据缓冲区
+float window_buffer[FFT_MAX_LENGTH]; // 窗函数缓冲区
+// PSD分段计算 (my_psd.c) 和CLEAN分离 (clean_separation.c) 的临时缓冲区。两者都只在后台的
+// 双峰分析流程中先后调用，返回后内容不再使用，共用一组缓冲区可节省8KB RAM。
+float fft_scratch[FFT_SCRATCH_COUNT][FFT_MAX_LENGTH];
 dual_peak_result_t dual_peaks;   // 双峰检测结果
+spectrum_features_t spectrum_features; // 频谱特征记录
+
+// 最近一次FFT的时域数据，供细化频谱复用
+static const float* spectrum_source = NULL;
+static uint16_t spectrum_source_length = 0;
 
 // 全局变量储存双峰检测结果
 float peak1_frequency = 0.0f;   // 第一个峰值的频率 (Hz)
@@ -20,73 +33,168 @@ float peak2_magnitude = 0.0f;   // 第二个峰值的幅度 (V)
  * @brief FFT模块初始化
  */
 /**
- * @brief 生成Hanning窗函数
+ * @brief 生成指定类型的窗函数
+ * @details 各窗均为余弦和形式 w[i] = a0 - a1*cos(x) + a2*cos(2x) - a3*cos(3x) + a4*cos(4x)，
+ *          x = 2*pi*i/(length-1)，与原Hanning窗的定义一致。
+ * @param type 窗函数类型
+ * @param buffer 输出缓冲区，长度不小于 length
+ * @param length 窗长度
  */
-void generate_hanning_window(void)
+void generate_window(window_type_t type, float* buffer, uint16_t length)
 {
-    uint16_t i;
-    for(i = 0; i < FFT_LENGTH; i++)
+    // 余弦和系数 a0~a4
+    static const float coef[WINDOW_TYPE_COUNT][5] = {
+        {1.0f,        0.0f,        0.0f,        0.0f,        0.0f},        // 矩形窗
+        {0.5f,        0.5f,        0.0f,        0.0f,        0.0f},        // Hanning
+        {0.54f,       0.46f,       0.0f,        0.0f,        0.0f},        // Hamming
+        {0.42f,       0.5f,        0.08f,       0.0f,        0.0f},        // Blackman
+        {0.35875f,    0.48829f,    0.14128f,    0.01168f,    0.0f},        // 4项Blackman-Harris
+        {0.21557895f, 0.41663158f, 0.277263158f, 0.083578947f, 0.006947368f} // 平顶窗
+    };
+    const float* a = coef[(type < WINDOW_TYPE_COUNT) ? type : WINDOW_HANNING];
+    
+    for(uint16_t i = 0; i < length; i++)
     {
-        window_buffer[i] = 0.5f * (1.0f - arm_cos_f32(2.0f * 3.14159265f * i / (FFT_LENGTH - 1)));
+        float x = 2.0f * 3.14159265f * i / (length - 1);
+        buffer[i] = a[0] - a[1] * arm_cos_f32(x) + a[2] * arm_cos_f32(2.0f * x)
+                  - a[3] * arm_cos_f32(3.0f * x) + a[4] * arm_cos_f32(4.0f * x);
     }
 }
 
+/**
+ * @brief 获取窗函数主瓣半宽
+ * @details 计算单个频谱分量的功率时，需要包含中心bin两侧各该数量的bin。
+ * @param type 窗函数类型
+ * @return 主瓣半宽 (bin)
+ */
+uint8_t window_lobe_bins(window_type_t type)
+{
+    static const uint8_t lobe[WINDOW_TYPE_COUNT] = {1, 2, 2, 3, 4, 5};
+    
+    return lobe[(type < WINDOW_TYPE_COUNT) ? type : WINDOW_HANNING];
+}
+
+/**
+ * @brief 生成Hanning窗函数
+ */
+void generate_hanning_window(void)
+{
+    generate_window(WINDOW_HANNING, window_buffer, fft_context.length);
+}
+
 void fft_init(void)
 {
-    // 初始化radix4 FFT实例
-    arm_cfft_radix4_init_f32(&fft_instance, FFT_LENGTH, 0, 1);
-    // 参数说明：
-    // fftLen: FFT长度 (1024)
-    // ifftFlag: 0=FFT, 1=IFFT
-    // bitReverseFlag: 1=输出按正常顺序
+    // 默认使用 FFT_LENGTH 点FFT
+    fft_set_length(FFT_LENGTH);
+    
+    // 寻峰用的平均功率谱：512点分段、50%重叠，一帧3段，指数平均跟踪信号变化
+    psd_init(PSD_ANALYSIS_SEGMENT, 0.5f, WINDOW_HANNING, PSD_AVERAGE_EXPONENTIAL, PSD_ANALYSIS_ALPHA);
+}
+
+/**
+ * @brief 设置FFT长度
+ * @details
+ * 按新长度初始化CMSIS实数FFT实例 arm_rfft_fast_f32，并重新生成窗函数。
+ * 短FFT只取一帧的前 length 个样本，计算量小、适合快速响应；频率分辨率为
+ * fs/length，最高为一次采集的点数 FIFO_SIZE 对应的 fs/1024。
+ * 长度不超过 FFT_MAX_LENGTH (FIFO_SIZE)：超过采集点数的FFT只能补零，
+ * 只是对同一个频谱插值，不提高分辨率，而且各处以bin为单位的主瓣宽度、
+ * 峰值间隔常数都会失配，因此不支持。
+ * 设置后需重新调用 calculate_fft_spectrum()，之前的频谱和特征记录失效。
+ * @param length FFT长度，取 256/512/1024
+ * @return 1=设置成功，0=长度不支持（保持原设置）
+ */
+uint8_t fft_set_length(uint16_t length)
+{
+    switch(length)
+    {
+        case 256:
+        case 512:
+        case 1024:
+            break;
+        default:
+            return 0;
+    }
+    
+    if(length > FFT_MAX_LENGTH || arm_rfft_fast_init_f32(&fft_context.rfft, length) != ARM_MATH_SUCCESS)
+    {
+        return 0;
+    }
+    fft_context.length = length;
     
     // 生成Hanning窗函数
     generate_hanning_window();
+    
+    // 旧长度下的频谱不再有效
+    memset(fft_magnitude, 0, sizeof(fft_magnitude));
+    spectrum_features.valid = 0;
+    spectrum_source = NULL;
+    spectrum_source_length = 0;
+    
+    return 1;
 }
 
 /**
- * @brief 计算1024点FFT频谱
+ * @brief 获取当前FFT长度
+ * @return FFT长度（点数）
+ */
+uint16_t fft_get_length(void)
+{
+    return fft_context.length;
+}
+
+/**
+ * @brief 计算FFT频谱（长度由 fft_set_length() 设置）
+ * @details
+ * 输入为实数，使用实数FFT只计算 N/2+1 个独立频点：
+ * 1. 加窗后的数据暂存在 fft_magnitude 中作为FFT输入（会被FFT破坏）；
+ * 2. FFT结果以CMSIS打包格式写入 fft_spectrum_buffer：
+ *    [0]=直流实部, [1]=Nyquist实部, [2k]/[2k+1]=第k个bin的实部/虚部；
+ * 3. 一次遍历完成求模、归一化和窗函数补偿，结果写回 fft_magnitude[0..N/2]。
  * @param input_data 输入浮点数据数组指针
- * @param data_length 输入数据长度（最大1024）
+ * @param data_length 输入数据长度（超过FFT长度的部分被忽略，不足部分补零）
  */
 void calculate_fft_spectrum(float* input_data, uint16_t data_length)
 {
     uint16_t i;
-    uint16_t actual_length = (data_length > FFT_LENGTH) ? FFT_LENGTH : data_length;
+    uint16_t n = fft_context.length;
+    uint16_t actual_length = (data_length > n) ? n : data_length;
+    float* windowed = fft_magnitude;
     
-    // 清空缓冲区
-    memset(fft_input_buffer, 0, sizeof(fft_input_buffer));
-    memset(fft_magnitude, 0, sizeof(fft_magnitude));
-    
-    // 将实数数据转换为复数格式，同时应用Hanning窗
+    // 应用Hanning窗，数据不足FFT长度时补零
     for(i = 0; i < actual_length; i++)
     {
-        fft_input_buffer[2*i] = input_data[i]*window_buffer[i] ;     // 实部乘以窗函数
-        fft_input_buffer[2*i + 1] = 0.0f;                           // 虚部设为0
+        windowed[i] = input_data[i] * window_buffer[i];
+    }
+    for(; i < n; i++)
+    {
+        windowed[i] = 0.0f;
     }
     
-    // 如果数据不足1024点，剩余部分已经清零，相当于零填充
-    
-    // 执行复数FFT（前向变换）
-    arm_cfft_radix4_f32(&fft_instance, fft_input_buffer);
+    // 记录时域数据，细化频谱时直接复用本次采集的样本
+    spectrum_source = input_data;
+    spectrum_source_length = actual_length;
     
-    // 计算幅度谱 - 注意这里要计算完整的FFT_LENGTH点
-    arm_cmplx_mag_f32(fft_input_buffer, fft_magnitude, FFT_LENGTH);
+    // 执行实数FFT（前向变换）
+    arm_rfft_fast_f32(&fft_context.rfft, windowed, fft_spectrum_buffer, 0);
     
-    // 由于对称性，只保留前半部分（0到Nyquist频率）
     // 归一化处理，需要补偿Hanning窗的功率损失
     float window_power_correction = 1.5f; // Hanning窗的功率补偿因子
+    // 直流和Nyquist分量除以N，其他分量除以N/2（考虑双边频谱的对称性）
+    float edge_scale = window_power_correction / n;
+    float bin_scale = 2.0f * window_power_correction / n;
     
-    for(i = 0; i < FFT_LENGTH / 2; i++)
+    fft_magnitude[0] = fabsf(fft_spectrum_buffer[0]) * edge_scale;
+    fft_magnitude[n / 2] = fabsf(fft_spectrum_buffer[1]) * edge_scale;
+    for(i = 1; i < n / 2; i++)
     {
-        if(i == 0) {
-            // 直流分量除以N，并补偿窗函数损失
-            fft_magnitude[i] = fft_magnitude[i] / FFT_LENGTH * window_power_correction;
-        } else {
-            // 其他分量除以N/2（考虑双边频谱的对称性），并补偿窗函数损失
-            fft_magnitude[i] = fft_magnitude[i] * 2.0f / FFT_LENGTH * window_power_correction;
-        }
+        float re = fft_spectrum_buffer[2 * i];
+        float im = fft_spectrum_buffer[2 * i + 1];
+        fft_magnitude[i] = sqrtf(re * re + im * im) * bin_scale;
     }
+    
+    // 频谱已更新，特征记录需重新提取
+    spectrum_features.valid = 0;
 }
 
 /**
@@ -100,16 +208,16 @@ void output_fft_spectrum(void)
     
     // 获取当前采样频率
     float sampling_freq = get_current_ad_frequency();
-    freq_resolution = sampling_freq / FFT_LENGTH;
+    freq_resolution = sampling_freq / fft_context.length;
     
     my_printf(&huart1, "=== FFT Spectrum Analysis ===\r\n");
     my_printf(&huart1, "Sampling Freq: %.0f Hz\r\n", sampling_freq);
     my_printf(&huart1, "Freq Resolution: %.2f Hz\r\n", freq_resolution);
-   //my_printf(&huart1, "Points: %d\r\n", FFT_LENGTH);
+   //my_printf(&huart1, "Points: %d\r\n", fft_context.length);
     my_printf(&huart1, "--- Spectrum Data ---\r\n");
     
     // 输出频谱数据，只输出前512个点（对应0到Nyquist频率）
-    for(i = 10; i < FFT_LENGTH / 2; i++) 
+    for(i = 10; i < fft_context.length / 2; i++) 
     {
         current_freq = i * freq_resolution;
         my_printf(&huart1, "%.1f Hz: %.6f\r\n", current_freq, fft_magnitude[i]);
@@ -118,28 +226,22 @@ void output_fft_spectrum(void)
     // 额外输出一些关键信息
     my_printf(&huart1, "--- Peak Analysis ---\r\n");
     
-    // 寻找最大幅度点（排除直流分量）
-    float max_magnitude = 0.0f;
-    uint16_t max_index = 1;
-    for(i = 1; i < FFT_LENGTH / 2; i++)
-    {
-        if(fft_magnitude[i] > max_magnitude)
-        {
-            max_magnitude = fft_magnitude[i];
-            max_index = i;
-        }
-    }
-    
-    float peak_freq_raw = get_precise_peak_frequency(sampling_freq);
+    // 所有指标均取自同一份特征记录
+    const spectrum_features_t* features = get_spectrum_features(sampling_freq);
+    float peak_freq_raw = (features->peak_count > 0) ? features->peaks[0].precise_frequency : 0.0f;
+    float peak_magnitude = (features->peak_count > 0) ? features->peaks[0].magnitude : 0.0f;
     float peak_freq = round_to_nearest_k(peak_freq_raw);
-    float thd = calculate_thd(peak_freq, sampling_freq);
     
-    my_printf(&huart1, "Peak Freq: %.0f Hz (Raw: %.2f Hz), Magnitude: %.6fv\r\n", peak_freq, peak_freq_raw, max_magnitude);
-    my_printf(&huart1, "THD: %.2f%%\r\n", thd);
-    my_printf(&huart1, "DC Component: %.6fv\r\n", fft_magnitude[0]);
+    my_printf(&huart1, "Peak Freq: %.0f Hz (Raw: %.2f Hz), Magnitude: %.6fv\r\n", peak_freq, peak_freq_raw, peak_magnitude);
+    my_printf(&huart1, "THD: %.2f%%\r\n", features->thd);
+    my_printf(&huart1, "SNR: %.2f dB, SINAD: %.2f dB, SFDR: %.2f dBc, ENOB: %.2f bit\r\n",
+              features->snr, features->sinad, features->sfdr, features->enob);
+    my_printf(&huart1, "Noise Floor: %.6fv\r\n", features->noise_floor);
+    my_printf(&huart1, "DC Component: %.6fv\r\n", features->dc);
     
     // 执行双峰检测
-    dual_peaks = find_dual_peaks(sampling_freq, 0.2f);  // 阈值为最大值的20%
+    // 平均功率谱未并入当前帧，不用其门限
+    dual_peaks = find_dual_peaks(sampling_freq, 0.2f, 0);  // 阈值为最大值的20%
     
     my_printf(&huart1, "\r\n");
     output_dual_peaks_info();
@@ -154,49 +256,14 @@ void output_fft_spectrum(void)
  */
 float get_precise_peak_frequency(float sampling_freq)
 {
-    uint16_t i;
-    float freq_resolution = sampling_freq / FFT_LENGTH;
+    const spectrum_features_t* features = get_spectrum_features(sampling_freq);
     
-    // 寻找最大幅度点（排除直流分量）
-    float max_magnitude = 0.0f;
-    uint16_t max_index = 1;
-    for(i = 1; i < FFT_LENGTH / 2; i++)
-    {
-        if(fft_magnitude[i] > max_magnitude)
-        {
-            max_magnitude = fft_magnitude[i];
-            max_index = i;
-        }
-    }
-    
-    // 如果峰值在边界，直接返回
-    if(max_index <= 1 || max_index >= (FFT_LENGTH / 2 - 1))
-    {
-        return max_index * freq_resolution;
-    }
-    
-    // 抛物线插值法提高频率精度
-    float y1 = fft_magnitude[max_index - 1];
-    float y2 = fft_magnitude[max_index];
-    float y3 = fft_magnitude[max_index + 1];
-    
-    // 计算抛物线顶点位置的偏移量
-    float delta = 0.5f * (y1 - y3) / (y1 - 2.0f * y2 + y3);
-    
-    // 防止分母为零
-    if(fabsf(y1 - 2.0f * y2 + y3) < 1e-10f)
+    if(features->peak_count == 0)
     {
-        delta = 0.0f;
+        return 0.0f;
     }
     
-    // 限制偏移量在合理范围内
-    if(delta > 0.5f) delta = 0.5f;
-    if(delta < -0.5f) delta = -0.5f;
-    
-    // 计算精确频率
-    float precise_freq = (max_index + delta) * freq_resolution;
-    
-    return precise_freq;
+    return features->peaks[0].precise_frequency;
 }
 
 /**
@@ -211,69 +278,95 @@ float round_to_nearest_k(float frequency)
 }
 
 /**
- * @brief 计算总谐波失真THD
- * @param fundamental_freq 基波频率
- * @param sampling_freq 采样频率
- * @return THD值（百分比）
+ * @brief 计算以指定bin为中心的单个频谱分量的功率
+ * @details 累加中心 ± SPECTRUM_LOBE_BINS 范围内各bin的幅度平方 (含Hanning窗主瓣及近端旁瓣泄漏)，
+ *          超出统计范围的bin不计入。
+ * @param center_bin 中心bin
+ * @param bins_used 输出实际累加的bin数，可为NULL
+ * @return 分量功率 (V^2)
  */
-float calculate_thd(float fundamental_freq, float sampling_freq)
+static float spectrum_band_power(int32_t center_bin, uint16_t* bins_used)
 {
-    float freq_resolution = sampling_freq / FFT_LENGTH;
-    float fundamental_power = 0.0f;
-    float harmonic_power = 0.0f;
+    int32_t lo = center_bin - SPECTRUM_LOBE_BINS;
+    int32_t hi = center_bin + SPECTRUM_LOBE_BINS;
+    float power = 0.0f;
     
-    // 找到基波频率对应的FFT bin
-    uint16_t fundamental_bin = (uint16_t)(fundamental_freq / freq_resolution + 0.5f);
+    if(lo < SPECTRUM_START_BIN) lo = SPECTRUM_START_BIN;
+    if(hi > fft_context.length / 2 - 1) hi = fft_context.length / 2 - 1;
     
-    // 确保基波bin在有效范围内
-    if(fundamental_bin < 1 || fundamental_bin >= FFT_LENGTH / 2)
+    for(int32_t i = lo; i <= hi; i++)
     {
-        return 0.0f;
+        power += fft_magnitude[i] * fft_magnitude[i];
     }
     
-    // 计算基波功率（包含邻近bin以考虑频谱泄漏）
-    fundamental_power = fft_magnitude[fundamental_bin] * fft_magnitude[fundamental_bin];
-    if(fundamental_bin > 1)
-    {
-        fundamental_power += 0.5f * fft_magnitude[fundamental_bin - 1] * fft_magnitude[fundamental_bin - 1];
-    }
-    if(fundamental_bin < FFT_LENGTH / 2 - 1)
+    if(bins_used != NULL)
     {
-        fundamental_power += 0.5f * fft_magnitude[fundamental_bin + 1] * fft_magnitude[fundamental_bin + 1];
+        *bins_used = (hi >= lo) ? (uint16_t)(hi - lo + 1) : 0;
     }
     
-    // 计算谐波功率（2次到10次谐波）
-    for(uint8_t harmonic = 2; harmonic <= 10; harmonic++)
+    return power;
+}
+
+/**
+ * @brief 计算2~SPECTRUM_MAX_HARMONIC次谐波的总功率
+ * @param fundamental_pos 基波所在的bin位置（可为插值后的小数）
+ * @param bins_used 输出谐波占用的bin总数，可为NULL
+ * @return 谐波总功率 (V^2)
+ */
+static float spectrum_harmonic_power(float fundamental_pos, uint16_t* bins_used)
+{
+    float harmonic_power = 0.0f;
+    uint16_t used_total = 0;
+    
+    for(uint8_t harmonic = 2; harmonic <= SPECTRUM_MAX_HARMONIC; harmonic++)
     {
-        uint16_t harmonic_bin = harmonic * fundamental_bin;
+        int32_t harmonic_bin = (int32_t)(harmonic * fundamental_pos + 0.5f);
         
         // 确保谐波bin在Nyquist频率以下
-        if(harmonic_bin >= FFT_LENGTH / 2)
+        if(harmonic_bin >= fft_context.length / 2)
         {
             break;
         }
         
-        // 累加谐波功率（包含邻近bin）
-        float harmonic_mag_squared = fft_magnitude[harmonic_bin] * fft_magnitude[harmonic_bin];
-        
-        // 加上邻近bin的贡献
-        if(harmonic_bin > 1)
-        {
-            harmonic_mag_squared += 0.25f * fft_magnitude[harmonic_bin - 1] * fft_magnitude[harmonic_bin - 1];
-        }
-        if(harmonic_bin < FFT_LENGTH / 2 - 1)
-        {
-            harmonic_mag_squared += 0.25f * fft_magnitude[harmonic_bin + 1] * fft_magnitude[harmonic_bin + 1];
-        }
-        
-        harmonic_power += harmonic_mag_squared;
+        uint16_t used;
+        harmonic_power += spectrum_band_power(harmonic_bin, &used);
+        used_total += used;
+    }
+    
+    if(bins_used != NULL)
+    {
+        *bins_used = used_total;
     }
     
+    return harmonic_power;
+}
+
+/**
+ * @brief 计算总谐波失真THD
+ * @details 基波和各次谐波的功率均按 spectrum_band_power() 统计，与频谱特征记录中的THD定义一致。
+ * @param fundamental_freq 基波频率
+ * @param sampling_freq 采样频率
+ * @return THD值（百分比）
+ */
+float calculate_thd(float fundamental_freq, float sampling_freq)
+{
+    float freq_resolution = sampling_freq / fft_context.length;
+    float fundamental_pos = fundamental_freq / freq_resolution;
+    int32_t fundamental_bin = (int32_t)(fundamental_pos + 0.5f);
+    
+    // 确保基波bin在有效范围内
+    if(fundamental_bin < SPECTRUM_START_BIN || fundamental_bin >= fft_context.length / 2)
+    {
+        return 0.0f;
+    }
+    
+    float fundamental_power = spectrum_band_power(fundamental_bin, NULL);
+    float harmonic_power = spectrum_harmonic_power(fundamental_pos, NULL);
+    
     // 计算THD = sqrt(谐波功率总和) / 基波幅度 * 100%
     if(fundamental_power > 0.0f)
     {
-        float thd = sqrtf(harmonic_power) / sqrtf(fundamental_power) * 100.0f;
-        return thd;
+        return sqrtf(harmonic_power / fundamental_power) * 100.0f;
     }
     
     return 0.0f;
@@ -287,10 +380,10 @@ float calculate_thd(float fundamental_freq, float sampling_freq)
  */
 float calculate_precise_frequency(uint16_t bin_index, float sampling_freq)
 {
-    float freq_resolution = sampling_freq / FFT_LENGTH;
+    float freq_resolution = sampling_freq / fft_context.length;
     
     // 边界检查
-    if(bin_index <= 1 || bin_index >= (FFT_LENGTH / 2 - 1))
+    if(bin_index <= 1 || bin_index >= (fft_context.length / 2 - 1))
     {
         return bin_index * freq_resolution;
     }
@@ -315,91 +408,476 @@ float calculate_precise_frequency(uint16_t bin_index, float sampling_freq)
     return (bin_index + delta) * freq_resolution;
 }
 
+/**
+ * @brief 将一个局部最大值插入按幅度降序排列的峰值表
+ * @details
+ * 频谱按bin升序遍历，因此新峰值只可能与表中bin最大的峰值距离过近，
+ * 此时保留幅度较大的一个。表满时新峰值只有大于表中最小峰值才会替换它。
+ * @param features 特征记录
+ * @param bin 局部最大值所在的bin
+ */
+static void spectrum_insert_peak(spectrum_features_t* features, uint16_t bin)
+{
+    float magnitude = fft_magnitude[bin];
+    uint8_t count = features->peak_count;
+    
+    // 与已记录峰值间隔不足时只保留较大者
+    for(uint8_t j = 0; j < count; j++)
+    {
+        if(abs((int)bin - (int)features->peaks[j].bin_index) < SPECTRUM_MIN_SEPARATION)
+        {
+            if(magnitude <= features->peaks[j].magnitude)
+            {
+                return;
+            }
+            for(uint8_t k = j; k < count - 1; k++)
+            {
+                features->peaks[k] = features->peaks[k + 1];
+            }
+            count--;
+            break;
+        }
+    }
+    
+    if(count == MAX_PEAKS)
+    {
+        if(magnitude <= features->peaks[MAX_PEAKS - 1].magnitude)
+        {
+            return;
+        }
+        count--; // 丢弃最小的峰值
+    }
+    
+    // 插入排序，保持幅度降序
+    uint8_t pos = count;
+    while(pos > 0 && features->peaks[pos - 1].magnitude < magnitude)
+    {
+        features->peaks[pos] = features->peaks[pos - 1];
+        pos--;
+    }
+    
+    features->peaks[pos].bin_index = bin;
+    features->peaks[pos].frequency = bin * features->freq_resolution;
+    features->peaks[pos].magnitude = magnitude;
+    features->peaks[pos].precise_frequency = calculate_precise_frequency(bin, features->sampling_freq);
+    features->peak_count = count + 1;
+}
+
+/**
+ * @brief 一次遍历频谱，提取峰值和动态性能指标
+ * @details
+ * 在 calculate_fft_spectrum() 之后调用。对半边频谱 (SPECTRUM_START_BIN ~ Nyquist)
+ * 只遍历一次，同时完成：
+ * 1. 记录幅度最大的 MAX_PEAKS 个局部最大值 (间隔不小于 SPECTRUM_MIN_SEPARATION 个bin)，
+ *    并对每个峰值做抛物线插值；
+ * 2. 累加总功率并记录最大幅度。
+ * 遍历结束后以最大峰值为基波，只读取基波和谐波主瓣附近的少量bin，计算：
+ * - THD  = sqrt(P谐波 / P基波)
+ * - SNR  = P基波 / P噪声 (dB)，噪声为总功率扣除基波和谐波
+ * - SINAD = P基波 / (P噪声 + P谐波) (dB)
+ * - SFDR = 基波幅度 / 最大杂散幅度 (dBc)，杂散取峰值表中第二大的峰值
+ * - ENOB = (SINAD - 1.76) / 6.02
+ * 结果保存在 spectrum_features 中，后续寻峰、串口输出和HMI显示均读取该记录，
+ * 保证同一次采集的各项结果一致。
+ * @note 动态指标按单音信号定义，多音信号时其余分量会计入噪声和杂散；
+ *       基波低于 2*SPECTRUM_LOBE_BINS+1 个bin时相邻谐波的统计范围会重叠，THD略偏大。
+ * @param sampling_freq 采样频率
+ */
+void extract_spectrum_features(float sampling_freq)
+{
+    spectrum_features_t* features = &spectrum_features;
+    float total_power = 0.0f;
+    
+    memset(features, 0, sizeof(spectrum_features_t));
+    features->sampling_freq = sampling_freq;
+    features->freq_resolution = sampling_freq / fft_context.length;
+    features->dc = fft_magnitude[0];
+    
+    // 单次遍历：总功率、最大幅度、局部最大值
+    for(uint16_t i = SPECTRUM_START_BIN; i < fft_context.length / 2; i++)
+    {
+        float magnitude = fft_magnitude[i];
+        
+        total_power += magnitude * magnitude;
+        if(magnitude > features->max_magnitude)
+        {
+            features->max_magnitude = magnitude;
+        }
+        
+        if(i < fft_context.length / 2 - 1 &&
+           magnitude > fft_magnitude[i - 1] &&
+           magnitude > fft_magnitude[i + 1])
+        {
+            spectrum_insert_peak(features, i);
+        }
+    }
+    
+    features->valid = 1;
+    
+    if(features->peak_count == 0 || total_power <= 0.0f)
+    {
+        return;
+    }
+    
+    // 以最大峰值为基波计算动态指标
+    const peak_info_t* fundamental = &features->peaks[0];
+    uint16_t fundamental_bins;
+    uint16_t harmonic_bins;
+    float fundamental_power = spectrum_band_power(fundamental->bin_index, &fundamental_bins);
+    float harmonic_power = spectrum_harmonic_power(fundamental->precise_frequency / features->freq_resolution,
+                                                   &harmonic_bins);
+    
+    float noise_power = total_power - fundamental_power - harmonic_power;
+    int32_t noise_bins = (fft_context.length / 2 - SPECTRUM_START_BIN) - fundamental_bins - harmonic_bins;
+    if(noise_power < 1e-20f)
+    {
+        noise_power = 1e-20f;
+    }
+    if(noise_bins < 1)
+    {
+        noise_bins = 1;
+    }
+    
+    features->noise_floor = sqrtf(noise_power / noise_bins);
+    features->thd = sqrtf(harmonic_power / fundamental_power) * 100.0f;
+    features->snr = 10.0f * log10f(fundamental_power / noise_power);
+    features->sinad = 10.0f * log10f(fundamental_power / (noise_power + harmonic_power));
+    features->enob = (features->sinad - 1.76f) / 6.02f;
+    
+    // 无第二个峰值时以噪底作为最大杂散
+    float spur = (features->peak_count >= 2) ? features->peaks[1].magnitude : features->noise_floor;
+    features->sfdr = (spur > 0.0f) ? 20.0f * log10f(fundamental->magnitude / spur) : 0.0f;
+}
+
+/**
+ * @brief 获取当前频谱的特征记录
+ * @details 频谱更新后或采样频率改变时自动重新提取，否则直接返回已有记录。
+ * @param sampling_freq 采样频率
+ * @return 特征记录指针
+ */
+const spectrum_features_t* get_spectrum_features(float sampling_freq)
+{
+    if(!spectrum_features.valid || spectrum_features.sampling_freq != sampling_freq)
+    {
+        extract_spectrum_features(sampling_freq);
+    }
+    
+    return &spectrum_features;
+}
+
+/**
+ * @brief 将频谱特征记录中的主要指标发送到HMI显示
+ */
+void output_spectrum_features_hmi(void)
+{
+    const spectrum_features_t* features = &spectrum_features;
+    
+    if(!features->valid || features->peak_count == 0)
+    {
+        return;
+    }
+    
+    HMI_Send_Float("freq", features->peaks[0].precise_frequency, 0);
+    HMI_Send_Float("thd", features->thd, 2);
+    HMI_Send_Float("snr", features->snr, 1);
+    HMI_Send_Float("sinad", features->sinad, 1);
+    HMI_Send_Float("sfdr", features->sfdr, 1);
+    HMI_Send_Float("enob", features->enob, 2);
+}
+
+/**
+ * @brief 判断平均功率谱中是否检测到给定频率的分量
+ * @param psd_peaks psd_find_peaks() 找到的峰值
+ * @param count 峰值数量
+ * @param frequency 待检验的频率 (Hz)
+ * @return 1=检测到，0=未检测到
+ */
+static uint8_t psd_confirms(const peak_info_t* psd_peaks, uint8_t count, float frequency)
+{
+    // 平均功率谱的bin更宽，在其主瓣范围内即认为是同一分量
+    float tolerance = window_lobe_bins(psd_state.window) * psd_bin_width();
+    
+    for(uint8_t i = 0; i < count; i++)
+    {
+        if(fabsf(psd_peaks[i].frequency - frequency) <= tolerance)
+        {
+            return 1;
+        }
+    }
+    
+    return 0;
+}
+
 /**
  * @brief 在FFT频谱中寻找峰值
+ * @details 从频谱特征记录中取出幅度超过阈值的峰值，不再重复遍历频谱。
+ * psd_gate 为1且同一采样率下已有平均功率谱 (psd_update) 时，峰值还须超过其统计检测门限
+ * (psd_find_peaks, z = PSD_DEFAULT_Z)，低信噪比时单帧周期图中的噪声峰被剔除。
+ * 平均功率谱只在双峰分析流程中更新，其他路径的当前帧不一定并入过平均，
+ * 门限可能来自之前的另一个信号，此时应令 psd_gate 为0。
+ * 相对阈值仍用于区分主要分量与谐波、泄漏等同样显著的小分量。
  * @param peaks 峰值信息数组
  * @param max_peaks 最大峰值数量
  * @param sampling_freq 采样频率
  * @param min_threshold 最小阈值（相对于最大值的比例）
- * @return 找到的峰值数量
+ * @param psd_gate 1=用平均功率谱的检测门限剔除噪声峰，0=不使用
+ * @return 找到的峰值数量（按幅度降序）
  */
-uint8_t find_spectrum_peaks(peak_info_t* peaks, uint8_t max_peaks, float sampling_freq, float min_threshold)
+uint8_t find_spectrum_peaks(peak_info_t* peaks, uint8_t max_peaks, float sampling_freq, float min_threshold,
+                            uint8_t psd_gate)
 {
+    const spectrum_features_t* features = get_spectrum_features(sampling_freq);
+    float threshold = features->max_magnitude * min_threshold;
+    peak_info_t psd_peaks[MAX_PEAKS];
+    uint8_t psd_count = 0;
+    uint8_t psd_valid = (psd_gate && psd_state.segments > 0 && psd_state.sampling_freq == sampling_freq);
     uint8_t peak_count = 0;
-    float freq_resolution = sampling_freq / FFT_LENGTH;
     
-    // 找到最大幅度作为阈值参考
-    float max_magnitude = 0.0f;
-    for(uint16_t i = 5; i < FFT_LENGTH / 2; i++)  // 从索引5开始，避免直流和极低频分量
+    if(psd_valid)
+    {
+        psd_count = psd_find_peaks(psd_peaks, MAX_PEAKS, PSD_DEFAULT_Z);
+    }
+    
+    // 记录已按幅度降序排列，遇到低于阈值的峰值即可结束
+    for(uint8_t i = 0; i < features->peak_count && peak_count < max_peaks; i++)
     {
-        if(fft_magnitude[i] > max_magnitude)
+        if(features->peaks[i].magnitude <= threshold)
         {
-            max_magnitude = fft_magnitude[i];
+            break;
         }
+        // 单帧周期图的噪声起伏在平均功率谱中达不到统计门限
+        if(psd_valid && !psd_confirms(psd_peaks, psd_count, features->peaks[i].frequency))
+        {
+            continue;
+        }
+        peaks[peak_count++] = features->peaks[i];
     }
     
-    float threshold = max_magnitude * min_threshold;
+    return peak_count;
+}
+
+/**
+ * @brief 计算加窗时域数据在任意(非整数)bin位置处的幅度
+ * @details
+ * 使用广义Goertzel算法在频率 bin_pos * fs / fft_context.length 处计算DTFT，
+ * 每个频点只需遍历一次样本。结果与 fft_magnitude 采用相同的归一化，
+ * 在整数bin上与FFT结果一致。
+ * @param bin_pos bin位置（可为小数）
+ * @return 幅度 (V)
+ */
+static float zoom_dtft_magnitude(float bin_pos)
+{
+    float w = 2.0f * PI * bin_pos / fft_context.length;
+    float coeff = 2.0f * cosf(w);
+    float s1 = 0.0f;
+    float s2 = 0.0f;
+    
+    for(uint16_t i = 0; i < spectrum_source_length; i++)
+    {
+        float s0 = spectrum_source[i] * window_buffer[i] + coeff * s1 - s2;
+        s2 = s1;
+        s1 = s0;
+    }
     
-    // 寻找局部最大值
-    for(uint16_t i = 5; i < FFT_LENGTH / 2 - 1 && peak_count < max_peaks; i++)
+    float power = s1 * s1 + s2 * s2 - coeff * s1 * s2;
+    if(power < 0.0f)
     {
-        // 检查是否为局部最大值
-        if(fft_magnitude[i] > fft_magnitude[i-1] && 
-           fft_magnitude[i] > fft_magnitude[i+1] && 
-           fft_magnitude[i] > threshold)
+        power = 0.0f;
+    }
+    
+    return sqrtf(power) * 2.0f / fft_context.length * 1.5f;
+}
+
+/**
+ * @brief 在等间隔频点序列上对最大值做抛物线插值
+ * @param magnitude 幅度序列
+ * @param index 最大值所在的下标
+ * @param points 序列长度
+ * @return 插值后的下标（可为小数）
+ */
+static float zoom_interpolate(const float* magnitude, uint16_t index, uint16_t points)
+{
+    if(index == 0 || index >= points - 1)
+    {
+        return index;
+    }
+    
+    float y1 = magnitude[index - 1];
+    float y2 = magnitude[index];
+    float y3 = magnitude[index + 1];
+    float denom = y1 - 2.0f * y2 + y3;
+    
+    if(fabsf(denom) < 1e-12f)
+    {
+        return index;
+    }
+    
+    float delta = 0.5f * (y1 - y3) / denom;
+    if(delta > 0.5f) delta = 0.5f;
+    if(delta < -0.5f) delta = -0.5f;
+    
+    return index + delta;
+}
+
+/**
+ * @brief 计算指定窄带内的细化频谱 (Zoom FFT)
+ * @details
+ * 复用最近一次 calculate_fft_spectrum() 的时域样本，在 [f_start, f_stop] 内
+ * 等间隔计算 points 个频点的加窗DTFT，相当于在该频带上的线性调频Z变换。
+ * 频率分辨率由点数决定，不需要采集更长的数据。
+ * @param f_start 起始频率 (Hz)
+ * @param f_stop 终止频率 (Hz)
+ * @param points 频点数 (>= 2)
+ * @param sampling_freq 采样频率
+ * @param magnitude 输出幅度数组，长度不小于 points
+ * @return 实际计算的频点数，无可用时域数据时为0
+ */
+uint16_t zoom_spectrum(float f_start, float f_stop, uint16_t points, float sampling_freq, float* magnitude)
+{
+    if(spectrum_source == NULL || points < 2 || sampling_freq <= 0.0f)
+    {
+        return 0;
+    }
+    
+    float freq_resolution = sampling_freq / fft_context.length;
+    float bin_start = f_start / freq_resolution;
+    float bin_step = (f_stop - f_start) / freq_resolution / (points - 1);
+    
+    for(uint16_t k = 0; k < points; k++)
+    {
+        magnitude[k] = zoom_dtft_magnitude(bin_start + k * bin_step);
+    }
+    
+    return points;
+}
+
+/**
+ * @brief 用细化频谱修正峰值的频率和幅度
+ * @details 在峰值两侧各1个bin内以 1/ZOOM_STEPS_PER_BIN bin 为步长计算细化频谱，
+ *          对最大点做抛物线插值，并在插值位置重新计算幅度，消除栅栏效应带来的误差。
+ * @param peak 待修正的峰值，precise_frequency 和 magnitude 会被更新
+ * @param sampling_freq 采样频率
+ */
+void zoom_refine_peak(peak_info_t* peak, float sampling_freq)
+{
+    float zoom_magnitude[2 * ZOOM_STEPS_PER_BIN + 1];
+    const uint16_t points = 2 * ZOOM_STEPS_PER_BIN + 1;
+    float freq_resolution = sampling_freq / fft_context.length;
+    float bin_start = peak->precise_frequency / freq_resolution - 1.0f;
+    
+    if(zoom_spectrum(bin_start * freq_resolution, (bin_start + 2.0f) * freq_resolution,
+                     points, sampling_freq, zoom_magnitude) == 0)
+    {
+        return;
+    }
+    
+    uint16_t max_index = 0;
+    for(uint16_t k = 1; k < points; k++)
+    {
+        if(zoom_magnitude[k] > zoom_magnitude[max_index])
         {
-            // 确保与已找到的峰值有足够的间隔（至少10个bin）
-            uint8_t is_isolated = 1;
-            for(uint8_t j = 0; j < peak_count; j++)
-            {
-                if(abs((int)i - (int)peaks[j].bin_index) < 10)
-                {
-                    is_isolated = 0;
-                    break;
-                }
-            }
-            
-            if(is_isolated)
-            {
-                peaks[peak_count].bin_index = i;
-                peaks[peak_count].frequency = i * freq_resolution;
-                peaks[peak_count].magnitude = fft_magnitude[i];
-                peaks[peak_count].precise_frequency = calculate_precise_frequency(i, sampling_freq);
-                peak_count++;
-            }
+            max_index = k;
         }
     }
     
-    // 按幅度降序排序
-    for(uint8_t i = 0; i < peak_count - 1; i++)
+    float bin_pos = bin_start + zoom_interpolate(zoom_magnitude, max_index, points) / ZOOM_STEPS_PER_BIN;
+    
+    peak->precise_frequency = bin_pos * freq_resolution;
+    peak->magnitude = zoom_dtft_magnitude(bin_pos);
+}
+
+/**
+ * @brief 在峰值附近的细化频谱中寻找被粗寻峰合并掉的第二个分量
+ * @details
+ * 粗寻峰要求峰值间隔至少 SPECTRUM_MIN_SEPARATION 个bin，间隔更近的两个频率只会留下一个。
+ * 这里在峰值两侧各 SPECTRUM_MIN_SEPARATION 个bin内计算细化频谱，寻找与主峰相距
+ * 至少 ZOOM_MIN_SEPARATION 个bin、且幅度超过阈值的局部最大值。
+ * @param peak 主峰
+ * @param sampling_freq 采样频率
+ * @param threshold 幅度阈值 (V)
+ * @param second 输出找到的第二个峰值
+ * @return 1=找到，0=未找到
+ */
+static uint8_t zoom_split_peak(const peak_info_t* peak, float sampling_freq, float threshold, peak_info_t* second)
+{
+    float zoom_magnitude[ZOOM_MAX_POINTS];
+    float freq_resolution = sampling_freq / fft_context.length;
+    float bin_start = (float)peak->bin_index - SPECTRUM_MIN_SEPARATION;
+    
+    if(bin_start < SPECTRUM_START_BIN)
+    {
+        bin_start = SPECTRUM_START_BIN;
+    }
+    
+    uint16_t points = zoom_spectrum(bin_start * freq_resolution,
+                                    (bin_start + 2.0f * SPECTRUM_MIN_SEPARATION) * freq_resolution,
+                                    ZOOM_MAX_POINTS, sampling_freq, zoom_magnitude);
+    if(points == 0)
     {
-        for(uint8_t j = i + 1; j < peak_count; j++)
+        return 0;
+    }
+    
+    float main_pos = peak->precise_frequency / freq_resolution;
+    int32_t best = -1;
+    
+    for(uint16_t k = 1; k < points - 1; k++)
+    {
+        float bin_pos = bin_start + (float)k / ZOOM_STEPS_PER_BIN;
+        
+        if(zoom_magnitude[k] > zoom_magnitude[k - 1] &&
+           zoom_magnitude[k] >= zoom_magnitude[k + 1] &&
+           zoom_magnitude[k] > threshold &&
+           fabsf(bin_pos - main_pos) >= ZOOM_MIN_SEPARATION &&
+           (best < 0 || zoom_magnitude[k] > zoom_magnitude[best]))
         {
-            if(peaks[j].magnitude > peaks[i].magnitude)
-            {
-                peak_info_t temp = peaks[i];
-                peaks[i] = peaks[j];
-                peaks[j] = temp;
-            }
+            best = k;
         }
     }
     
-    return peak_count;
+    if(best < 0)
+    {
+        return 0;
+    }
+    
+    float bin_pos = bin_start + zoom_interpolate(zoom_magnitude, best, points) / ZOOM_STEPS_PER_BIN;
+    
+    second->bin_index = (uint16_t)(bin_pos + 0.5f);
+    second->frequency = second->bin_index * freq_resolution;
+    second->precise_frequency = bin_pos * freq_resolution;
+    second->magnitude = zoom_dtft_magnitude(bin_pos);
+    return 1;
 }
 
 /**
  * @brief 寻找两个主要的基波频率峰值
+ * @details
+ * 先从频谱特征记录中取出粗峰值，再用细化频谱修正各峰值的频率和幅度。
+ * 只找到一个峰值时，在其附近的细化频谱中继续寻找间隔小于粗寻峰最小间隔的第二个分量。
  * @param sampling_freq 采样频率
  * @param min_threshold 最小阈值（相对于最大值的比例，建议0.1-0.3）
+ * @param psd_gate 1=当前帧已并入平均功率谱，用其门限剔除噪声峰，0=不使用
  * @return 双峰检测结果
  */
-dual_peak_result_t find_dual_peaks(float sampling_freq, float min_threshold)
+dual_peak_result_t find_dual_peaks(float sampling_freq, float min_threshold, uint8_t psd_gate)
 {
     dual_peak_result_t result = {0};
     peak_info_t temp_peaks[MAX_PEAKS];
     
     // 寻找所有峰值
-    uint8_t peak_count = find_spectrum_peaks(temp_peaks, MAX_PEAKS, sampling_freq, min_threshold);
+    uint8_t peak_count = find_spectrum_peaks(temp_peaks, MAX_PEAKS, sampling_freq, min_threshold, psd_gate);
+    
+    // 细化频谱修正前两个峰值
+    for(uint8_t i = 0; i < peak_count && i < 2; i++)
+    {
+        zoom_refine_peak(&temp_peaks[i], sampling_freq);
+    }
+    
+    // 相距过近的两个频率在粗寻峰中被合并，在主峰附近继续寻找
+    if(peak_count == 1)
+    {
+        float threshold = get_spectrum_features(sampling_freq)->max_magnitude * min_threshold;
+        peak_count += zoom_split_peak(&temp_peaks[0], sampling_freq, threshold, &temp_peaks[1]);
+    }
     
     result.peaks_found = (peak_count > 2) ? 2 : peak_count;
     
@@ -427,6 +905,20 @@ dual_peak_result_t find_dual_peaks(float sampling_freq, float min_threshold)
     return result;
 }
 
+/**
+ * @brief 将细化后的峰值频率对齐到1kHz网格
+ * @details 只有与最近的1kHz整数倍相差小于 PEAK_SNAP_TOLERANCE_HZ 时才取整，
+ *          不在网格上的频率保留细化结果。
+ * @param frequency 细化后的频率
+ * @return 输出频率
+ */
+static float snap_peak_frequency(float frequency)
+{
+    float rounded = round_to_nearest_k(frequency);
+    
+    return (fabsf(frequency - rounded) < PEAK_SNAP_TOLERANCE_HZ) ? rounded : frequency;
+}
+
 /**
  * @brief 输出双峰检测信息到串口并更新全局变量
  */
@@ -440,8 +932,8 @@ void output_dual_peaks_info(void)
     
     if(dual_peaks.peaks_found >= 1)
     {
-        // 将频率四舍五入为千的整数倍
-        float rounded_freq1 = round_to_nearest_k(dual_peaks.peak1.precise_frequency);
+        // 接近千的整数倍时取整
+        float rounded_freq1 = snap_peak_frequency(dual_peaks.peak1.precise_frequency);
         
         // 更新全局变量
         peak1_frequency = rounded_freq1;
@@ -454,7 +946,7 @@ void output_dual_peaks_info(void)
         
         if(dual_peaks.peaks_found >= 2)
         {
-            float rounded_freq2 = round_to_nearest_k(dual_peaks.peak2.precise_frequency);
+            float rounded_freq2 = snap_peak_frequency(dual_peaks.peak2.precise_frequency);
             
             // 更新全局变量
             peak2_frequency = rounded_freq2;
@@ -482,11 +974,40 @@ void perform_dual_peak_analysis(float* input_data, uint16_t data_length)
     // 获取采样频率
     float sampling_freq = get_current_ad_frequency();
     
-    // 执行FFT
+    // 执行FFT并提取频谱特征
     calculate_fft_spectrum(input_data, data_length);
+    extract_spectrum_features(sampling_freq);
+    
+    // 并入平均功率谱，寻峰时以其统计门限剔除噪声峰
+    psd_update(input_data, data_length, sampling_freq);
     
     // 执行双峰检测
-    dual_peaks = find_dual_peaks(sampling_freq, 0.15f);  // 阈值为最大值的15%
+    dual_peaks = find_dual_peaks(sampling_freq, 0.15f, 1);  // 阈值为最大值的15%
+    
+    // 逐个扣除分量后重新估计，纠正谐波与基波重叠、两峰相距过近时的误检
+    clean_result_t clean;
+    if(clean_separate(input_data, data_length, sampling_freq, 0.15f, &clean) > 0)
+    {
+        clean_to_dual_peaks(&clean, sampling_freq, &dual_peaks);
+        my_printf(&huart1, "CLEAN: %d components, %d iterations, residual %.4fV / %.4fV rms\r\n",
+                  clean.count, clean.iterations, clean.residual_rms, clean.signal_rms);
+    }
+    
+    // 与前几帧的峰值关联，轨迹稳定后以滤波结果代替单帧检测结果
+    peak_info_t frame_peaks[2] = {dual_peaks.peak1, dual_peaks.peak2};
+    uint8_t confirmed = peak_tracker_update(frame_peaks, dual_peaks.peaks_found,
+                                            sampling_freq / fft_context.length);
+    if(peak_tracker_apply(&dual_peaks))
+    {
+        const peak_track_t* tracks[TRACKER_MAX_TRACKS];
+        uint8_t count = peak_tracker_get_confirmed(tracks, TRACKER_MAX_TRACKS);
+        my_printf(&huart1, "Tracked: %d confirmed\r\n", confirmed);
+        for(uint8_t i = 0; i < count; i++)
+        {
+            my_printf(&huart1, "  Track %d: %.2f Hz, %.4fV, confidence %.2f\r\n",
+                      tracks[i]->id, tracks[i]->freq.x, tracks[i]->amp.x, tracks[i]->confidence);
+        }
+    }
     
     // 输出结果
     output_dual_peaks_info();
@@ -531,32 +1052,32 @@ float get_peak2_magnitude(void)
 /**
  * @brief 根据双峰检测结果配置DA输出
  * @details 
- * 该函数根据检测到的两个峰值的频率和幅度，自动配置DA1和DA2的输出：
+ * 该函数根据检测到的两个峰值的频率，自动配置DA1和DA2的输出：
  * - DA1输出频率A对应的波形
  * - DA2输出频率B对应的波形
- * - 根据幅度判断波形类型：>0.3V为正弦波，<0.3V为三角波
+ * - 波形类型由 classify_waveforms() 根据最近一次FFT数据中各基波的谐波幅度比和相位判定
  */
 void configure_da_output_from_peaks(void)
 {
-    // 根据检测结果配置DA输出
-    if(peak1_frequency > 0.0f) // 检测到第一个峰值
-    {
-        Waveform_t wave_a = (peak1_magnitude > 0.300f) ? WAVE_SINE : WAVE_TRIANGLE;
-        const char* wave_name_a = (peak1_magnitude > 0.300f) ? "SINE" : "TRIANGLE";
-        
-        // 配置DA1输出频率A对应的波形
-        DA_SetConfig(0, peak1_frequency, 1000, 0, wave_a);
-        my_printf(&huart1,"A: %s, DA1: %.0f Hz\r\n", wave_name_a, peak1_frequency);
-    }
+    float frequencies[2] = {peak1_frequency, peak2_frequency};
+    waveform_class_t classes[2];
+    
+    classify_waveforms(spectrum_source, spectrum_source_length, get_current_ad_frequency(),
+                       frequencies, 2, classes);
     
-    if(peak2_frequency > 0.0f) // 检测到第二个峰值
+    // 根据检测结果配置DA输出
+    for(uint8_t i = 0; i < 2; i++)
     {
-        Waveform_t wave_b = (peak2_magnitude > 0.300f) ? WAVE_SINE : WAVE_TRIANGLE;
-        const char* wave_name_b = (peak2_magnitude > 0.300f) ? "SINE" : "TRIANGLE";
+        if(frequencies[i] <= 0.0f) // 未检测到该峰值
+        {
+            continue;
+        }
         
-        // 配置DA2输出频率B对应的波形
-        DA_SetConfig(1, peak2_frequency, 1000, 0, wave_b);
-        my_printf(&huart1,"B: %s, DA2: %.0f Hz\r\n", wave_name_b, peak2_frequency);
+        // 配置DA1/DA2输出频率A/B对应的波形
+        DA_SetConfig(i, frequencies[i], 1000, 0, classes[i].waveform);
+        my_printf(&huart1,"%c: %s, DA%d: %.0f Hz (H3 %.3f, H5 %.3f, d %.4f)\r\n", 'A' + i,
+                  waveform_name(classes[i].waveform), i + 1, frequencies[i],
+                  classes[i].ratio[3], classes[i].ratio[5], classes[i].distance);
     }
     
     // 应用DA配置到硬件
@@ -570,3 +1091,82 @@ void configure_da_output_from_peaks(void)
         my_printf(&huart1,"No valid peaks found, DA unchanged\r\n");
     }
 }
+
+/**
+ * @brief 根据当前频谱的谐波幅度和相位配置DA多音输出
+ * @details
+ * 需在 calculate_fft_spectrum() 之后调用，此时 fft_spectrum_buffer 中保存着复数频谱。
+ * 依次读取基波及其2~DA_MT_TONES次谐波所在bin的幅度与相位：
+ * - 幅度以各谐波幅度之和归一化，整体幅度仍由通道VPP控制；
+ * - 相位换算为相对基波的初相 phi_k - k*phi_1，使DA输出复现被测信号的波形形状。
+ *   FFT相位以余弦为参考，换算到正弦参考需再减去 (k-1)*90 度。
+ * 配置完成后切换该通道为多音波形并应用设置。
+ * @param channel_index DA通道索引 (0 for DA1, 1 for DA2)
+ * @param fundamental_bin 基波所在的FFT bin
+ * @return 实际写入的谐波分量个数，0表示未配置
+ */
+uint8_t configure_da_multitone_from_spectrum(uint8_t channel_index, uint16_t fundamental_bin)
+{
+    DA_Tone_t tones[DA_MT_TONES];
+    uint8_t count = 0;
+
+    if(fundamental_bin < 1 || fundamental_bin >= fft_context.length / 2)
+    {
+        return 0;
+    }
+
+    float fund_mag = fft_magnitude[fundamental_bin];
+    if(fund_mag <= 0.0f)
+    {
+        return 0;
+    }
+
+    float fund_phase = atan2f(fft_spectrum_buffer[2 * fundamental_bin + 1], fft_spectrum_buffer[2 * fundamental_bin]);
+
+    for(uint8_t k = 1; k <= DA_MT_TONES; k++)
+    {
+        uint16_t bin = k * fundamental_bin;
+        if(bin >= fft_context.length / 2)
+        {
+            break;
+        }
+
+        float mag = fft_magnitude[bin];
+        // 忽略低于基波1%的谐波，避免把噪声当成分量输出
+        if(mag < 0.01f * fund_mag)
+        {
+            continue;
+        }
+
+        float phase = atan2f(fft_spectrum_buffer[2 * bin + 1], fft_spectrum_buffer[2 * bin]);
+        float rel_deg = (phase - k * fund_phase) * 180.0f / PI - (k - 1) * 90.0f;
+        rel_deg = fmodf(rel_deg, 360.0f);
+        if(rel_deg < 0.0f)
+        {
+            rel_deg += 360.0f;
+        }
+
+        tones[count].harmonic = k;
+        tones[count].amplitude = mag;
+        tones[count].phase = (uint16_t)rel_deg % 360;
+        count++;
+    }
+
+    // 以幅度之和归一化 (DA_SetMultitone 只在和超过1时缩小)
+    float amp_sum = 0.0f;
+    for(uint8_t i = 0; i < count; i++)
+    {
+        amp_sum += tones[i].amplitude;
+    }
+    for(uint8_t i = 0; i < count; i++)
+    {
+        tones[i].amplitude /= amp_sum;
+    }
+
+    DA_SetMultitone(channel_index, tones, count);
+    DA_Apply_Settings();
+
+    my_printf(&huart1, "DA%d multitone: %d tones, fundamental bin %d\r\n", channel_index + 1, count, fundamental_bin);
+
+    return count;
+}
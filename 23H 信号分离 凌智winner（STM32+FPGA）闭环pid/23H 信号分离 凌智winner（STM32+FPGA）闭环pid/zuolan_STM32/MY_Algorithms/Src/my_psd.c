@@ -0,0 +1,395 @@
+/**
+ * @file my_psd.c
+ * @brief Welch法功率谱密度(PSD)估计实现
+ * @details
+ * 1. 分段：相邻分段起点间隔 segment_step，重叠部分被两段共用。
+ * 2. 每段去除均值后加窗，做实数FFT，按 P[k] = 2|X[k]|^2 / (fs * S2) 校准为单边PSD，
+ *    其中 S2 为窗函数平方和，直流和Nyquist分量不乘2。
+ * 3. 各段周期图按线性或指数方式并入平均结果，平均跨越多次采集连续进行。
+ * 4. 频带功率 = sum(P[k]) * bin宽度，开方即为均方根值。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#include "my_psd.h"
+#include <math.h>
+
+#define PSD_MAX_OVERLAP 0.9f // 最大重叠比例
+#define PSD_OVERLAP_LAGS 4   // 估计重叠分段相关性时考虑的最大间隔段数
+
+psd_state_t psd_state;
+
+// 分段FFT的输入/输出缓冲区，求中位数时复用输入缓冲区 (借用 fft_scratch，只在函数内部有效)
+static float* const psd_segment = fft_scratch[0];
+static float* const psd_spectrum = fft_scratch[1];
+// 重叠导致相邻段相关，平均的有效段数 = 段数 * psd_overlap_efficiency
+static float psd_overlap_efficiency = 1.0f;
+
+/**
+ * @brief 计算重叠分段平均的效率系数
+ * @details 相隔j段的两段周期图的相关系数为 c_j = (sum w[n]w[n+j*step])^2 / S2^2，
+ *          段数较多时平均的方差缩小为 (1 + 2*sum c_j) / K，据此换算有效段数。
+ */
+static void psd_update_overlap_efficiency(void)
+{
+    psd_state_t* s = &psd_state;
+    float sum_c = 0.0f;
+
+    for(uint8_t j = 1; j <= PSD_OVERLAP_LAGS; j++)
+    {
+        uint32_t shift = (uint32_t)j * s->segment_step;
+        if(shift >= s->segment_length)
+        {
+            break;
+        }
+
+        float acc = 0.0f;
+        for(uint16_t n = 0; n + shift < s->segment_length; n++)
+        {
+            acc += s->window_buffer[n] * s->window_buffer[n + shift];
+        }
+        sum_c += (acc * acc) / (s->window_power * s->window_power);
+    }
+
+    psd_overlap_efficiency = 1.0f / (1.0f + 2.0f * sum_c);
+}
+
+uint8_t psd_init(uint16_t segment_length, float overlap, window_type_t window, psd_average_t average, float alpha)
+{
+    psd_state_t* s = &psd_state;
+
+    if(segment_length != 256 && segment_length != 512 && segment_length != 1024)
+    {
+        return 0;
+    }
+    if(arm_rfft_fast_init_f32(&s->rfft, segment_length) != ARM_MATH_SUCCESS)
+    {
+        return 0;
+    }
+
+    if(overlap < 0.0f) overlap = 0.0f;
+    if(overlap > PSD_MAX_OVERLAP) overlap = PSD_MAX_OVERLAP;
+    if(alpha <= 0.0f || alpha > 1.0f) alpha = 0.1f;
+
+    s->segment_length = segment_length;
+    s->segment_step = segment_length - (uint16_t)(overlap * segment_length);
+    s->window = window;
+    s->average = average;
+    s->alpha = alpha;
+
+    generate_window(window, s->window_buffer, segment_length);
+    s->window_power = 0.0f;
+    for(uint16_t i = 0; i < segment_length; i++)
+    {
+        s->window_power += s->window_buffer[i] * s->window_buffer[i];
+    }
+
+    psd_update_overlap_efficiency();
+    psd_reset();
+    return 1;
+}
+
+void psd_reset(void)
+{
+    psd_state.segments = 0;
+    psd_state.sampling_freq = 0.0f;
+    memset(psd_state.psd, 0, sizeof(psd_state.psd));
+}
+
+/**
+ * @brief 计算一段数据的周期图并并入平均结果
+ */
+static void psd_accumulate_segment(const float* data)
+{
+    psd_state_t* s = &psd_state;
+    uint16_t n = s->segment_length;
+    float mean = 0.0f;
+
+    // 去直流后加窗
+    for(uint16_t i = 0; i < n; i++)
+    {
+        mean += data[i];
+    }
+    mean /= n;
+    for(uint16_t i = 0; i < n; i++)
+    {
+        psd_segment[i] = (data[i] - mean) * s->window_buffer[i];
+    }
+
+    arm_rfft_fast_f32(&s->rfft, psd_segment, psd_spectrum, 0);
+
+    float scale = 1.0f / (s->sampling_freq * s->window_power);
+    float weight;
+    if(s->average == PSD_AVERAGE_LINEAR || s->segments == 0)
+    {
+        weight = 1.0f / (s->segments + 1);
+    }
+    else
+    {
+        weight = s->alpha;
+    }
+
+    // 一次遍历完成校准和平均，打包格式中 [0]=直流, [1]=Nyquist
+    float p = psd_spectrum[0] * psd_spectrum[0] * scale;
+    s->psd[0] += weight * (p - s->psd[0]);
+    p = psd_spectrum[1] * psd_spectrum[1] * scale;
+    s->psd[n / 2] += weight * (p - s->psd[n / 2]);
+    for(uint16_t k = 1; k < n / 2; k++)
+    {
+        float re = psd_spectrum[2 * k];
+        float im = psd_spectrum[2 * k + 1];
+        p = 2.0f * (re * re + im * im) * scale;
+        s->psd[k] += weight * (p - s->psd[k]);
+    }
+
+    s->segments++;
+}
+
+uint16_t psd_update(const float* data, uint16_t length, float sampling_freq)
+{
+    psd_state_t* s = &psd_state;
+    uint16_t count = 0;
+
+    if(s->segment_length == 0 || data == NULL || sampling_freq <= 0.0f)
+    {
+        return 0;
+    }
+
+    // 采样率变化后旧结果的频率轴不再对应
+    if(s->sampling_freq != sampling_freq)
+    {
+        psd_reset();
+        s->sampling_freq = sampling_freq;
+    }
+
+    for(uint32_t start = 0; start + s->segment_length <= length; start += s->segment_step)
+    {
+        psd_accumulate_segment(&data[start]);
+        count++;
+    }
+
+    return count;
+}
+
+float psd_bin_width(void)
+{
+    if(psd_state.segment_length == 0)
+    {
+        return 0.0f;
+    }
+
+    return psd_state.sampling_freq / psd_state.segment_length;
+}
+
+float psd_band_rms(float f_low, float f_high)
+{
+    psd_state_t* s = &psd_state;
+    float df = psd_bin_width();
+
+    if(df <= 0.0f || f_high < f_low)
+    {
+        return 0.0f;
+    }
+
+    int32_t lo = (int32_t)(f_low / df + 0.5f);
+    int32_t hi = (int32_t)(f_high / df + 0.5f);
+    if(lo < 0) lo = 0;
+    if(hi > s->segment_length / 2) hi = s->segment_length / 2;
+
+    float power = 0.0f;
+    for(int32_t k = lo; k <= hi; k++)
+    {
+        power += s->psd[k];
+    }
+
+    return sqrtf(power * df);
+}
+
+float psd_tone_rms(uint16_t bin)
+{
+    float df = psd_bin_width();
+    uint8_t lobe = window_lobe_bins(psd_state.window);
+    float center = bin * df;
+
+    return psd_band_rms(center - lobe * df, center + lobe * df);
+}
+
+/**
+ * @brief 有效平均段数 (计入重叠相关性和指数平均的等效长度)
+ */
+static float psd_effective_averages(void)
+{
+    psd_state_t* s = &psd_state;
+    float k = (float)s->segments;
+
+    if(s->average == PSD_AVERAGE_EXPONENTIAL)
+    {
+        float k_exp = (2.0f - s->alpha) / s->alpha;
+        if(k > k_exp)
+        {
+            k = k_exp;
+        }
+    }
+
+    k *= psd_overlap_efficiency;
+    return (k < 1.0f) ? 1.0f : k;
+}
+
+/**
+ * @brief Wilson-Hilferty近似：自由度为dof的卡方分布的z分位数除以dof
+ */
+static float psd_chi2_ratio(float dof, float z)
+{
+    float h = 2.0f / (9.0f * dof);
+    float t = 1.0f - h + z * sqrtf(h);
+
+    return t * t * t;
+}
+
+/**
+ * @brief 快速选择算法求第k小的元素 (会打乱数组顺序)
+ */
+static float psd_select(float* data, uint16_t count, uint16_t k)
+{
+    uint16_t left = 0;
+    uint16_t right = count - 1;
+
+    while(left < right)
+    {
+        float pivot = data[(left + right) / 2];
+        uint16_t i = left;
+        uint16_t j = right;
+
+        while(i <= j)
+        {
+            while(data[i] < pivot) i++;
+            while(data[j] > pivot) j--;
+            if(i <= j)
+            {
+                float tmp = data[i];
+                data[i] = data[j];
+                data[j] = tmp;
+                i++;
+                if(j == 0) break;
+                j--;
+            }
+        }
+
+        if(k <= j)
+        {
+            right = j;
+        }
+        else if(k >= i)
+        {
+            left = i;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    return data[k];
+}
+
+float psd_noise_floor(void)
+{
+    psd_state_t* s = &psd_state;
+    uint16_t count = s->segment_length / 2 - 1;
+
+    if(s->segments == 0 || count == 0)
+    {
+        return 0.0f;
+    }
+
+    // 去掉直流和Nyquist，中位数对少量信号分量不敏感
+    memcpy(psd_segment, &s->psd[1], count * sizeof(float));
+    float median = psd_select(psd_segment, count, count / 2);
+
+    // 中位数 / 均值 = 卡方分布中位数 / 自由度
+    return median / psd_chi2_ratio(2.0f * psd_effective_averages(), 0.0f);
+}
+
+float psd_detection_threshold(float z)
+{
+    float dof = 2.0f * psd_effective_averages();
+
+    return psd_noise_floor() * psd_chi2_ratio(dof, z);
+}
+
+uint8_t psd_find_peaks(peak_info_t* peaks, uint8_t max_peaks, float z)
+{
+    psd_state_t* s = &psd_state;
+    uint8_t count = 0;
+    uint8_t lobe = window_lobe_bins(s->window);
+    float df = psd_bin_width();
+
+    if(s->segments == 0 || max_peaks == 0)
+    {
+        return 0;
+    }
+
+    float noise = psd_noise_floor();
+    float threshold = noise * psd_chi2_ratio(2.0f * psd_effective_averages(), z);
+    float noise_rms2 = noise * (2 * lobe + 1) * df; // 主瓣范围内噪声功率的期望值
+
+    for(uint16_t k = lobe + 1; k + lobe < s->segment_length / 2; k++)
+    {
+        float p = s->psd[k];
+        if(p <= threshold)
+        {
+            continue;
+        }
+
+        // 主瓣范围内的最大值才算一个峰值
+        uint8_t is_peak = 1;
+        for(uint8_t j = 1; j <= lobe && is_peak; j++)
+        {
+            if(s->psd[k - j] >= p || s->psd[k + j] > p)
+            {
+                is_peak = 0;
+            }
+        }
+        if(!is_peak)
+        {
+            continue;
+        }
+
+        // 对数域抛物线插值 (主瓣近似高斯形)
+        float y1 = logf(s->psd[k - 1] + 1e-30f);
+        float y2 = logf(p);
+        float y3 = logf(s->psd[k + 1] + 1e-30f);
+        float denom = y1 - 2.0f * y2 + y3;
+        float delta = (fabsf(denom) > 1e-12f) ? 0.5f * (y1 - y3) / denom : 0.0f;
+        if(delta > 0.5f) delta = 0.5f;
+        if(delta < -0.5f) delta = -0.5f;
+
+        peak_info_t peak;
+        peak.bin_index = k;
+        peak.frequency = k * df;
+        peak.precise_frequency = (k + delta) * df;
+        // 扣除主瓣内噪声功率的期望值后，由均方根值换算为峰值幅度
+        float tone_rms = psd_tone_rms(k);
+        float tone_power = tone_rms * tone_rms - noise_rms2;
+        peak.magnitude = sqrtf((tone_power > 0.0f) ? 2.0f * tone_power : 0.0f);
+
+        // 插入排序，保持幅度降序
+        uint8_t pos = (count < max_peaks) ? count : max_peaks - 1;
+        if(count == max_peaks && peak.magnitude <= peaks[pos].magnitude)
+        {
+            continue;
+        }
+        while(pos > 0 && peaks[pos - 1].magnitude < peak.magnitude)
+        {
+            peaks[pos] = peaks[pos - 1];
+            pos--;
+        }
+        peaks[pos] = peak;
+        if(count < max_peaks)
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
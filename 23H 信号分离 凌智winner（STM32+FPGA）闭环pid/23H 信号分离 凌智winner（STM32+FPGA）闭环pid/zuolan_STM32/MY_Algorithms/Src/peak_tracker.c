@@ -0,0 +1,290 @@
+/**
+ * @file peak_tracker.c
+ * @brief 多帧频谱峰值跟踪器实现
+ * @details
+ * 1. 关联：以轨迹当前的滤波频率为预测值，在门限内按"距离最近优先"贪心配对。
+ * 2. 滤波：命中的轨迹用 kalman_filter() 更新频率和幅度；丢失的轨迹只做预测，
+ *    误差协方差增加Q，重新命中时新测量的权重更大。
+ * 3. 管理：更新置信度，确认或删除轨迹，未关联的峰值产生新轨迹。
+ * 4. 输出：只使用本帧命中 (misses == 0) 的确认轨迹。丢失中的轨迹仍保留以便信号短暂消失后恢复，
+ *    但其频率是旧信号的，不能代替本帧的检测结果。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#include "peak_tracker.h"
+#include <math.h>
+
+// 频率滤波噪声 (以bin宽度为单位)：细化后的频率测量误差约0.1 bin，频率漂移很慢
+#define TRACKER_FREQ_R_BINS 0.1f
+#define TRACKER_FREQ_Q_BINS 0.02f
+// 幅度滤波噪声 (相对幅度)
+#define TRACKER_AMP_R_RATIO 0.05f
+#define TRACKER_AMP_Q_RATIO 0.01f
+
+peak_track_t peak_tracks[TRACKER_MAX_TRACKS];
+
+static float tracker_bin_width = 0.0f; // 当前轨迹所对应的频率分辨率
+static uint16_t tracker_next_id = 1;   // 下一条新轨迹的编号
+
+void peak_tracker_reset(void)
+{
+    memset(peak_tracks, 0, sizeof(peak_tracks));
+    tracker_bin_width = 0.0f;
+}
+
+/**
+ * @brief 由一个未关联的峰值产生新轨迹
+ * @return 1=成功，0=没有空闲轨迹
+ */
+static uint8_t tracker_birth(const peak_info_t* peak)
+{
+    for(uint8_t t = 0; t < TRACKER_MAX_TRACKS; t++)
+    {
+        peak_track_t* track = &peak_tracks[t];
+        if(track->active)
+        {
+            continue;
+        }
+
+        float r_freq = TRACKER_FREQ_R_BINS * tracker_bin_width;
+        float r_amp = TRACKER_AMP_R_RATIO * peak->magnitude;
+
+        memset(track, 0, sizeof(peak_track_t));
+        track->active = 1;
+        track->hits = 1;
+        track->id = tracker_next_id++;
+        track->confidence = TRACKER_CONF_ALPHA;
+
+        Kalman_init(&track->freq, peak->precise_frequency, r_freq * r_freq);
+        track->freq.R = r_freq * r_freq;
+        track->freq.Q = (TRACKER_FREQ_Q_BINS * tracker_bin_width) * (TRACKER_FREQ_Q_BINS * tracker_bin_width);
+
+        Kalman_init(&track->amp, peak->magnitude, r_amp * r_amp);
+        track->amp.R = r_amp * r_amp;
+        track->amp.Q = (TRACKER_AMP_Q_RATIO * peak->magnitude) * (TRACKER_AMP_Q_RATIO * peak->magnitude);
+        return 1;
+    }
+
+    return 0;
+}
+
+uint8_t peak_tracker_update(const peak_info_t* peaks, uint8_t count, float bin_width)
+{
+    uint8_t peak_used[MAX_PEAKS] = {0};
+    uint8_t track_hit[TRACKER_MAX_TRACKS] = {0};
+    uint8_t confirmed = 0;
+
+    if(count > MAX_PEAKS)
+    {
+        count = MAX_PEAKS;
+    }
+
+    // 频率分辨率改变后旧轨迹的噪声参数和门限不再适用
+    if(bin_width != tracker_bin_width)
+    {
+        peak_tracker_reset();
+        tracker_bin_width = bin_width;
+    }
+
+    float gate = TRACKER_GATE_BINS * bin_width;
+
+    // 贪心关联：每次取距离最近的一对 (轨迹, 峰值)
+    while(1)
+    {
+        int8_t best_track = -1;
+        int8_t best_peak = -1;
+        float best_dist = gate;
+
+        for(uint8_t t = 0; t < TRACKER_MAX_TRACKS; t++)
+        {
+            if(!peak_tracks[t].active || track_hit[t])
+            {
+                continue;
+            }
+            for(uint8_t p = 0; p < count; p++)
+            {
+                float dist = fabsf(peaks[p].precise_frequency - peak_tracks[t].freq.x);
+                if(!peak_used[p] && dist < best_dist)
+                {
+                    best_dist = dist;
+                    best_track = t;
+                    best_peak = p;
+                }
+            }
+        }
+
+        if(best_track < 0)
+        {
+            break;
+        }
+
+        peak_track_t* track = &peak_tracks[best_track];
+        kalman_filter(&track->freq, peaks[best_peak].precise_frequency);
+        kalman_filter(&track->amp, peaks[best_peak].magnitude);
+        if(track->hits < 0xFFFF)
+        {
+            track->hits++;
+        }
+        track->misses = 0;
+        track_hit[best_track] = 1;
+        peak_used[best_peak] = 1;
+    }
+
+    // 更新置信度，确认或删除轨迹
+    for(uint8_t t = 0; t < TRACKER_MAX_TRACKS; t++)
+    {
+        peak_track_t* track = &peak_tracks[t];
+        if(!track->active)
+        {
+            continue;
+        }
+
+        if(!track_hit[t])
+        {
+            // 只做预测：状态不变，误差协方差增大
+            track->misses++;
+            track->freq.p += track->freq.Q;
+            track->amp.p += track->amp.Q;
+        }
+
+        track->confidence += TRACKER_CONF_ALPHA * ((track_hit[t] ? 1.0f : 0.0f) - track->confidence);
+
+        if(!track->confirmed && track->hits >= TRACKER_CONFIRM_HITS &&
+           track->confidence >= TRACKER_CONFIRM_LEVEL)
+        {
+            track->confirmed = 1;
+        }
+
+        if(track->misses > TRACKER_MAX_MISSES || track->confidence < TRACKER_DROP_LEVEL)
+        {
+            track->active = 0;
+        }
+    }
+
+    // 未关联的峰值产生新轨迹
+    for(uint8_t p = 0; p < count; p++)
+    {
+        if(!peak_used[p] && peaks[p].magnitude > 0.0f)
+        {
+            tracker_birth(&peaks[p]);
+        }
+    }
+
+    for(uint8_t t = 0; t < TRACKER_MAX_TRACKS; t++)
+    {
+        if(peak_tracks[t].active && peak_tracks[t].confirmed)
+        {
+            confirmed++;
+        }
+    }
+
+    return confirmed;
+}
+
+uint8_t peak_tracker_get_confirmed(const peak_track_t** tracks, uint8_t max_tracks)
+{
+    uint8_t count = 0;
+
+    for(uint8_t t = 0; t < TRACKER_MAX_TRACKS; t++)
+    {
+        const peak_track_t* track = &peak_tracks[t];
+        if(!track->active || !track->confirmed || track->misses > 0)
+        {
+            continue;
+        }
+
+        // 插入排序，按滤波后的幅度降序
+        uint8_t pos = (count < max_tracks) ? count : max_tracks;
+        if(pos == max_tracks && (max_tracks == 0 || track->amp.x <= tracks[max_tracks - 1]->amp.x))
+        {
+            continue;
+        }
+        if(pos == max_tracks)
+        {
+            pos--;
+        }
+        while(pos > 0 && tracks[pos - 1]->amp.x < track->amp.x)
+        {
+            tracks[pos] = tracks[pos - 1];
+            pos--;
+        }
+        tracks[pos] = track;
+        if(count < max_tracks)
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief 由轨迹生成峰值信息
+ */
+static void tracker_to_peak(const peak_track_t* track, peak_info_t* peak)
+{
+    peak->precise_frequency = track->freq.x;
+    peak->magnitude = track->amp.x;
+    peak->bin_index = (tracker_bin_width > 0.0f) ? (uint16_t)(track->freq.x / tracker_bin_width + 0.5f) : 0;
+    peak->frequency = peak->bin_index * tracker_bin_width;
+}
+
+/**
+ * @brief 查找本帧命中、且由该峰值更新过的确认轨迹
+ * @return 轨迹，没有时返回NULL
+ */
+static const peak_track_t* tracker_find_hit(const peak_info_t* peak)
+{
+    const peak_track_t* best = NULL;
+    float best_dist = TRACKER_GATE_BINS * tracker_bin_width;
+
+    for(uint8_t t = 0; t < TRACKER_MAX_TRACKS; t++)
+    {
+        const peak_track_t* track = &peak_tracks[t];
+        float dist = fabsf(track->freq.x - peak->precise_frequency);
+        if(track->active && track->confirmed && track->misses == 0 && dist < best_dist)
+        {
+            best_dist = dist;
+            best = track;
+        }
+    }
+
+    return best;
+}
+
+uint8_t peak_tracker_apply(dual_peak_result_t* result)
+{
+    peak_info_t* peaks[2] = {&result->peak1, &result->peak2};
+    uint8_t replaced = 0;
+
+    for(uint8_t i = 0; i < result->peaks_found && i < 2; i++)
+    {
+        const peak_track_t* track = tracker_find_hit(peaks[i]);
+        if(track != NULL)
+        {
+            tracker_to_peak(track, peaks[i]);
+            replaced++;
+        }
+    }
+
+    if(replaced == 0)
+    {
+        return 0;
+    }
+
+    if(result->peaks_found >= 2)
+    {
+        result->freq_separation = fabsf(result->peak1.precise_frequency - result->peak2.precise_frequency);
+
+        // 保持peak1的频率小于peak2
+        if(result->peak1.precise_frequency > result->peak2.precise_frequency)
+        {
+            peak_info_t temp = result->peak1;
+            result->peak1 = result->peak2;
+            result->peak2 = temp;
+        }
+    }
+
+    return 1;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file pid_autotune.c
+ * @brief 继电反馈PID自整定实现
+ * @details
+ * 每次由负向切换到正向输出记为一个周期的起点，两次之间的控制周期数即为振荡周期，
+ * 期间测量值的 (max - min)/2 即为振荡幅度 a。开始的 AUTOTUNE_SETTLE_CYCLES 个周期为过渡过程，不计入平均。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#include "pid_autotune.h"
+#include <string.h>
+
+void pid_autotune_start(pid_autotune_t* tune, float setpoint, float bias, float amplitude, float hysteresis)
+{
+    memset(tune, 0, sizeof(pid_autotune_t));
+    tune->setpoint = setpoint;
+    tune->bias = bias;
+    tune->amplitude = amplitude;
+    tune->hysteresis = hysteresis;
+    tune->cycles = AUTOTUNE_DEFAULT_CYCLES;
+    tune->timeout = AUTOTUNE_DEFAULT_TIMEOUT;
+    tune->relay = 1;
+    tune->y_max = -3.4e38f;
+    tune->y_min = 3.4e38f;
+    tune->state = AUTOTUNE_RUNNING;
+}
+
+float pid_autotune_update(pid_autotune_t* tune, float measurement)
+{
+    if(tune->state != AUTOTUNE_RUNNING)
+    {
+        return tune->bias;
+    }
+
+    float error = tune->setpoint - measurement;
+    if(measurement > tune->y_max) tune->y_max = measurement;
+    if(measurement < tune->y_min) tune->y_min = measurement;
+
+    if(tune->relay > 0 && error < -tune->hysteresis)
+    {
+        tune->relay = -1;
+    }
+    else if(tune->relay < 0 && error > tune->hysteresis)
+    {
+        tune->relay = 1;
+
+        // 一个完整振荡周期结束
+        if(tune->rises > AUTOTUNE_SETTLE_CYCLES)
+        {
+            tune->period_sum += (float)(tune->samples - tune->last_rise);
+            tune->swing_sum += 0.5f * (tune->y_max - tune->y_min);
+            tune->measured++;
+        }
+        tune->rises++;
+        tune->last_rise = tune->samples;
+        tune->y_max = measurement;
+        tune->y_min = measurement;
+
+        if(tune->measured >= tune->cycles)
+        {
+            float swing = tune->swing_sum / tune->measured;
+            tune->tu = tune->period_sum / tune->measured;
+            if(swing > 0.0f && tune->tu >= 2.0f)
+            {
+                tune->ku = 4.0f * tune->amplitude / (PI * swing);
+                tune->state = AUTOTUNE_DONE;
+            }
+            else
+            {
+                tune->state = AUTOTUNE_FAILED;
+            }
+            return tune->bias;
+        }
+    }
+
+    tune->samples++;
+    if(tune->samples >= tune->timeout)
+    {
+        tune->state = AUTOTUNE_FAILED;
+        return tune->bias;
+    }
+
+    return tune->bias + tune->relay * tune->amplitude;
+}
+
+uint8_t pid_autotune_gains(const pid_autotune_t* tune, autotune_rule_t rule, float* kp, float* ki, float* kd)
+{
+    if(tune->state != AUTOTUNE_DONE)
+    {
+        return 0;
+    }
+
+    // Ki = Kp / Ti，Kd = Kp * Td (Ti、Td 以控制周期数计)
+    switch(rule)
+    {
+        case AUTOTUNE_RULE_ZN_PI:
+            *kp = 0.45f * tune->ku;
+            *ki = *kp * 1.2f / tune->tu;
+            *kd = 0.0f;
+            break;
+        case AUTOTUNE_RULE_ZN_PID:
+            *kp = 0.6f * tune->ku;
+            *ki = *kp * 2.0f / tune->tu;
+            *kd = *kp * tune->tu / 8.0f;
+            break;
+        case AUTOTUNE_RULE_NO_OVERSHOOT:
+        default:
+            *kp = 0.2f * tune->ku;
+            *ki = *kp * 2.0f / tune->tu;
+            *kd = *kp * tune->tu / 3.0f;
+            break;
+    }
+
+    return 1;
+}
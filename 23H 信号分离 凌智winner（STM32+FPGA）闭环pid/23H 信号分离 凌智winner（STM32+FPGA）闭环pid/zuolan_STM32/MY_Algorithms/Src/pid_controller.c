@@ -0,0 +1,189 @@
+/**
+ * @file pid_controller.c
+ * @brief 定周期PID控制器实现
+ * @details
+ * Q31版本中间结果用64位累加，只在写回状态和输出时饱和到Q31；
+ * 增益乘法为 (k * x) >> (31 - shift)，误差差分等可能超出Q31的量先饱和再相乘，保证乘积不溢出64位。
+ * 因此未限幅输出与限幅输出之差超过满量程时，反计算量按满量程饱和，与浮点版本的暂态略有差别。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#include "pid_controller.h"
+#include <math.h>
+#include <string.h>
+
+#define PID_UNLIMITED 3.4e38f // 默认输出上下限 (不限幅)
+
+/**
+ * @brief 按slew和上下限限制输出
+ */
+static float pid_limit(const pid_ctrl_t* pid, float output)
+{
+    if(pid->slew > 0.0f)
+    {
+        if(output > pid->output + pid->slew) output = pid->output + pid->slew;
+        if(output < pid->output - pid->slew) output = pid->output - pid->slew;
+    }
+    if(output > pid->out_max) output = pid->out_max;
+    if(output < pid->out_min) output = pid->out_min;
+
+    return output;
+}
+
+void pid_init(pid_ctrl_t* pid, pid_form_t form, float kp, float ki, float kd)
+{
+    memset(pid, 0, sizeof(pid_ctrl_t));
+    pid->form = form;
+    pid->kp = kp;
+    pid->ki = ki;
+    pid->kd = kd;
+    pid->d_alpha = 1.0f;
+    pid->out_min = -PID_UNLIMITED;
+    pid->out_max = PID_UNLIMITED;
+}
+
+void pid_reset(pid_ctrl_t* pid, float output)
+{
+    pid->integral = (pid->form == PID_FORM_POSITIONAL) ? output : 0.0f;
+    pid->derivative = 0.0f;
+    pid->prev_error = 0.0f;
+    pid->feedforward = 0.0f;
+    pid->output = output;
+}
+
+float pid_update(pid_ctrl_t* pid, float setpoint, float measurement, float feedforward)
+{
+    float error = setpoint - measurement;
+    float derivative = pid->derivative + pid->d_alpha * (pid->kd * (error - pid->prev_error) - pid->derivative);
+    float output;
+
+    if(pid->form == PID_FORM_INCREMENTAL)
+    {
+        output = pid->output + pid->kp * (error - pid->prev_error) + pid->ki * error
+               + (derivative - pid->derivative) + (feedforward - pid->feedforward);
+        output = pid_limit(pid, output);
+    }
+    else
+    {
+        pid->integral += pid->ki * error;
+        if(pid->integral_limit > 0.0f)
+        {
+            pid->integral = fmaxf(fminf(pid->integral, pid->integral_limit), -pid->integral_limit);
+        }
+
+        float unsaturated = pid->kp * error + pid->integral + derivative + feedforward;
+        output = pid_limit(pid, unsaturated);
+        pid->integral += pid->kt * (output - unsaturated); // 反计算：输出被限幅时回退积分项
+    }
+
+    pid->derivative = derivative;
+    pid->prev_error = error;
+    pid->feedforward = feedforward;
+    pid->output = output;
+    return output;
+}
+
+/**
+ * @brief 浮点数转Q31 (饱和)
+ */
+static q31_t pid_to_q31(float x)
+{
+    if(x >= 1.0f) return 0x7FFFFFFF;
+    if(x <= -1.0f) return (q31_t)0x80000000;
+    return (q31_t)(x * 2147483648.0f);
+}
+
+/**
+ * @brief 增益乘法 (k * 2^shift / 2^31) * x，结果不饱和
+ */
+static q63_t pid_mul_q31(q31_t k, q31_t x, uint8_t shift)
+{
+    return ((q63_t)k * x) >> (31 - shift);
+}
+
+/**
+ * @brief 按slew和上下限限制Q31输出
+ */
+static q31_t pid_limit_q31(const pid_ctrl_q31_t* pid, q63_t output)
+{
+    if(pid->slew > 0)
+    {
+        if(output > (q63_t)pid->output + pid->slew) output = (q63_t)pid->output + pid->slew;
+        if(output < (q63_t)pid->output - pid->slew) output = (q63_t)pid->output - pid->slew;
+    }
+    if(output > pid->out_max) output = pid->out_max;
+    if(output < pid->out_min) output = pid->out_min;
+
+    return (q31_t)output;
+}
+
+void pid_init_q31(pid_ctrl_q31_t* pid, const pid_ctrl_t* config)
+{
+    memset(pid, 0, sizeof(pid_ctrl_q31_t));
+
+    // 选取使最大增益小于1的移位数
+    float max_gain = fmaxf(fmaxf(fabsf(config->kp), fabsf(config->ki)), fmaxf(fabsf(config->kd), fabsf(config->kt)));
+    while(max_gain >= 1.0f && pid->shift < 31)
+    {
+        max_gain *= 0.5f;
+        pid->shift++;
+    }
+
+    float scale = ldexpf(1.0f, -pid->shift);
+    pid->form = config->form;
+    pid->kp = pid_to_q31(config->kp * scale);
+    pid->ki = pid_to_q31(config->ki * scale);
+    pid->kd = pid_to_q31(config->kd * scale);
+    pid->kt = pid_to_q31(config->kt * scale);
+    pid->d_alpha = pid_to_q31(config->d_alpha);
+    pid->integral_limit = pid_to_q31(config->integral_limit);
+    pid->out_min = pid_to_q31(config->out_min);
+    pid->out_max = pid_to_q31(config->out_max);
+    pid->slew = pid_to_q31(config->slew);
+}
+
+void pid_reset_q31(pid_ctrl_q31_t* pid, q31_t output)
+{
+    pid->integral = (pid->form == PID_FORM_POSITIONAL) ? output : 0;
+    pid->derivative = 0;
+    pid->prev_error = 0;
+    pid->feedforward = 0;
+    pid->output = output;
+}
+
+q31_t pid_update_q31(pid_ctrl_q31_t* pid, q31_t setpoint, q31_t measurement, q31_t feedforward)
+{
+    q31_t error = clip_q63_to_q31((q63_t)setpoint - measurement);
+    q31_t delta = clip_q63_to_q31((q63_t)error - pid->prev_error);
+    q31_t d_step = clip_q63_to_q31(pid_mul_q31(pid->kd, delta, pid->shift) - pid->derivative);
+    q31_t derivative = clip_q63_to_q31(pid->derivative + pid_mul_q31(pid->d_alpha, d_step, 0));
+    q31_t output;
+
+    if(pid->form == PID_FORM_INCREMENTAL)
+    {
+        q63_t sum = (q63_t)pid->output + pid_mul_q31(pid->kp, delta, pid->shift) + pid_mul_q31(pid->ki, error, pid->shift)
+                  + ((q63_t)derivative - pid->derivative) + ((q63_t)feedforward - pid->feedforward);
+        output = pid_limit_q31(pid, sum);
+    }
+    else
+    {
+        pid->integral = clip_q63_to_q31(pid->integral + pid_mul_q31(pid->ki, error, pid->shift));
+        if(pid->integral_limit > 0)
+        {
+            if(pid->integral > pid->integral_limit) pid->integral = pid->integral_limit;
+            if(pid->integral < -pid->integral_limit) pid->integral = -pid->integral_limit;
+        }
+
+        q63_t unsaturated = pid_mul_q31(pid->kp, error, pid->shift) + pid->integral + derivative + feedforward;
+        output = pid_limit_q31(pid, unsaturated);
+        q31_t excess = clip_q63_to_q31(output - unsaturated);
+        pid->integral = clip_q63_to_q31(pid->integral + pid_mul_q31(pid->kt, excess, pid->shift));
+    }
+
+    pid->derivative = derivative;
+    pid->prev_error = error;
+    pid->feedforward = feedforward;
+    pid->output = output;
+    return output;
+}
@@ -0,0 +1,271 @@
+/**
+ * @file sine_fit.c
+ * @brief 正弦波最小二乘拟合实现
+ * @details
+ * 1. 基向量：cos(w*n)、sin(w*n)、常数1，四参数法再加一列频率偏导
+ *    g(n) = 2*pi*(n - (N-1)/2)/N * (-a*sin(w*n) + b*cos(w*n))，对应参数为以bin计的频率修正量。
+ *    时间以记录中点为原点并除以N，使该列与其他列量级相当，正规方程条件数较小；
+ *    中点偏移带来的项落在cos/sin的张成空间内，只影响当次的a、b，收敛后再做一次三参数拟合即可消除。
+ * 2. 正规方程 (B^T*B)*x = B^T*y 的各元素用 arm_dot_prod_f32()/arm_mean_f32() 计算，
+ *    5x5以内的方程用列主元高斯消元求解。
+ * 3. y = a*cos + b*sin = A*sin(w*n + phi)，A = sqrt(a^2 + b^2)，phi = atan2(a, b)。
+ * 4. 双音拟合用两组cos/sin基向量加常数列，共5个未知数，两频率相距过近时正规方程接近奇异。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#include "sine_fit.h"
+#include <math.h>
+
+#define SINE_FIT_MAX_PARAMS 5
+
+// 基向量缓冲区：cos、sin、频率偏导 (计算残差时兼作临时缓冲区)，双音拟合的第二个频率另用一组cos/sin
+static float fit_cos[SINE_FIT_MAX_LENGTH];
+static float fit_sin[SINE_FIT_MAX_LENGTH];
+static float fit_ramp[SINE_FIT_MAX_LENGTH];
+static float fit_cos2[SINE_FIT_MAX_LENGTH];
+static float fit_sin2[SINE_FIT_MAX_LENGTH];
+
+/**
+ * @brief 生成频率为 cycles (周期/样本) 的cos/sin基向量
+ */
+static void fit_basis(float cycles, uint16_t length, float* cos_out, float* sin_out)
+{
+    for(uint16_t n = 0; n < length; n++)
+    {
+        float t = cycles * n;
+        float angle = 2.0f * PI * (t - floorf(t));
+        cos_out[n] = arm_cos_f32(angle);
+        sin_out[n] = arm_sin_f32(angle);
+    }
+}
+
+/**
+ * @brief 列主元高斯消元求解增广矩阵
+ * @param matrix 增广矩阵 [size][size+1]，求解后被破坏
+ * @param size 未知数个数
+ * @param solution 输出解
+ * @return 1=成功，0=矩阵奇异
+ */
+static uint8_t fit_solve(float matrix[SINE_FIT_MAX_PARAMS][SINE_FIT_MAX_PARAMS + 1], uint8_t size, float* solution)
+{
+    for(uint8_t col = 0; col < size; col++)
+    {
+        uint8_t pivot = col;
+        for(uint8_t row = col + 1; row < size; row++)
+        {
+            if(fabsf(matrix[row][col]) > fabsf(matrix[pivot][col]))
+            {
+                pivot = row;
+            }
+        }
+        if(fabsf(matrix[pivot][col]) < 1e-12f)
+        {
+            return 0;
+        }
+        if(pivot != col)
+        {
+            for(uint8_t k = 0; k <= size; k++)
+            {
+                float temp = matrix[col][k];
+                matrix[col][k] = matrix[pivot][k];
+                matrix[pivot][k] = temp;
+            }
+        }
+
+        for(uint8_t row = col + 1; row < size; row++)
+        {
+            float factor = matrix[row][col] / matrix[col][col];
+            for(uint8_t k = col; k <= size; k++)
+            {
+                matrix[row][k] -= factor * matrix[col][k];
+            }
+        }
+    }
+
+    for(int8_t row = size - 1; row >= 0; row--)
+    {
+        float sum = matrix[row][size];
+        for(uint8_t k = row + 1; k < size; k++)
+        {
+            sum -= matrix[row][k] * solution[k];
+        }
+        solution[row] = sum / matrix[row][row];
+    }
+
+    return 1;
+}
+
+/**
+ * @brief 构造并求解正规方程
+ * @param basis 非常数基向量
+ * @param columns 非常数基向量个数，常数列总在最后
+ * @param solution 输出 [各基向量系数, c]
+ */
+static uint8_t fit_least_squares(const float* data, uint16_t length, const float* const* basis, uint8_t columns,
+                                 float* solution)
+{
+    float matrix[SINE_FIT_MAX_PARAMS][SINE_FIT_MAX_PARAMS + 1];
+    uint8_t size = columns + 1;
+
+    for(uint8_t i = 0; i < columns; i++)
+    {
+        for(uint8_t j = 0; j <= i; j++)
+        {
+            arm_dot_prod_f32(basis[i], basis[j], length, &matrix[i][j]);
+            matrix[j][i] = matrix[i][j];
+        }
+
+        float mean;
+        arm_mean_f32(basis[i], length, &mean);
+        matrix[i][columns] = mean * length;
+        matrix[columns][i] = matrix[i][columns];
+        arm_dot_prod_f32(data, basis[i], length, &matrix[i][size]);
+    }
+
+    float mean;
+    arm_mean_f32(data, length, &mean);
+    matrix[columns][columns] = length;
+    matrix[columns][size] = mean * length;
+
+    return fit_solve(matrix, size, solution);
+}
+
+/**
+ * @brief 由 a、b、c 填写幅度、相位、偏置和残差
+ * @note 会覆盖 fit_cos 和 fit_ramp
+ */
+static void fit_finish(const float* data, uint16_t length, float a, float b, float c, sine_fit_result_t* result)
+{
+    result->amplitude = sqrtf(a * a + b * b);
+    result->phase = atan2f(a, b);
+    result->offset = c;
+
+    // 残差 = y - a*cos - b*sin - c
+    arm_scale_f32(fit_cos, a, fit_ramp, length);
+    arm_sub_f32(data, fit_ramp, fit_ramp, length);
+    arm_scale_f32(fit_sin, b, fit_cos, length);
+    arm_sub_f32(fit_ramp, fit_cos, fit_ramp, length);
+    arm_offset_f32(fit_ramp, -c, fit_ramp, length);
+    arm_rms_f32(fit_ramp, length, &result->residual_rms);
+}
+
+uint8_t sine_fit_3param(const float* data, uint16_t length, float sampling_freq, float frequency,
+                        sine_fit_result_t* result)
+{
+    float x[SINE_FIT_MAX_PARAMS];
+
+    memset(result, 0, sizeof(sine_fit_result_t));
+    if(data == NULL || length < SINE_FIT_MIN_LENGTH || length > SINE_FIT_MAX_LENGTH ||
+       sampling_freq <= 0.0f || frequency <= 0.0f || frequency >= 0.5f * sampling_freq)
+    {
+        return 0;
+    }
+
+    const float* basis[2] = {fit_cos, fit_sin};
+
+    fit_basis(frequency / sampling_freq, length, fit_cos, fit_sin);
+    if(!fit_least_squares(data, length, basis, 2, x))
+    {
+        return 0;
+    }
+
+    result->frequency = frequency;
+    fit_finish(data, length, x[0], x[1], x[2], result);
+    return 1;
+}
+
+uint8_t sine_fit_4param(const float* data, uint16_t length, float sampling_freq, float frequency,
+                        sine_fit_result_t* result)
+{
+    float x[SINE_FIT_MAX_PARAMS];
+
+    // 三参数拟合给出 a、b 初值
+    if(!sine_fit_3param(data, length, sampling_freq, frequency, result))
+    {
+        return 0;
+    }
+
+    float cycles = frequency / sampling_freq;
+    float a = result->amplitude * sinf(result->phase);
+    float b = result->amplitude * cosf(result->phase);
+    float center = 0.5f * (length - 1);
+    float scale = 2.0f * PI / length;
+    uint8_t converged = 0;
+    uint8_t iterations = 0;
+    const float* basis[3] = {fit_cos, fit_sin, fit_ramp};
+
+    while(iterations < SINE_FIT_MAX_ITERATIONS && !converged)
+    {
+        fit_basis(cycles, length, fit_cos, fit_sin);
+        for(uint16_t n = 0; n < length; n++)
+        {
+            fit_ramp[n] = scale * (n - center) * (b * fit_cos[n] - a * fit_sin[n]);
+        }
+        if(!fit_least_squares(data, length, basis, 3, x))
+        {
+            return 0;
+        }
+        iterations++;
+
+        a = x[0];
+        b = x[1];
+        cycles += x[2] / length;
+        if(cycles <= 0.0f || cycles >= 0.5f)
+        {
+            return 0;
+        }
+        converged = (fabsf(x[2]) < SINE_FIT_TOLERANCE);
+    }
+
+    // 在最终频率上重新做三参数拟合，消除频率偏导列对 a、b 的影响
+    if(!sine_fit_3param(data, length, sampling_freq, cycles * sampling_freq, result))
+    {
+        return 0;
+    }
+    result->iterations = iterations;
+    result->converged = converged;
+    return 1;
+}
+
+uint8_t sine_fit_2tone(const float* data, uint16_t length, float sampling_freq, float frequency1, float frequency2,
+                       sine_fit_result_t result[2])
+{
+    const float* basis[4] = {fit_cos, fit_sin, fit_cos2, fit_sin2};
+    float x[SINE_FIT_MAX_PARAMS];
+
+    memset(result, 0, 2 * sizeof(sine_fit_result_t));
+    if(data == NULL || length < SINE_FIT_MIN_LENGTH || length > SINE_FIT_MAX_LENGTH || sampling_freq <= 0.0f ||
+       frequency1 <= 0.0f || frequency1 >= 0.5f * sampling_freq ||
+       frequency2 <= 0.0f || frequency2 >= 0.5f * sampling_freq)
+    {
+        return 0;
+    }
+
+    fit_basis(frequency1 / sampling_freq, length, fit_cos, fit_sin);
+    fit_basis(frequency2 / sampling_freq, length, fit_cos2, fit_sin2);
+    if(!fit_least_squares(data, length, basis, 4, x))
+    {
+        return 0;
+    }
+
+    // 残差 = y - 两个分量 - c
+    float sum = 0.0f;
+    for(uint16_t n = 0; n < length; n++)
+    {
+        float r = data[n] - x[0] * fit_cos[n] - x[1] * fit_sin[n] - x[2] * fit_cos2[n] - x[3] * fit_sin2[n] - x[4];
+        sum += r * r;
+    }
+
+    for(uint8_t k = 0; k < 2; k++)
+    {
+        float a = x[2 * k];
+        float b = x[2 * k + 1];
+        result[k].frequency = (k == 0) ? frequency1 : frequency2;
+        result[k].amplitude = sqrtf(a * a + b * b);
+        result[k].phase = atan2f(a, b);
+        result[k].offset = x[4];
+        result[k].residual_rms = sqrtf(sum / length);
+    }
+    return 1;
+}
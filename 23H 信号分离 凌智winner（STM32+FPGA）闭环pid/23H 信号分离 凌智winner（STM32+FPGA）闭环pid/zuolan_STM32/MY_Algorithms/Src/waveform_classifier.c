@@ -0,0 +1,326 @@
+/**
+ * @file waveform_classifier.c
+ * @brief 基于谐波特征的波形分类器实现
+ * @details
+ * 1. 对每个分量的1~7次谐波频点各设一个Goertzel滤波器，样本加Hanning窗后一次遍历全部更新。
+ *    Hanning窗旁瓣衰减快，基波泄漏不会淹没 1/49 量级的7次谐波。
+ * 2. 相对相位 = phi_n - n*phi_1 - (n-1)*90度 (余弦参考换算为正弦参考)。
+ *    Goertzel输出相对DTFT的公共相位因子为 exp(j*w*(N-1))，n*w_1 = w_n，在相对相位中正好抵消；
+ *    基波频率的小误差也以同样方式抵消，因此不要求频率精确落在bin上。
+ * 3. 复数比值 r_n = (A_n/A_1)*exp(j*theta_n) 与模板系数 t_n (实数，符号即相位0/180度) 比较，
+ *    距离 = sum |r_n - t_n|^2，只累加未发生碰撞且低于Nyquist频率的谐波。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#include "waveform_classifier.h"
+#include <math.h>
+
+#define WAVE_CLASS_FILTERS (WAVE_CLASS_MAX_COMPONENTS * WAVE_CLASS_MAX_HARMONIC)
+#define WAVE_CLASS_EXACT_BINS 0.05f // 两个频率相距小于该值 (bin) 时视为完全重合，可按模板扣除
+#define WAVE_CLASS_PASSES 3         // 分量间相互扣除的迭代轮数
+
+/**
+ * @brief 波形模板 (锯齿波按上升沿和下降沿分为两个模板)
+ */
+typedef enum
+{
+    TEMPLATE_SINE = 0,
+    TEMPLATE_TRIANGLE,
+    TEMPLATE_SQUARE,
+    TEMPLATE_SAWTOOTH_FALLING,
+    TEMPLATE_SAWTOOTH_RISING,
+    TEMPLATE_COUNT
+} wave_template_t;
+
+static const Waveform_t template_waveform[TEMPLATE_COUNT] = {
+    WAVE_SINE, WAVE_TRIANGLE, WAVE_SQUARE, WAVE_SAWTOOTH, WAVE_SAWTOOTH};
+
+/**
+ * @brief 模板的n次谐波系数 (相对基波，正弦参考)
+ */
+static float template_coefficient(wave_template_t t, uint8_t n)
+{
+    uint8_t odd = n & 1;
+
+    switch(t)
+    {
+        case TEMPLATE_TRIANGLE:
+            return odd ? ((((n - 1) / 2) & 1) ? -1.0f : 1.0f) / (n * n) : 0.0f;
+        case TEMPLATE_SQUARE:
+            return odd ? 1.0f / n : 0.0f;
+        case TEMPLATE_SAWTOOTH_FALLING:
+            return 1.0f / n;
+        case TEMPLATE_SAWTOOTH_RISING:
+            return (odd ? 1.0f : -1.0f) / n;
+        default:
+            return 0.0f;
+    }
+}
+
+// 所有分量各次谐波处的Goertzel输出 y = s1 - exp(-jw)*s2，下标 [分量][谐波次数]
+static float harmonic_re[WAVE_CLASS_MAX_COMPONENTS][WAVE_CLASS_MAX_HARMONIC + 1];
+static float harmonic_im[WAVE_CLASS_MAX_COMPONENTS][WAVE_CLASS_MAX_HARMONIC + 1];
+// 扣除其他分量谐波后的基波输出，作为相位参考和预测其谐波的依据
+static float fundamental_re[WAVE_CLASS_MAX_COMPONENTS];
+static float fundamental_im[WAVE_CLASS_MAX_COMPONENTS];
+static wave_template_t component_template[WAVE_CLASS_MAX_COMPONENTS]; // 各分量当前判定的模板
+
+/**
+ * @brief 扣除其他分量在该频率处的贡献
+ * @details
+ * - 第一轮 (其他分量波形未知)：只检查其他分量的基波，与之相距小于碰撞门限即不可用；
+ * - 之后各轮：按其他分量已判定的模板，凡系数不为0的各次谐波 (直至Nyquist频率)，
+ *   频率完全重合时按模板预测的复数值扣除，相近但不重合时 (泄漏相位未知) 判为不可用。
+ * @param re,im 待修正的Goertzel输出
+ * @return 1=可用，0=不可用
+ */
+static uint8_t remove_other_components(float frequency, float* re, float* im, const float* frequencies, uint8_t count,
+                                       uint8_t self, uint8_t known, float fs, float bin_width)
+{
+    for(uint8_t j = 0; j < count; j++)
+    {
+        if(j == self || frequencies[j] <= 0.0f)
+        {
+            continue;
+        }
+
+        uint16_t max_m = known ? (uint16_t)(0.5f * fs / frequencies[j]) : 1;
+        float fund_mag = sqrtf(fundamental_re[j] * fundamental_re[j] + fundamental_im[j] * fundamental_im[j]);
+        float fund_phase = atan2f(fundamental_im[j], fundamental_re[j]);
+
+        for(uint16_t m = 1; m <= max_m; m++)
+        {
+            float offset = fabsf(frequency - m * frequencies[j]);
+            if(offset >= WAVE_CLASS_COLLISION_BINS * bin_width)
+            {
+                continue;
+            }
+            if(m == 1)
+            {
+                return 0;
+            }
+
+            float c = template_coefficient(component_template[j], m);
+            if(c == 0.0f)
+            {
+                continue;
+            }
+            if(offset >= WAVE_CLASS_EXACT_BINS * bin_width)
+            {
+                return 0;
+            }
+
+            // 由 theta_m = arg(y_m) - m*phi_1 - (m-1)*90度 = 0 反推其他分量在此处的输出
+            float phase = m * fund_phase + (m - 1) * 0.5f * PI;
+            *re -= c * fund_mag * cosf(phase);
+            *im -= c * fund_mag * sinf(phase);
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * @brief 对单个分量做一轮模板匹配
+ * @param known 1=其他分量的模板已判定
+ */
+static void classify_component(waveform_class_t* result, const float* frequencies, uint8_t count, uint8_t self,
+                               uint8_t known, float fs, float bin_width)
+{
+    float r_re[WAVE_CLASS_MAX_HARMONIC + 1];
+    float r_im[WAVE_CLASS_MAX_HARMONIC + 1];
+
+    // 基波可能与其他分量的谐波重合 (如另一分量的3次谐波)，同样扣除；相近而无法扣除时保留测量值
+    float fund_re = harmonic_re[self][1];
+    float fund_im = harmonic_im[self][1];
+    if(remove_other_components(frequencies[self], &fund_re, &fund_im, frequencies, count, self, known, fs, bin_width))
+    {
+        fundamental_re[self] = fund_re;
+        fundamental_im[self] = fund_im;
+    }
+    float fund_mag = sqrtf(fundamental_re[self] * fundamental_re[self] + fundamental_im[self] * fundamental_im[self]);
+    float fund_phase = atan2f(fundamental_im[self], fundamental_re[self]);
+
+    memset(result, 0, sizeof(waveform_class_t));
+    result->waveform = WAVE_SINE;
+    component_template[self] = TEMPLATE_SINE;
+    if(fund_mag <= 0.0f)
+    {
+        return;
+    }
+    result->ratio[1] = 1.0f;
+
+    // 各次谐波的复数比值
+    for(uint8_t n = 2; n <= WAVE_CLASS_MAX_HARMONIC; n++)
+    {
+        float frequency = n * frequencies[self];
+        if(frequency >= 0.5f * fs)
+        {
+            break;
+        }
+
+        float re = harmonic_re[self][n];
+        float im = harmonic_im[self][n];
+        uint8_t usable = remove_other_components(frequency, &re, &im, frequencies, count, self, known, fs, bin_width);
+
+        float theta = atan2f(im, re) - n * fund_phase - (n - 1) * 0.5f * PI;
+        float ratio = sqrtf(re * re + im * im) / fund_mag;
+        theta = fmodf(theta, 2.0f * PI);
+        if(theta < 0.0f)
+        {
+            theta += 2.0f * PI;
+        }
+
+        result->ratio[n] = ratio;
+        result->phase[n] = theta * 180.0f / PI;
+        r_re[n] = ratio * cosf(theta);
+        r_im[n] = ratio * sinf(theta);
+        if(usable)
+        {
+            result->usable |= (1 << n);
+        }
+    }
+
+    // 与各模板比较，距离相同时取靠前的模板 (偶次谐波不可用时方波优先于锯齿波)
+    float best = 0.0f;
+    for(uint8_t t = 0; t < TEMPLATE_COUNT; t++)
+    {
+        float distance = 0.0f;
+        for(uint8_t n = 2; n <= WAVE_CLASS_MAX_HARMONIC; n++)
+        {
+            if(!(result->usable & (1 << n)))
+            {
+                continue;
+            }
+            float d_re = r_re[n] - template_coefficient((wave_template_t)t, n);
+            distance += d_re * d_re + r_im[n] * r_im[n];
+        }
+
+        if(t == 0 || distance < best)
+        {
+            best = distance;
+            component_template[self] = (wave_template_t)t;
+        }
+    }
+    result->waveform = template_waveform[component_template[self]];
+    result->shape = component_template[self];
+    result->distance = best;
+}
+
+uint8_t classify_waveforms(const float* data, uint16_t length, float sampling_freq,
+                           const float* frequencies, uint8_t count, waveform_class_t* results)
+{
+    float coeff[WAVE_CLASS_FILTERS];
+    float cos_w[WAVE_CLASS_FILTERS];
+    float sin_w[WAVE_CLASS_FILTERS];
+    float s1[WAVE_CLASS_FILTERS] = {0};
+    float s2[WAVE_CLASS_FILTERS] = {0};
+
+    if(data == NULL || length < 2 || sampling_freq <= 0.0f)
+    {
+        return 0;
+    }
+    if(count > WAVE_CLASS_MAX_COMPONENTS)
+    {
+        count = WAVE_CLASS_MAX_COMPONENTS;
+    }
+
+    // 各分量1~7次谐波的滤波器系数
+    for(uint8_t i = 0; i < count; i++)
+    {
+        for(uint8_t n = 1; n <= WAVE_CLASS_MAX_HARMONIC; n++)
+        {
+            uint8_t f = i * WAVE_CLASS_MAX_HARMONIC + (n - 1);
+            float w = 2.0f * PI * n * frequencies[i] / sampling_freq;
+            cos_w[f] = cosf(w);
+            sin_w[f] = sinf(w);
+            coeff[f] = 2.0f * cos_w[f];
+        }
+    }
+
+    // 一次遍历：加Hanning窗后更新全部滤波器
+    uint8_t filters = count * WAVE_CLASS_MAX_HARMONIC;
+    float window_step = 2.0f * PI / (length - 1);
+    for(uint16_t k = 0; k < length; k++)
+    {
+        float x = data[k] * (0.5f - 0.5f * cosf(window_step * k));
+        for(uint8_t f = 0; f < filters; f++)
+        {
+            float s0 = x + coeff[f] * s1[f] - s2[f];
+            s2[f] = s1[f];
+            s1[f] = s0;
+        }
+    }
+
+    for(uint8_t i = 0; i < count; i++)
+    {
+        for(uint8_t n = 1; n <= WAVE_CLASS_MAX_HARMONIC; n++)
+        {
+            uint8_t f = i * WAVE_CLASS_MAX_HARMONIC + (n - 1);
+            harmonic_re[i][n] = s1[f] - cos_w[f] * s2[f];
+            harmonic_im[i][n] = sin_w[f] * s2[f];
+        }
+        fundamental_re[i] = harmonic_re[i][1];
+        fundamental_im[i] = harmonic_im[i][1];
+    }
+
+    // 第一轮只避开其他分量的基波，之后按对方的判定结果扣除其谐波，反复几轮直至稳定
+    float bin_width = sampling_freq / length;
+    uint8_t classified = 0;
+    for(uint8_t pass = 0; pass < WAVE_CLASS_PASSES; pass++)
+    {
+        classified = 0;
+        for(uint8_t i = 0; i < count; i++)
+        {
+            if(frequencies[i] <= 0.0f)
+            {
+                memset(&results[i], 0, sizeof(waveform_class_t));
+                results[i].waveform = WAVE_SINE;
+                component_template[i] = TEMPLATE_SINE;
+                continue;
+            }
+            classify_component(&results[i], frequencies, count, i, pass > 0, sampling_freq, bin_width);
+            classified++;
+        }
+    }
+
+    // Hanning窗系数之和约为 N/2，正弦幅度 = 2|y| / (N/2)
+    for(uint8_t i = 0; i < count; i++)
+    {
+        results[i].magnitude = sqrtf(fundamental_re[i] * fundamental_re[i] + fundamental_im[i] * fundamental_im[i]) * 4.0f / length;
+    }
+
+    return classified;
+}
+
+float waveform_class_coefficient(const waveform_class_t* result, uint8_t n)
+{
+    if(n == 1)
+    {
+        return 1.0f;
+    }
+    if(result->shape >= TEMPLATE_COUNT)
+    {
+        return 0.0f;
+    }
+
+    return template_coefficient((wave_template_t)result->shape, n);
+}
+
+const char* waveform_name(Waveform_t waveform)
+{
+    switch(waveform)
+    {
+        case WAVE_TRIANGLE:
+            return "TRIANGLE";
+        case WAVE_SQUARE:
+            return "SQUARE";
+        case WAVE_SAWTOOTH:
+            return "SAWTOOTH";
+        case WAVE_MULTITONE:
+            return "MULTITONE";
+        default:
+            return "SINE";
+    }
+}
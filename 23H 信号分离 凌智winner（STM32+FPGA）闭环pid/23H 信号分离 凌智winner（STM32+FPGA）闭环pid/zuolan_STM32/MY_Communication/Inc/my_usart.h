@@ -12,5 +12,6 @@ extern uint16_t rxIndex1, rxIndex2, rxIndex3;
 extern volatile uint8_t commandReceived1, commandReceived3;
 int my_printf(UART_HandleTypeDef *huart, const char *format, ...);
 void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart);
+void uart_cmd_proc(void);
 
 #endif // __MY_USART_H__
@@ -6,23 +6,44 @@
 #include "my_hmi.h"
 #include "bsp_system.h"
 // 串口1的缓冲区和状态变量
-uint8_t rxBuffer1[RX_BUFFER_SIZE];     ///< 串口1接收缓冲区
-uint8_t rxTemp1;                       ///< 串口1中断接收临时变量
+DMA_BUFFER uint8_t rxBuffer1[RX_BUFFER_SIZE]; ///< 串口1接收缓冲区
+DMA_BUFFER uint8_t rxTemp1; ///< 串口1中断接收临时变量
 uint16_t rxIndex1 = 0;                 ///< 串口1当前接收缓冲区索引
 volatile uint8_t commandReceived1 = 0; ///< 串口1接收到命令标志
 
 // 串口3的缓冲区和状态变量
-uint8_t rxBuffer3[RX_BUFFER_SIZE];     ///< 串口3接收缓冲区
-uint8_t rxTemp3;                       ///< 串口3中断接收临时变量
+DMA_BUFFER uint8_t rxBuffer3[RX_BUFFER_SIZE]; ///< 串口3接收缓冲区
+DMA_BUFFER uint8_t rxTemp3; ///< 串口3中断接收临时变量
 uint16_t rxIndex3 = 0;                 ///< 串口3当前接收缓冲区索引
 volatile uint8_t commandReceived3 = 0; ///< 串口3接收到命令标志
 
 // 串口2数据包缓冲区和变量
-uint8_t rxBuffer2[RX_BUFFER_SIZE]; ///< 串口2接收缓冲区
-uint8_t rxTemp2;                   ///< 串口2中断接收临时变量
+DMA_BUFFER uint8_t rxBuffer2[RX_BUFFER_SIZE]; ///< 串口2接收缓冲区
+DMA_BUFFER uint8_t rxTemp2; ///< 串口2中断接收临时变量
 uint16_t rxIndex2 = 0;             ///< 串口2当前接收缓冲区索引
 volatile uint8_t frameStarted = 0; ///< 帧开始标志
 
+// 串口1单字节命令中需要在后台执行的部分 (中断中只置位，由 uart_cmd_proc 处理)
+#define UART_CMD_SWEEP (1U << 0) // 0x0C 网络分析扫频
+#define UART_CMD_MULTITONE (1U << 1) // 0x0D DA1多音复现被测波形
+#define UART_CMD_DITHER (1U << 2) // 0x0E 切换DA杂散抑制
+#define UART_CMD_MODULATION (1U << 3) // 0x0F 切换DA1调制方式
+#define UART_CMD_AGC (1U << 4) // 0x10 开关DA1自动增益控制
+#define UART_CMD_AGC_STATUS (1U << 5) // 0x13 打印AGC状态
+#define UART_CMD_FFT_LENGTH (1U << 6) // 0x14 切换FFT长度
+
+// 0x0F 的预设调制参数：1kHz正弦调制，AM调制度50%，FM频偏为载波的10%，PM相偏90度
+#define UART_MOD_FREQ 1000.0f
+#define UART_MOD_AM_DEPTH 0.5f
+#define UART_MOD_FM_RATIO 0.1f
+#define UART_MOD_PM_DEG 90.0f
+
+// 0x10 的AGC参数：以AD1检测DA1，窗口10ms (AD采样率2MHz，覆盖100Hz以上信号的一个周期)，
+// 纯积分，通路增益为1时每个窗口误差减半，通路增益超过4才会振荡
+#define UART_AGC_WINDOW 20000
+#define UART_AGC_KI 250.0f
+static volatile uint32_t uart_cmd_pending = 0;
+
 /**
  * @brief 格式化打印并通过指定串口发送
  * @param huart 串口句柄
@@ -129,6 +150,90 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
             HAL_UART_Receive_IT(&huart1, &rxTemp1, 1);
             return;
         }		
+     if (rxTemp1 == 0x07)
+        {
+            // 幅度环继电自整定
+            PID_Autotune_Start();
+            HAL_UART_Receive_IT(&huart1, &rxTemp1, 1);
+            return;
+        }
+     if (rxTemp1 == 0x08)
+        {
+            // 相位跟踪环继电自整定
+            track_pid_autotune_start();
+            HAL_UART_Receive_IT(&huart1, &rxTemp1, 1);
+            return;
+        }
+     if (rxTemp1 == 0x09)
+        {
+            // 进入双通道锁相环模式
+            stm32_dpll_start();
+            HAL_UART_Receive_IT(&huart1, &rxTemp1, 1);
+            return;
+        }
+     if (rxTemp1 == 0x0A)
+        {
+            // 退出锁相环模式
+            stm32_dpll_stop();
+            HAL_UART_Receive_IT(&huart1, &rxTemp1, 1);
+            return;
+        }
+     if (rxTemp1 == 0x0B)
+        {
+            // 打印调度器任务统计
+            scheduler_report();
+            HAL_UART_Receive_IT(&huart1, &rxTemp1, 1);
+            return;
+        }
+     if (rxTemp1 == 0x0C)
+        {
+            // 网络分析扫频 (忙等待约2秒，交给后台执行)
+            uart_cmd_pending |= UART_CMD_SWEEP;
+            HAL_UART_Receive_IT(&huart1, &rxTemp1, 1);
+            return;
+        }
+     if (rxTemp1 == 0x0D)
+        {
+            // 按最新采集帧的谐波配置DA1多音输出 (需做FFT，交给后台执行)
+            uart_cmd_pending |= UART_CMD_MULTITONE;
+            HAL_UART_Receive_IT(&huart1, &rxTemp1, 1);
+            return;
+        }
+     if (rxTemp1 == 0x0E)
+        {
+            // 切换DA杂散抑制 (读改写 CTRL_DATA，交给后台执行)
+            uart_cmd_pending |= UART_CMD_DITHER;
+            HAL_UART_Receive_IT(&huart1, &rxTemp1, 1);
+            return;
+        }
+     if (rxTemp1 == 0x0F)
+        {
+            // DA1调制方式 关->AM->FM->PM 循环切换
+            uart_cmd_pending |= UART_CMD_MODULATION;
+            HAL_UART_Receive_IT(&huart1, &rxTemp1, 1);
+            return;
+        }
+     if (rxTemp1 == 0x10)
+        {
+            // 开关DA1自动增益控制，目标为当前AD1峰峰值
+            uart_cmd_pending |= UART_CMD_AGC;
+            HAL_UART_Receive_IT(&huart1, &rxTemp1, 1);
+            return;
+        }
+     if (rxTemp1 == 0x13)
+        {
+            // 打印AGC锁定/饱和状态
+            uart_cmd_pending |= UART_CMD_AGC_STATUS;
+            HAL_UART_Receive_IT(&huart1, &rxTemp1, 1);
+            return;
+        }
+     if (rxTemp1 == 0x14)
+        {
+            // FFT长度 256->512->1024 循环切换 (不能与频谱分析同时进行，交给后台执行)
+            uart_cmd_pending |= UART_CMD_FFT_LENGTH;
+            HAL_UART_Receive_IT(&huart1, &rxTemp1, 1);
+            return;
+        }
 				
     if (huart->Instance == USART1) // USART1的接收中断
     {
@@ -207,3 +312,100 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
         HAL_UART_Receive_IT(&huart2, &rxTemp2, 1); // 再次启动接收中断
     }
 }
+
+/**
+ * @brief 串口1单字节命令的后台处理
+ * @details 扫频等忙等待、打印大量结果的命令不能在接收中断里执行，中断回调只记录
+ *          命令，由调度器以后台优先级调用本函数完成。
+ */
+void uart_cmd_proc(void)
+{
+    static uint8_t dither_on = 0;
+    static Modulation_t mod_mode = MOD_OFF;
+    static uint8_t agc_on = 0;
+    uint32_t cmds;
+
+    __disable_irq();
+    cmds = uart_cmd_pending;
+    uart_cmd_pending = 0;
+    __enable_irq();
+
+    if (cmds & UART_CMD_SWEEP)
+        DA_Sweep_Report();
+    if (cmds & UART_CMD_MULTITONE)
+        multitone_from_frame();
+    if (cmds & UART_CMD_DITHER)
+    {
+        dither_on = !dither_on;
+        // CTRL_DATA 同时含 ad_proc 使用的FIFO写使能位，读改写期间屏蔽中断
+        __disable_irq();
+        if (dither_on)
+            DA_DITHER_ENABLE();
+        else
+            DA_DITHER_DISABLE();
+        __enable_irq();
+        my_printf(&huart1, dither_on ? "DA杂散抑制: 开\r\n" : "DA杂散抑制: 关\r\n");
+    }
+    if (cmds & UART_CMD_MODULATION)
+    {
+        float carrier = da_channels[0].frequency;
+
+        mod_mode = (mod_mode == MOD_PM) ? MOD_OFF : (Modulation_t)(mod_mode + 1);
+        switch (mod_mode)
+        {
+        case MOD_AM:
+            DA_SetModulation(0, MOD_AM, UART_MOD_FREQ, UART_MOD_AM_DEPTH);
+            my_printf(&huart1, "DA1调幅: %.0fHz 调制度%.0f%%\r\n", UART_MOD_FREQ, UART_MOD_AM_DEPTH * 100.0f);
+            break;
+        case MOD_FM:
+            DA_SetModulation(0, MOD_FM, UART_MOD_FREQ, carrier * UART_MOD_FM_RATIO);
+            my_printf(&huart1, "DA1调频: %.0fHz 频偏%.0fHz\r\n", UART_MOD_FREQ, carrier * UART_MOD_FM_RATIO);
+            break;
+        case MOD_PM:
+            DA_SetModulation(0, MOD_PM, UART_MOD_FREQ, UART_MOD_PM_DEG);
+            my_printf(&huart1, "DA1调相: %.0fHz 相偏%.0f度\r\n", UART_MOD_FREQ, UART_MOD_PM_DEG);
+            break;
+        default:
+            DA_SetModulation(0, MOD_OFF, 0.0f, 0.0f);
+            my_printf(&huart1, "DA1调制: 关\r\n");
+            break;
+        }
+    }
+    if (cmds & UART_CMD_AGC)
+    {
+        // 以开启时 ad_proc 测得的峰峰值为目标，之后保持该输出电平
+        float target = vol_amp1;
+
+        if (!agc_on && target <= 0.0f)
+        {
+            my_printf(&huart1, "AD1无信号，AGC未开启\r\n");
+        }
+        else
+        {
+            agc_on = !agc_on;
+            DA_SetAGC(0, AGC_SRC_AD1, agc_on ? target : 0.0f, UART_AGC_WINDOW, 0.0f, UART_AGC_KI);
+            if (agc_on)
+                my_printf(&huart1, "DA1 AGC: 开 (AD1目标 %.3fV)\r\n", target);
+            else
+                my_printf(&huart1, "DA1 AGC: 关\r\n");
+        }
+    }
+    if (cmds & UART_CMD_AGC_STATUS)
+    {
+        DA_AGC_Status_t agc;
+
+        DA_GetAGC(&agc);
+        my_printf(&huart1, "AGC: %s%s 峰峰值%.3fV 输出峰值%.0fmV\r\n", agc.locked ? "锁定" : "未锁定",
+                  agc.saturated ? " 饱和" : "", agc.vpp, agc.peak_mv);
+    }
+    if (cmds & UART_CMD_FFT_LENGTH)
+    {
+        uint16_t length = fft_get_length() * 2;
+
+        if (length > FFT_MAX_LENGTH)
+            length = 256;
+        fft_set_length(length);
+        my_printf(&huart1, "FFT长度: %d点，分辨率 %.1fHz\r\n", fft_get_length(),
+                  get_current_ad_frequency() / fft_get_length());
+    }
+}
@@ -5,6 +5,9 @@
 #include "bsp_system.h"
 extern float fifo_data1_f[FIFO_SIZE], fifo_data2_f[FIFO_SIZE]; // 采样结果转换为浮点数
 extern float vol_amp1, vol_amp2;
+void setSamplingFrequency(float fre, int channel);
+void readFIFOData(int channel, u16 *fifo_data, float *fifo_data_f);
 void vpp_adc_parallel(float ad1_freq, float ad2_freq);
+void ad_pause(uint8_t pause);
 void ad_proc(void);
 #endif //__AD_H__
@@ -30,7 +30,8 @@ typedef enum
     WAVE_SINE = 0,     // 正弦波
     WAVE_SQUARE = 1,   // 方波
     WAVE_TRIANGLE = 2, // 三角波
-    WAVE_SAWTOOTH = 3  // 锯齿波
+    WAVE_SAWTOOTH = 3, // 锯齿波
+    WAVE_MULTITONE = 4 // 多音合成 (谐波叠加，由 DA_SetMultitone 配置)
 } Waveform_t;
 
 // *********************************************************************************
@@ -58,6 +59,58 @@ typedef struct
  */
 #define NUM_DA_CHANNELS 2
 
+/**
+ * @brief 每个DA通道可叠加的谐波分量数量
+ * @details 与FPGA中 DA_MULTITONE 模块的分量数一致。
+ */
+#define DA_MT_TONES 8
+
+/**
+ * @brief 多音合成中单个谐波分量的参数
+ * @details
+ * 所有分量共用通道的基波频率(da_channels[].frequency)，
+ * 第k个分量的输出为 amplitude * sin(harmonic * 基波相位 + phase)。
+ */
+typedef struct
+{
+    uint8_t harmonic; // 谐波次数 (1~63, 0表示该分量关闭)
+    float amplitude;  // 相对幅度 (0~1, 1对应满幅；各分量之和超过1时自动等比缩小)
+    uint16_t phase;   // 初相 (单位: 度, 范围: 0-359)
+} DA_Tone_t;
+
+/**
+ * @brief FPGA调制器的调制方式
+ * @details 枚举值直接对应FPGA调制器控制字的模式位。
+ */
+typedef enum
+{
+    MOD_OFF = 0, // 关闭调制
+    MOD_AM = 1,  // 调幅
+    MOD_FM = 2,  // 调频
+    MOD_PM = 3   // 调相
+} Modulation_t;
+
+/**
+ * @brief FPGA自动增益控制(AGC)的检测源
+ * @details 枚举值直接对应AGC控制字的检测源位。
+ */
+typedef enum
+{
+    AGC_SRC_AD1 = 0, // 并行AD通道1
+    AGC_SRC_AD2 = 1  // 并行AD通道2
+} AGC_Source_t;
+
+/**
+ * @brief FPGA自动增益控制的运行状态
+ */
+typedef struct
+{
+    uint8_t locked;    // 连续4个检测窗口误差在目标值1/64以内
+    uint8_t saturated; // 输出达到上限 (3000mV) 或下限 (0)
+    float vpp;         // 最近一个检测窗口的峰峰值 (单位: V)
+    float peak_mv;     // 当前输出峰值电压 (单位: mV, 与 DA_SetConfig 的 vpp 同单位)
+} DA_AGC_Status_t;
+
 // *********************************************************************************
 // 函数原型声明
 // *********************************************************************************
@@ -91,6 +144,65 @@ void DA_SetConfig(uint8_t channel_index, float freq, uint16_t vpp, uint16_t angl
  */
 void DA_Apply_Settings(void);
 
+/**
+ * @brief 只更新指定DA通道的频率（立即写入FPGA）
+ * @details
+ * 只写频率字寄存器，不停止FPGA输出。FPGA的相位累加器保持连续，频率改变时输出相位不跳变，
+ * 供锁相环等需要逐周期微调频率的场合使用。高低16位分两次写入，中间约一个总线周期内频率字为新旧混合值。
+ * @param channel_index DA通道索引 (0 for DA1, 1 for DA2)
+ * @param freq 目标频率 (单位: Hz)
+ */
+void DA_SetFrequency(uint8_t channel_index, float freq);
+
+/**
+ * @brief 配置指定DA通道的多音合成参数（立即写入FPGA）
+ * @details
+ * 将最多 DA_MT_TONES 个谐波分量写入FPGA的多音寄存器组，未使用的分量被关闭。
+ * 同时把该通道的波形类型设为 WAVE_MULTITONE，需再调用 DA_Apply_Settings()
+ * 才会切换到多音输出。
+ * @param channel_index DA通道索引 (0 for DA1, 1 for DA2)
+ * @param tones 谐波分量数组
+ * @param count 分量个数 (超过 DA_MT_TONES 的部分被忽略)
+ */
+void DA_SetMultitone(uint8_t channel_index, const DA_Tone_t *tones, uint8_t count);
+
+/**
+ * @brief 配置FPGA调制器（立即写入FPGA）
+ * @details
+ * FPGA内置低频振荡器产生正弦调制信号，对指定通道的幅度、频率或相位进行调制，
+ * 配置一次即可，调制过程不需要MCU参与。同一时刻只能调制一个通道。
+ * @param channel_index 被调制的DA通道索引 (0 for DA1, 1 for DA2)
+ * @param mode 调制方式 (MOD_OFF 关闭调制)
+ * @param mod_freq 调制信号频率 (单位: Hz)
+ * @param depth 调制深度:
+ *              MOD_AM: 调制度 0~1;
+ *              MOD_FM: 峰值频偏 (单位: Hz);
+ *              MOD_PM: 峰值相偏 (单位: 度, 0~180)
+ */
+void DA_SetModulation(uint8_t channel_index, Modulation_t mode, float mod_freq, float depth);
+
+/**
+ * @brief 配置FPGA自动增益控制（立即写入FPGA）
+ * @details
+ * FPGA对检测源逐窗口求峰峰值，经PI控制器直接调节目标通道的幅度缩放增益，每个窗口更新一次，
+ * 调节过程不需要MCU参与。开启时以该通道当前的 vpp 设定为起点，关闭后恢复 vpp 设定。
+ * 环路增益约为 ki x 通路增益 x 0.002 (通路增益为检测到的峰峰值/DA输出峰峰值)，
+ * 等于1时一个窗口收敛，超过2时振荡；kp 一般取0。
+ * @param channel_index 被控DA通道索引 (0 for DA1, 1 for DA2)，超出范围时关闭AGC
+ * @param source 检测源
+ * @param target_vpp 目标峰峰值 (单位: V, 与 vol_amp1/vol_amp2 同单位)，不大于0时关闭AGC
+ * @param window 检测窗口长度 (AD采样点数)，至少覆盖被测信号一个周期
+ * @param kp 比例系数 (单位: mV/V，输出峰值电压/峰峰值误差)
+ * @param ki 积分系数 (单位: mV/V，每个窗口)
+ */
+void DA_SetAGC(uint8_t channel_index, AGC_Source_t source, float target_vpp, uint16_t window, float kp, float ki);
+
+/**
+ * @brief 读取FPGA自动增益控制的运行状态
+ * @param status 状态输出
+ */
+void DA_GetAGC(DA_AGC_Status_t *status);
+
 /**
  * @brief 波形变换测试函数
  * @details
@@ -0,0 +1,99 @@
+/**
+ * @file da_sweep.h
+ * @brief FPGA硬件扫频引擎驱动及网络分析(幅频/相频特性)接口
+ * @details
+ * FPGA中的 DA_SWEEP 模块按 起始/终止/步进 频率字自动步进DDS频率，
+ * 每个频点驻留设定时间后进入下一频点，扫频过程中不需要MCU参与。
+ * 同步采集(lockstep)模式下，每个频点驻留结束后FPGA自动打开两路AD FIFO写入，
+ * 写满后暂停等待MCU应答，从而实现"一次配置、逐点采集"的网络分析功能。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#ifndef __DA_SWEEP_H__
+#define __DA_SWEEP_H__
+
+#include "commond_init.h"
+#include "bsp_system.h"
+
+/**
+ * @brief 扫频引擎可管理的最大频点数 (FPGA状态字中频点序号为13位)
+ */
+#define SWEEP_MAX_POINTS 8192
+
+/**
+ * @brief 网络分析中单个频点的测量结果
+ * @details 增益与相位均为 AD2(被测网络输出) 相对 AD1(参考/网络输入) 的值。
+ */
+typedef struct
+{
+    float freq;    // 实际输出频率 (单位: Hz，已按频率字量化)
+    float gain;    // 幅度比 |H| (线性)
+    float gain_db; // 幅度比 (单位: dB)
+    float phase;   // 相位差 (单位: 度, 范围: -180~180)
+} Sweep_Point_t;
+
+/**
+ * @brief 配置扫频参数（仅写入寄存器，不启动）
+ * @param channel_mask 扫频通道 (SWEEP_CTRL_CH_A / SWEEP_CTRL_CH_B 的组合)
+ * @param f_start 起始频率 (单位: Hz)
+ * @param f_stop 终止频率 (单位: Hz)
+ * @param f_step 步进频率 (单位: Hz)
+ * @param dwell_s 每个频点的驻留时间 (单位: s)，用于等待被测网络进入稳态
+ * @return 本次扫频的频点数
+ */
+uint16_t DA_Sweep_Config(uint16_t channel_mask, float f_start, float f_stop, float f_step, float dwell_s);
+
+/**
+ * @brief 启动扫频
+ * @param mode 附加模式位 (SWEEP_CTRL_LOCKSTEP / SWEEP_CTRL_REPEAT 的组合)
+ */
+void DA_Sweep_Start(uint16_t mode);
+
+/**
+ * @brief 停止扫频，DA频率恢复为 DA_Apply_Settings() 写入的值
+ */
+void DA_Sweep_Stop(void);
+
+/**
+ * @brief 同步采集模式下应答当前频点，FPGA进入下一频点
+ */
+void DA_Sweep_Ack(void);
+
+/**
+ * @brief 读取扫频状态字 (SWEEP_STATUS_xxx 位定义见 commond_init.h)
+ */
+uint16_t DA_Sweep_Status(void);
+
+/**
+ * @brief 网络分析：扫频并逐点测量两路AD之间的增益和相位
+ * @details
+ * 1. 以固定采样率 fs 配置两路AD，关闭软件控制的FIFO写入。
+ * 2. 以同步采集模式启动扫频，每个频点由FPGA自动完成采集。
+ * 3. MCU读出两路FIFO数据，在已知的激励频率处计算加汉宁窗的单点DFT，
+ *    得到 H = X2 / X1，然后应答进入下一频点。
+ * 数据读入 ad_measure 的 fifo_data1/fifo_data2，调用前须用 ad_pause(1) 暂停 ad_proc。
+ * 扫频不经过采集流水线 (pipeline.h)：每个频点须在FPGA写满FIFO后读出并应答，
+ * 读出的帧与频点一一对应，且采样率固定为 fs；ad_proc 按自己的节拍读FIFO、
+ * 调整采样率，只发布最新值，会丢帧或读到未写满的FIFO，因此扫频期间独占FIFO和采样率。
+ * @param channel_mask 扫频通道 (SWEEP_CTRL_CH_A / SWEEP_CTRL_CH_B 的组合)
+ * @param f_start 起始频率 (单位: Hz)
+ * @param f_stop 终止频率 (单位: Hz)
+ * @param points 频点数 (>= 2)
+ * @param dwell_s 每个频点的驻留时间 (单位: s)
+ * @param fs AD采样率 (单位: Hz)，需满足 FIFO_SIZE/fs 内包含多个激励周期
+ * @param result 结果数组，长度不小于 points
+ * @return 实际完成测量的频点数 (超时时小于 points)
+ */
+uint16_t DA_Sweep_NetworkAnalyze(uint16_t channel_mask, float f_start, float f_stop, uint16_t points,
+                                 float dwell_s, float fs, Sweep_Point_t *result);
+
+/**
+ * @brief 以预设参数做一次网络分析并通过串口1打印各频点结果 (串口命令0x0C)
+ * @details 预设参数见 da_sweep.c 中的 SWEEP_CMD_xxx。每个频点约18ms (驻留10ms、
+ *          采集4.1ms、两路单点DFT)，100点加打印结果共约2秒，只能在后台调用；
+ *          期间暂停 ad_proc (采集流水线不更新)，结束后停止扫频、DA频率恢复为原设置。
+ */
+void DA_Sweep_Report(void);
+
+#endif // __DA_SWEEP_H__
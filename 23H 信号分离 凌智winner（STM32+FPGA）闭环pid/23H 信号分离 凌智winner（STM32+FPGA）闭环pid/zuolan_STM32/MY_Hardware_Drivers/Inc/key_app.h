@@ -4,6 +4,7 @@
 #include "bsp_system.h"
 
 void key_proc(void);
+void multitone_from_frame(void);
 void set_current_ad_frequency(float freq);
 float get_current_ad_frequency(void);
 
@@ -0,0 +1,65 @@
+/**
+ * @file param_store.h
+ * @brief 控制参数的掉电保存 (片内Flash)
+ * @details
+ * 使用片内Flash的最后一个扇区 (STM32F429IG 扇区11，0x080E0000，128KB) 保存自整定得到的PID增益。
+ * 工程的IROM范围已相应缩小到 0x08000000~0x080DFFFF，代码不会占用该扇区。
+ * 记录带魔数和校验和，保存时先擦除整个扇区 (约1~2秒，期间CPU停顿)，只应在自整定完成后调用。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#ifndef __PARAM_STORE_H__
+#define __PARAM_STORE_H__
+
+#include "bsp_system.h"
+
+#define PARAM_STORE_SECTOR FLASH_SECTOR_11 // 保存参数的Flash扇区
+#define PARAM_STORE_ADDRESS 0x080E0000U    // 扇区起始地址
+#define PARAM_STORE_MAGIC 0x50494447U      // 记录标识 "PIDG"
+#define PARAM_PHASE_BANDS 4                // 相位跟踪环增益调度表的频段数
+
+/**
+ * @brief 保存增益的控制环
+ */
+typedef enum
+{
+    PARAM_LOOP_AMPLITUDE = 0, // 幅度环 (app_pid)
+    PARAM_LOOP_PHASE,         // 相位跟踪环 (stm_sig) 第0个频段，第k个频段为 PARAM_LOOP_PHASE + k
+    PARAM_LOOP_COUNT = PARAM_LOOP_PHASE + PARAM_PHASE_BANDS
+} param_loop_t;
+
+/**
+ * @brief 单个控制环的增益
+ */
+typedef struct
+{
+    float kp;
+    float ki;
+    float kd;
+} param_gains_t;
+
+/**
+ * @brief Flash中的参数记录
+ */
+typedef struct
+{
+    uint32_t magic;                       // PARAM_STORE_MAGIC
+    uint32_t valid;                       // 位图，bit n 对应 param_loop_t 中的第n个控制环
+    param_gains_t gains[PARAM_LOOP_COUNT];
+    uint32_t checksum;                    // 以上各字的累加和取反
+} param_record_t;
+
+/**
+ * @brief 读取某个控制环保存的增益
+ * @return 1=有有效记录，0=未保存或记录损坏
+ */
+uint8_t param_store_load(param_loop_t loop, param_gains_t* gains);
+
+/**
+ * @brief 保存某个控制环的增益，其他控制环的记录保持不变
+ * @return 1=成功，0=擦除或写入失败
+ */
+uint8_t param_store_save(param_loop_t loop, const param_gains_t* gains);
+
+#endif // __PARAM_STORE_H__
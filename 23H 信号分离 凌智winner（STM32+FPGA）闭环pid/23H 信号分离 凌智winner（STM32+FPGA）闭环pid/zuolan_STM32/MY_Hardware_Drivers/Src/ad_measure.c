@@ -10,6 +10,7 @@ u16 vol_maxnum1, vol_minnum1, vol_maxnum2, vol_minnum2;
 u16 fifo_data1[FIFO_SIZE], fifo_data2[FIFO_SIZE];       // 采样结果
 float fifo_data1_f[FIFO_SIZE], fifo_data2_f[FIFO_SIZE]; // 采样结果转换为浮点数
 float vol_amp1, vol_amp2;
+static volatile uint8_t ad_paused = 0; // 1=AD FIFO 被网络分析扫频占用，ad_proc 不采集
 
 /**
  * @brief 查找数组中的最大和最小值
@@ -164,10 +165,33 @@ void vpp_adc_parallel(float ad1_freq, float ad2_freq)
 }
 
 
+/**
+ * @brief 暂停/恢复 ad_proc 的周期采集
+ * @details 网络分析扫频期间由扫频引擎控制AD采样率和FIFO写入，ad_proc 运行在更高的
+ *          优先级，不暂停会在扫频中途改写采样率并读走FIFO数据。
+ * @param pause 1=暂停，0=恢复
+ */
+void ad_pause(uint8_t pause)
+{
+    ad_paused = pause;
+}
+
 void ad_proc(void)
 {
+   if (ad_paused)
+       return;
 	 
    vpp_adc_parallel(2000000, 2000000);   
+
+   // 发布到流水线：分析级取整帧 (直接写入三缓冲的槽，不另留4KB副本)，控制级取峰峰值
+   uint32_t tick = HAL_GetTick();
+   ad_frame_t *frame = SPSC_WRITE_SLOT(ad_frame_queue, ad_frame_t);
+   memcpy(frame->samples, fifo_data1_f, sizeof(frame->samples));
+   frame->tick = tick;
+   spsc_commit(&ad_frame_queue);
+
+   amp_sample_t amp = {vol_amp1, vol_amp2, tick};
+   SPSC_PUSH(amp_queue, amp);
 	 
 	 
 	 
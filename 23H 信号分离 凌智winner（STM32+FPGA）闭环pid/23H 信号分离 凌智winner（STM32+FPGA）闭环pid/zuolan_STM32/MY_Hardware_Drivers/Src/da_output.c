@@ -29,6 +29,11 @@
  */
 DA_Channel_t da_channels[NUM_DA_CHANNELS] = {0};
 
+#define AGC_PEAK_MV 3080.0f       // 增益1.0对应的峰值电压，与 VOLTAGE_SCALER_CLOCKED 的 DEFAULT_PEAK_MV 一致
+#define AGC_CODES_PER_VOLT 204.8f // 并行AD码值/V，与 ad_measure.c 的 ADC_SCALE / VOLTAGE_OFFSET 一致
+
+static uint16_t agc_ctrl = 0; // AGC控制字副本，读状态时切换选择位
+
 /**
  * @brief 初始化DA的默认参数并应用
  * @details
@@ -127,6 +132,180 @@ void DA_Apply_Settings(void)
     DA_FPGA_START();
 }
 
+/**
+ * @brief 只把指定通道的频率字写入FPGA寄存器
+ * @details 频率字换算与 DA_Apply_Settings() 一致，不调用 DA_FPGA_STOP()/DA_FPGA_START()。
+ */
+void DA_SetFrequency(uint8_t channel_index, float freq)
+{
+    if (channel_index >= NUM_DA_CHANNELS)
+    {
+        return;
+    }
+
+    da_channels[channel_index].frequency = freq;
+    unsigned int M = DA_FREQ_CONSTANT * freq / FPGA_BASE_CLK * DA_FIFO_SIZE;
+    if (channel_index == 0)
+    {
+        DA1_H = M >> 16;
+        DA1_L = M & 0x0000FFFF;
+    }
+    else
+    {
+        DA2_H = M >> 16;
+        DA2_L = M & 0x0000FFFF;
+    }
+}
+
+/**
+ * @brief 将多音合成参数写入FPGA寄存器
+ * @details
+ * 1. 统计各分量相对幅度之和，若超过1则等比缩小，避免FPGA端输出饱和削顶。
+ * 2. 幅度按Q0.16格式写入 (1.0 -> 65535)。
+ * 3. 相位由角度转换为0~1023，与谐波次数一起写入同一个寄存器。
+ * 4. 剩余分量的谐波次数写0，即关闭。
+ */
+void DA_SetMultitone(uint8_t channel_index, const DA_Tone_t *tones, uint8_t count)
+{
+    if (channel_index >= NUM_DA_CHANNELS)
+    {
+        return;
+    }
+    if (count > DA_MT_TONES)
+    {
+        count = DA_MT_TONES;
+    }
+
+    uint16_t base = (channel_index == 0) ? DA1_MT_BASE : DA2_MT_BASE;
+
+    // 计算幅度归一化系数
+    float amp_sum = 0.0f;
+    for (uint8_t k = 0; k < count; k++)
+    {
+        if (tones[k].harmonic != 0 && tones[k].amplitude > 0.0f)
+        {
+            amp_sum += tones[k].amplitude;
+        }
+    }
+    float amp_scale = (amp_sum > 1.0f) ? (1.0f / amp_sum) : 1.0f;
+
+    for (uint8_t k = 0; k < DA_MT_TONES; k++)
+    {
+        if (k < count && tones[k].harmonic != 0 && tones[k].amplitude > 0.0f)
+        {
+            uint16_t harm = (tones[k].harmonic > 63) ? 63 : tones[k].harmonic;
+            uint16_t ph = (uint16_t)(roundf((tones[k].phase % 360) * 2.844f)) & 0x3FF;
+            DA_MT_AMP(base, k) = (uint16_t)(tones[k].amplitude * amp_scale * 65535.0f);
+            DA_MT_PH_HARM(base, k) = (harm << 10) | ph;
+        }
+        else
+        {
+            DA_MT_AMP(base, k) = 0;
+            DA_MT_PH_HARM(base, k) = 0;
+        }
+    }
+
+    da_channels[channel_index].waveform = WAVE_MULTITONE;
+}
+
+/**
+ * @brief 将调制参数写入FPGA调制器
+ * @details
+ * 1. LFO频率字按FPGA主时钟换算: word = f * 2^32 / FPGA_BASE_CLK。
+ * 2. 调制深度按模式换算:
+ *    AM 调制度转换为Q0.16；FM 频偏与DA频率字同单位；PM 角度转换为0~511。
+ * 3. 先写参数后写控制字，控制字写入后调制立即生效。
+ */
+void DA_SetModulation(uint8_t channel_index, Modulation_t mode, float mod_freq, float depth)
+{
+    if (channel_index >= NUM_DA_CHANNELS || mode == MOD_OFF || mod_freq <= 0.0f || depth <= 0.0f)
+    {
+        DA_MOD_CTRL = MOD_OFF;
+        return;
+    }
+
+    unsigned int lfo_word = DA_FREQ_CONSTANT * mod_freq / FPGA_BASE_CLK;
+    unsigned int depth_word = 0;
+
+    switch (mode)
+    {
+    case MOD_AM:
+        depth_word = (depth >= 1.0f) ? 65535 : (unsigned int)(depth * 65535.0f);
+        break;
+    case MOD_FM:
+        // 与 DA_Apply_Settings() 中的频率字换算一致
+        depth_word = DA_FREQ_CONSTANT * depth / FPGA_BASE_CLK * DA_FIFO_SIZE;
+        break;
+    case MOD_PM:
+        depth_word = (depth >= 180.0f) ? 511 : (unsigned int)(roundf(depth * 2.844f));
+        break;
+    default:
+        break;
+    }
+
+    DA_MOD_CTRL = MOD_OFF;
+    DA_MOD_LFO_H = lfo_word >> 16;
+    DA_MOD_LFO_L = lfo_word & 0x0000FFFF;
+    DA_MOD_DEPTH_H = depth_word >> 16;
+    DA_MOD_DEPTH_L = depth_word & 0x0000FFFF;
+    DA_MOD_CTRL = (channel_index << 2) | mode;
+}
+
+/**
+ * @brief PI系数从 mV/V 换算为FPGA的Q8.8 (增益LSB/码值)
+ * @details 增益LSB = 65536 / AGC_PEAK_MV mV，码值 = 1 / AGC_CODES_PER_VOLT V。
+ */
+static uint16_t DA_AGC_Coef(float k)
+{
+    float word = k * (65536.0f / AGC_PEAK_MV) / AGC_CODES_PER_VOLT * 256.0f;
+    if (word <= 0.0f)
+    {
+        return 0;
+    }
+    return (word >= 65535.0f) ? 65535 : (uint16_t)(word + 0.5f);
+}
+
+/**
+ * @brief 将AGC参数写入FPGA
+ * @details 先关闭再写参数，最后写控制字：关闭期间FPGA积分器跟随 vpp 设定，开启时输出不跳变。
+ */
+void DA_SetAGC(uint8_t channel_index, AGC_Source_t source, float target_vpp, uint16_t window, float kp, float ki)
+{
+    DA_AGC_CTRL = 0;
+    agc_ctrl = 0;
+    if (channel_index >= NUM_DA_CHANNELS || target_vpp <= 0.0f)
+    {
+        return;
+    }
+
+    float target = target_vpp * AGC_CODES_PER_VOLT;
+    DA_AGC_TARGET = (target >= 4095.0f) ? 4095 : (uint16_t)(target + 0.5f);
+    DA_AGC_WINDOW = window;
+    DA_AGC_KP = DA_AGC_Coef(kp);
+    DA_AGC_KI = DA_AGC_Coef(ki);
+
+    agc_ctrl = DA_AGC_CTRL_EN | (source == AGC_SRC_AD2 ? DA_AGC_CTRL_SRC_AD2 : 0) | (channel_index ? DA_AGC_CTRL_CH_B : 0);
+    DA_AGC_CTRL = agc_ctrl;
+}
+
+/**
+ * @brief 读取AGC状态
+ * @details 状态字和当前增益共用FMC读地址15，由控制字的选择位切换，读完恢复控制字。
+ */
+void DA_GetAGC(DA_AGC_Status_t *status)
+{
+    DA_AGC_CTRL = agc_ctrl & ~DA_AGC_CTRL_SEL_GAIN;
+    uint16_t word = DA_AGC_STATUS;
+    DA_AGC_CTRL = agc_ctrl | DA_AGC_CTRL_SEL_GAIN;
+    uint16_t gain = DA_AGC_STATUS;
+    DA_AGC_CTRL = agc_ctrl;
+
+    status->locked = (word & DA_AGC_STATUS_LOCKED) ? 1 : 0;
+    status->saturated = (word & DA_AGC_STATUS_SATURATED) ? 1 : 0;
+    status->vpp = (word & DA_AGC_STATUS_PP) / AGC_CODES_PER_VOLT;
+    status->peak_mv = gain * AGC_PEAK_MV / 65536.0f;
+}
+
 // ------------------- 测试函数更新 -------------------
 
 // 用于非阻塞延时的计时器变量，记录上次波形切换的时间
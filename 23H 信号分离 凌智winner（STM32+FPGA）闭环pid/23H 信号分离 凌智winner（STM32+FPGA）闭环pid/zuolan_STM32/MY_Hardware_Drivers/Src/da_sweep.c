@@ -0,0 +1,244 @@
+/**
+ * @file da_sweep.c
+ * @brief FPGA硬件扫频引擎驱动及网络分析实现
+ * @details
+ * 1. 把以Hz为单位的扫频参数换算为FPGA的频率字和驻留时钟数并写入寄存器。
+ * 2. 维护扫频控制字的影子值，保证应答(ACK)写入时不改变运行/通道位。
+ * 3. 网络分析：同步采集模式下逐点读取两路AD FIFO，计算增益和相位。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#include "da_sweep.h"
+#include "ad_measure.h"
+#include "math.h"
+
+#define SWEEP_PI 3.14159265358979f
+#define SWEEP_TIMEOUT_MS 100 // 单个频点采集的额外超时时间
+
+// 串口命令0x0C的预设网络分析参数：DA1激励，1kHz~100kHz共100点，
+// 采样率250kHz (FIFO时长约4ms，1kHz处包含4个周期)
+#define SWEEP_CMD_CHANNEL SWEEP_CTRL_CH_A
+#define SWEEP_CMD_F_START 1000.0f
+#define SWEEP_CMD_F_STOP 100000.0f
+#define SWEEP_CMD_POINTS 100
+#define SWEEP_CMD_DWELL_S 0.01f
+#define SWEEP_CMD_FS 250000.0f
+
+// 扫频控制字影子值 (不含 RUN/ACK 位)
+static uint16_t sweep_ctrl = 0;
+// 当前扫频的起始频率字和步进频率字，用于还原每个频点的实际频率
+static uint32_t sweep_start_word = 0;
+static uint32_t sweep_step_word = 0;
+// 每个频点的驻留时间 (ms)，用于计算超时
+static uint32_t sweep_dwell_ms = 0;
+
+/**
+ * @brief 频率(Hz)转换为DA频率字，与 DA_Apply_Settings() 中的换算一致
+ * @note 使用双精度计算，避免步进频率字在累加后产生明显的频率偏差
+ */
+static uint32_t sweep_freq_to_word(float freq)
+{
+    return (uint32_t)((double)DA_FREQ_CONSTANT * freq / FPGA_BASE_CLK * DA_FIFO_SIZE + 0.5);
+}
+
+/**
+ * @brief DA频率字转换为实际输出频率(Hz)
+ */
+static float sweep_word_to_freq(uint32_t word)
+{
+    return (float)((double)word * FPGA_BASE_CLK / DA_FREQ_CONSTANT / DA_FIFO_SIZE);
+}
+
+/**
+ * @brief 以频率字写入扫频寄存器
+ */
+static void sweep_write_words(uint32_t start, uint32_t stop, uint32_t step, uint32_t dwell)
+{
+    SWEEP_START_H = start >> 16;
+    SWEEP_START_L = start & 0xFFFF;
+    SWEEP_STOP_H = stop >> 16;
+    SWEEP_STOP_L = stop & 0xFFFF;
+    SWEEP_STEP_H = step >> 16;
+    SWEEP_STEP_L = step & 0xFFFF;
+    SWEEP_DWELL_H = dwell >> 16;
+    SWEEP_DWELL_L = dwell & 0xFFFF;
+
+    sweep_start_word = start;
+    sweep_step_word = step;
+}
+
+/**
+ * @brief 以指定点数配置扫频，终止频率字取为 起始 + (点数-1) * 步进，避免量化误差导致少扫一点
+ */
+static uint16_t sweep_config_points(uint16_t channel_mask, float f_start, float f_stop, uint16_t points, float dwell_s)
+{
+    if (points < 2)
+        points = 2;
+    if (points > SWEEP_MAX_POINTS)
+        points = SWEEP_MAX_POINTS;
+
+    uint32_t start = sweep_freq_to_word(f_start);
+    uint32_t stop = sweep_freq_to_word(f_stop);
+    uint32_t step = (stop > start) ? (stop - start) / (points - 1) : 0;
+    if (step == 0)
+        points = 1;
+
+    uint32_t dwell = (uint32_t)(dwell_s * FPGA_BASE_CLK);
+    sweep_dwell_ms = (uint32_t)(dwell_s * 1000.0f);
+
+    sweep_write_words(start, start + step * (points - 1), step, dwell);
+    sweep_ctrl = channel_mask & (SWEEP_CTRL_CH_A | SWEEP_CTRL_CH_B);
+    return points;
+}
+
+uint16_t DA_Sweep_Config(uint16_t channel_mask, float f_start, float f_stop, float f_step, float dwell_s)
+{
+    uint32_t points = 2;
+    if (f_step > 0 && f_stop > f_start)
+        points = (uint32_t)((f_stop - f_start) / f_step) + 1;
+    if (points > SWEEP_MAX_POINTS)
+        points = SWEEP_MAX_POINTS;
+
+    // 以步进频率为准，终止频率向下取整到最后一个完整步进
+    return sweep_config_points(channel_mask, f_start, f_start + f_step * (points - 1), points, dwell_s);
+}
+
+void DA_Sweep_Start(uint16_t mode)
+{
+    sweep_ctrl = (sweep_ctrl & (SWEEP_CTRL_CH_A | SWEEP_CTRL_CH_B)) |
+                 (mode & (SWEEP_CTRL_LOCKSTEP | SWEEP_CTRL_REPEAT));
+
+    // 引擎只在空闲状态响应启动命令，先停止上一次扫频
+    SWEEP_CTRL = sweep_ctrl;
+    SWEEP_CTRL = sweep_ctrl | SWEEP_CTRL_RUN;
+}
+
+void DA_Sweep_Stop(void)
+{
+    SWEEP_CTRL = sweep_ctrl;
+}
+
+void DA_Sweep_Ack(void)
+{
+    SWEEP_CTRL = sweep_ctrl | SWEEP_CTRL_RUN | SWEEP_CTRL_ACK;
+}
+
+uint16_t DA_Sweep_Status(void)
+{
+    return SWEEP_STATUS;
+}
+
+/**
+ * @brief 计算加汉宁窗的单点DFT (频率不必落在FFT频点上)
+ * @param data 时域数据
+ * @param w 数字角频率 2*pi*f/fs
+ * @param re 输出实部
+ * @param im 输出虚部
+ */
+static void sweep_single_dft(const float *data, float w, float *re, float *im)
+{
+    float mean = 0.0f;
+    for (int i = 0; i < FIFO_SIZE; i++)
+        mean += data[i];
+    mean /= FIFO_SIZE;
+
+    float sr = 0.0f, si = 0.0f;
+    for (int i = 0; i < FIFO_SIZE; i++)
+    {
+        float win = 0.5f - 0.5f * cosf(2.0f * SWEEP_PI * i / FIFO_SIZE);
+        float x = (data[i] - mean) * win;
+        sr += x * cosf(w * i);
+        si -= x * sinf(w * i);
+    }
+    *re = sr;
+    *im = si;
+}
+
+uint16_t DA_Sweep_NetworkAnalyze(uint16_t channel_mask, float f_start, float f_stop, uint16_t points,
+                                 float dwell_s, float fs, Sweep_Point_t *result)
+{
+    if (result == NULL || points == 0 || fs <= 0)
+        return 0;
+
+    points = sweep_config_points(channel_mask, f_start, f_stop, points, dwell_s);
+
+    // 两路AD使用相同的采样率；FIFO写入交由扫频引擎控制
+    // 数据读入 ad_measure 的采集缓冲区，调用前须用 ad_pause() 暂停 ad_proc
+    setSamplingFrequency(fs / FIFO_SIZE_N, 1);
+    setSamplingFrequency(fs / FIFO_SIZE_N, 2);
+    AD_FIFO_WRITE_DISABLE(1);
+    AD_FIFO_WRITE_DISABLE(2);
+    // 清空FIFO中的旧数据，否则第一个频点会因FIFO已满而立即就绪
+    readFIFOData(1, fifo_data1, fifo_data1_f);
+    readFIFOData(2, fifo_data2, fifo_data2_f);
+
+    DA_Sweep_Start(SWEEP_CTRL_LOCKSTEP);
+
+    uint32_t timeout = sweep_dwell_ms + (uint32_t)(FIFO_SIZE * 1000.0f / fs) + SWEEP_TIMEOUT_MS;
+    uint16_t done = 0;
+    while (done < points)
+    {
+        // 等待当前频点两路FIFO写满
+        uint32_t t0 = HAL_GetTick();
+        while ((SWEEP_STATUS & SWEEP_STATUS_READY) == 0)
+        {
+            if (HAL_GetTick() - t0 > timeout)
+            {
+                DA_Sweep_Stop();
+                return done;
+            }
+        }
+
+        readFIFOData(1, fifo_data1, fifo_data1_f);
+        readFIFOData(2, fifo_data2, fifo_data2_f);
+
+        uint16_t idx = SWEEP_STATUS & SWEEP_STATUS_INDEX;
+        float freq = sweep_word_to_freq(sweep_start_word + sweep_step_word * idx);
+        float w = 2.0f * SWEEP_PI * freq / fs;
+
+        float re1, im1, re2, im2;
+        sweep_single_dft(fifo_data1_f, w, &re1, &im1);
+        sweep_single_dft(fifo_data2_f, w, &re2, &im2);
+
+        // H = X2 / X1
+        float mag1 = sqrtf(re1 * re1 + im1 * im1);
+        float mag2 = sqrtf(re2 * re2 + im2 * im2);
+        float phase = (atan2f(im2, re2) - atan2f(im1, re1)) * 180.0f / SWEEP_PI;
+        if (phase > 180.0f)
+            phase -= 360.0f;
+        else if (phase <= -180.0f)
+            phase += 360.0f;
+
+        result[done].freq = freq;
+        result[done].gain = (mag1 > 0.0f) ? mag2 / mag1 : 0.0f;
+        result[done].gain_db = (result[done].gain > 0.0f) ? 20.0f * log10f(result[done].gain) : -200.0f;
+        result[done].phase = phase;
+        done++;
+
+        DA_Sweep_Ack();
+    }
+
+    return done;
+}
+
+void DA_Sweep_Report(void)
+{
+    static Sweep_Point_t result[SWEEP_CMD_POINTS]; // 1.6KB，不放在栈上
+    uint16_t n, i;
+
+    my_printf(&huart1, "网络分析: %.0f~%.0fHz %d点\r\n", SWEEP_CMD_F_START, SWEEP_CMD_F_STOP, SWEEP_CMD_POINTS);
+
+    ad_pause(1);
+    n = DA_Sweep_NetworkAnalyze(SWEEP_CMD_CHANNEL, SWEEP_CMD_F_START, SWEEP_CMD_F_STOP, SWEEP_CMD_POINTS,
+                                SWEEP_CMD_DWELL_S, SWEEP_CMD_FS, result);
+    DA_Sweep_Stop();
+    ad_pause(0);
+
+    my_printf(&huart1, "频率(Hz)\t增益\t增益(dB)\t相位(度)\r\n");
+    for (i = 0; i < n; i++)
+        my_printf(&huart1, "%.1f\t%.4f\t%.2f\t%.1f\r\n", result[i].freq, result[i].gain, result[i].gain_db,
+                  result[i].phase);
+    if (n < SWEEP_CMD_POINTS)
+        my_printf(&huart1, "扫频超时，完成%d点\r\n", n);
+}
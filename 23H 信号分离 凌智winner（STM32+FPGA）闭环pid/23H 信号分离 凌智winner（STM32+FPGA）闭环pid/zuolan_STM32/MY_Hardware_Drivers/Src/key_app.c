@@ -2,6 +2,7 @@
 #include "ad_measure.h"
 #include "my_fft.h"
 #include "da_output.h"
+#include "goertzel_bank.h"
 
 uint8_t key_val = 0;
 uint8_t key_old = 0;
@@ -10,6 +11,8 @@ uint8_t key_up = 0;
 float detected_freq = 0.0f;
 // 当前AD采集频率
 static float current_ad_freq = 2000000.0f; // 默认2MHz
+// 分析用的采样帧：直接指向流水线三缓冲中消费者持有的槽，下一次取帧前采集任务不会改写
+static ad_frame_t* analysis_frame;
 
 
 uint8_t key_read(void)
@@ -48,6 +51,34 @@ float get_current_ad_frequency(void)
 	return current_ad_freq;
 }
 
+/**
+ * @brief 按最新采集帧的谐波结构配置DA1多音输出 (串口命令0x0D)
+ * @details 对最新一帧做FFT，以幅度最大的谱峰为基波，由
+ *          configure_da_multitone_from_spectrum() 复现各次谐波的幅度和相位。
+ *          与按键处理共用分析帧，只能在后台调用。
+ */
+void multitone_from_frame(void)
+{
+	peak_info_t fundamental;
+
+	if((analysis_frame = SPSC_READ_SLOT(ad_frame_queue, ad_frame_t)) == NULL)
+	{
+		my_printf(&huart1,"无新采集帧\r\n");
+		return;
+	}
+	calculate_fft_spectrum(analysis_frame->samples, FIFO_SIZE);
+	// 平均功率谱没有并入这一帧，其门限可能来自之前的信号，不用它剔除峰值
+	if(find_spectrum_peaks(&fundamental, 1, current_ad_freq, 0.0f, 0) == 0)
+	{
+		my_printf(&huart1,"未找到基波，DA未改变\r\n");
+		return;
+	}
+	if(configure_da_multitone_from_spectrum(0, fundamental.bin_index) == 0)
+	{
+		my_printf(&huart1,"基波 %.0f Hz 无有效谐波，DA未改变\r\n", fundamental.frequency);
+	}
+}
+
 void key_proc(void)
 {
 	key_val = key_read();
@@ -101,9 +132,14 @@ void key_proc(void)
 		
 		case 2: // 按键2：输出当前缓冲区采集波形
 		{
+			if((analysis_frame = SPSC_READ_SLOT(ad_frame_queue, ad_frame_t)) == NULL)
+			{
+				my_printf(&huart1,"无新采集帧\r\n");
+				break;
+			}
 			for(int i=0;i<FIFO_SIZE;i++)
 			{
-				my_printf(&huart1,"%.4f\r\n", fifo_data1_f[i]);
+				my_printf(&huart1,"%.4f\r\n", analysis_frame->samples[i]);
 			}
      	
 		}
@@ -138,11 +174,28 @@ void key_proc(void)
 		
 		case 4: // 按键4：双峰检测分析并配置DA输出
 		{
-			// 执行双峰检测分析
-			perform_dual_peak_analysis(fifo_data1_f, FIFO_SIZE);
+			// 先在候选频率网格上检测，计算量远小于完整FFT
+			grid_result_t grid_result;
+			if((analysis_frame = SPSC_READ_SLOT(ad_frame_queue, ad_frame_t)) == NULL)
+			{
+				my_printf(&huart1,"无新采集帧\r\n");
+				break;
+			}
+			goertzel_bank_detect(analysis_frame->samples, FIFO_SIZE, current_ad_freq, 0.15f, &grid_result);
+			goertzel_bank_output(&grid_result);
+			if(configure_da_output_from_grid(&grid_result))
+			{
+				break;
+			}
+			
+			// 信号不在网格上，执行双峰检测分析
+			perform_dual_peak_analysis(analysis_frame->samples, FIFO_SIZE);
 			
 			// 根据检测结果配置DA输出
 			configure_da_output_from_peaks();
+			
+			// 在HMI上显示本次采集的频谱指标
+			output_spectrum_features_hmi();
 		}
 			break;
 		
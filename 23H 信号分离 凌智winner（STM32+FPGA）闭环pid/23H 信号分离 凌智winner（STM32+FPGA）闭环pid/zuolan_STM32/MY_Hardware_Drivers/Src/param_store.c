@@ -0,0 +1,96 @@
+/**
+ * @file param_store.c
+ * @brief 控制参数的掉电保存实现
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#include "param_store.h"
+
+#define PARAM_RECORD_WORDS (sizeof(param_record_t) / sizeof(uint32_t))
+
+/**
+ * @brief 计算记录的校验和 (不含校验和字段本身)
+ */
+static uint32_t param_checksum(const param_record_t* record)
+{
+    const uint32_t* words = (const uint32_t*)record;
+    uint32_t sum = 0;
+
+    for(uint32_t i = 0; i < PARAM_RECORD_WORDS - 1; i++)
+    {
+        sum += words[i];
+    }
+
+    return ~sum;
+}
+
+/**
+ * @brief 读取Flash中的记录
+ * @return 1=记录有效
+ */
+static uint8_t param_read(param_record_t* record)
+{
+    memcpy(record, (const void*)PARAM_STORE_ADDRESS, sizeof(param_record_t));
+
+    return (record->magic == PARAM_STORE_MAGIC && record->checksum == param_checksum(record));
+}
+
+uint8_t param_store_load(param_loop_t loop, param_gains_t* gains)
+{
+    param_record_t record;
+
+    if(loop >= PARAM_LOOP_COUNT || !param_read(&record) || !(record.valid & (1U << loop)))
+    {
+        return 0;
+    }
+
+    *gains = record.gains[loop];
+    return 1;
+}
+
+uint8_t param_store_save(param_loop_t loop, const param_gains_t* gains)
+{
+    param_record_t record;
+    FLASH_EraseInitTypeDef erase;
+    uint32_t sector_error = 0;
+    uint8_t ok = 1;
+
+    if(loop >= PARAM_LOOP_COUNT)
+    {
+        return 0;
+    }
+
+    // 保留其他控制环已保存的增益
+    if(!param_read(&record))
+    {
+        memset(&record, 0, sizeof(record));
+        record.magic = PARAM_STORE_MAGIC;
+    }
+    record.gains[loop] = *gains;
+    record.valid |= (1U << loop);
+    record.checksum = param_checksum(&record);
+
+    erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+    erase.Sector = PARAM_STORE_SECTOR;
+    erase.NbSectors = 1;
+    erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+
+    HAL_FLASH_Unlock();
+    if(HAL_FLASHEx_Erase(&erase, &sector_error) != HAL_OK)
+    {
+        ok = 0;
+    }
+
+    const uint32_t* words = (const uint32_t*)&record;
+    for(uint32_t i = 0; ok && i < PARAM_RECORD_WORDS; i++)
+    {
+        if(HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, PARAM_STORE_ADDRESS + i * 4, words[i]) != HAL_OK)
+        {
+            ok = 0;
+        }
+    }
+    HAL_FLASH_Lock();
+
+    return ok;
+}
@@ -15,6 +15,16 @@ void DA_FPGA_START(void);
  */
 void DA_FPGA_STOP(void);
 
+/**
+ * @brief DAɢ (NCOλ + Ƚض)
+ */
+void DA_DITHER_ENABLE(void);
+
+/**
+ * @brief رDAɢơ
+ */
+void DA_DITHER_DISABLE(void);
+
 void AD_FREQ_CLR_ENABLE(int ch);
 void AD_FREQ_CLR_DISABLE(int ch);
 void AD_FREQ_START(int ch);
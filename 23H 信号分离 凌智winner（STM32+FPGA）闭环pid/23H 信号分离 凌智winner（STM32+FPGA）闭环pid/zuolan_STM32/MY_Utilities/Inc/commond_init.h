@@ -127,15 +127,20 @@ enum
     AD1_FREQ_CLR   = 256,  // bit 8:  0=触发清除AD1测频计数器 (低电平有效)
     AD1_FREQ_START = 512,  // bit 9:  1=启动AD1测频计数
     AD2_FREQ_CLR   = 1024, // bit 10: 0=触发清除AD2测频计数器 (低电平有效)
-    AD2_FREQ_START = 2048  // bit 11: 1=启动AD2测频计数
+    AD2_FREQ_START = 2048, // bit 11: 1=启动AD2测频计数
+    DA_DITHER_EN   = 4096  // bit 12: 1=开启DA相位抖动和幅度截断噪声整形 (抑制杂散)
 };
 
 //-----------------------------------------------------------------
 // 5. FPGA 寄存器地址映射
 // (通过FSMC/FMC将FPGA内部寄存器映射到STM32的内存地址空间)
 //-----------------------------------------------------------------
-// 基础宏：计算FPGA寄存器的绝对地址。基地址0x64000000, 偏移量addr是16位字地址。
-#define reg_addr(addr) ((uint32_t *)(0x64000000 + ((addr) << 1)))
+// FPGA寄存器区基地址 (FMC Bank1 NE2)。主机仿真 (sim/) 时重定义为内存数组的地址。
+#ifndef FPGA_REG_BASE
+#define FPGA_REG_BASE 0x64000000
+#endif
+// 基础宏：计算FPGA寄存器的绝对地址。偏移量addr是16位字地址。
+#define reg_addr(addr) ((uint32_t *)(FPGA_REG_BASE + ((addr) << 1)))
 
 // --- 寄存器定义 (区分读写功能) ---
 
@@ -193,6 +198,67 @@ enum
 #define DA1_VPP       *(vu16 *)reg_addr(14)
 #define DA2_VPP       *(vu16 *)reg_addr(15)
 
+// --- 扩展寄存器 (地址 >= 0x10, 由各功能模块自行译码, 只写) ---
+
+// 地址 0x20~0x2F / 0x30~0x3F: DA1 / DA2 多音合成寄存器组 (波形选择码4时生效)
+// BASE+2k: 第k个分量幅度 (Q0.16);  BASE+2k+1: [9:0]初相, [15:10]谐波次数
+#define DA1_MT_BASE   0x20
+#define DA2_MT_BASE   0x30
+#define DA_MT_AMP(base, k)     *(vu16 *)reg_addr((base) + 2 * (k))
+#define DA_MT_PH_HARM(base, k) *(vu16 *)reg_addr((base) + 2 * (k) + 1)
+
+// 地址 0x40~0x48: 硬件扫频寄存器组 (频率字与 DA1_H/DA1_L 同单位)
+#define SWEEP_START_H *(vu16 *)reg_addr(0x40)
+#define SWEEP_START_L *(vu16 *)reg_addr(0x41)
+#define SWEEP_STOP_H  *(vu16 *)reg_addr(0x42)
+#define SWEEP_STOP_L  *(vu16 *)reg_addr(0x43)
+#define SWEEP_STEP_H  *(vu16 *)reg_addr(0x44)
+#define SWEEP_STEP_L  *(vu16 *)reg_addr(0x45)
+#define SWEEP_DWELL_H *(vu16 *)reg_addr(0x46) // 每个频点驻留的FPGA主时钟周期数
+#define SWEEP_DWELL_L *(vu16 *)reg_addr(0x47)
+#define SWEEP_CTRL    *(vu16 *)reg_addr(0x48)
+
+// 扫频控制字位定义 (写 SWEEP_CTRL)
+#define SWEEP_CTRL_RUN      0x0001 // 1=启动, 0=停止
+#define SWEEP_CTRL_CH_A     0x0002 // 扫频作用于DA1
+#define SWEEP_CTRL_CH_B     0x0004 // 扫频作用于DA2
+#define SWEEP_CTRL_LOCKSTEP 0x0008 // 每个频点触发AD采集并等待应答
+#define SWEEP_CTRL_ACK      0x0010 // 应答，进入下一频点
+#define SWEEP_CTRL_REPEAT   0x0020 // 循环扫频
+
+// 地址 0x50~0x54: DA调制器寄存器组
+#define DA_MOD_CTRL     *(vu16 *)reg_addr(0x50) // [1:0]模式 0关/1AM/2FM/3PM, [2]目标通道 0=DA1 1=DA2
+#define DA_MOD_LFO_H    *(vu16 *)reg_addr(0x51) // LFO频率字, f = word * FPGA_BASE_CLK / 2^32
+#define DA_MOD_LFO_L    *(vu16 *)reg_addr(0x52)
+#define DA_MOD_DEPTH_H  *(vu16 *)reg_addr(0x53) // 调制深度, 单位随模式不同 (见 DA_MODULATOR.v)
+#define DA_MOD_DEPTH_L  *(vu16 *)reg_addr(0x54)
+
+// 地址 0x60~0x64: DA自动增益控制(AGC)寄存器组
+#define DA_AGC_CTRL     *(vu16 *)reg_addr(0x60)
+#define DA_AGC_TARGET   *(vu16 *)reg_addr(0x61) // 目标峰峰值 (AD码值)
+#define DA_AGC_WINDOW   *(vu16 *)reg_addr(0x62) // 检测窗口长度 (AD采样点数)
+#define DA_AGC_KP       *(vu16 *)reg_addr(0x63) // 比例系数 Q8.8 (增益LSB/码值)
+#define DA_AGC_KI       *(vu16 *)reg_addr(0x64) // 积分系数 Q8.8 (增益LSB/码值/窗口)
+
+// AGC控制字位定义 (写 DA_AGC_CTRL)
+#define DA_AGC_CTRL_EN       0x0001 // 1=开启
+#define DA_AGC_CTRL_SRC_AD2  0x0002 // 检测源 0=AD1, 1=AD2
+#define DA_AGC_CTRL_CH_B     0x0004 // 目标通道 0=DA1, 1=DA2
+#define DA_AGC_CTRL_SEL_GAIN 0x0008 // 状态字 0=峰峰值与标志, 1=当前增益
+
+// 地址 14: 扫频状态字 (FPGA -> STM32, 只读; 写地址14仍为 DA1_VPP)
+#define SWEEP_STATUS  *(vu16 *)reg_addr(14)
+#define SWEEP_STATUS_BUSY  0x8000
+#define SWEEP_STATUS_READY 0x4000 // 当前频点两路AD FIFO均已写满
+#define SWEEP_STATUS_DONE  0x2000
+#define SWEEP_STATUS_INDEX 0x1FFF // 当前频点序号
+
+// 地址 15: AGC状态字 (FPGA -> STM32, 只读; 写地址15仍为 DA2_VPP)
+#define DA_AGC_STATUS   *(vu16 *)reg_addr(15)
+#define DA_AGC_STATUS_LOCKED    0x8000 // 连续4个窗口误差在目标值1/64以内
+#define DA_AGC_STATUS_SATURATED 0x4000 // 输出增益达到上限或下限
+#define DA_AGC_STATUS_PP        0x0FFF // 最近一个窗口的峰峰值 (AD码值)
+
 //-----------------------------------------------------------------
 // 6. 系统级常量定义
 //-----------------------------------------------------------------
@@ -0,0 +1,110 @@
+/**
+ * @file spsc_queue.h
+ * @brief 单生产者/单消费者无锁队列
+ * @details
+ * 用于在不同优先级、不同速率的任务之间传递数据，生产者和消费者都不会阻塞：
+ * - SPSC_EVERY_VALUE：环形队列，每个数据都按顺序交给消费者；队列满时丢弃新数据并计数；
+ * - SPSC_LATEST_VALUE：三缓冲，消费者只取最新的数据，未读的旧数据被新数据覆盖并计数，
+ *   生产者永远可以写入，适合慢速分析读取快速采集的结果。
+ * 生产者只写 head (或交换 middle)，消费者只写 tail (或交换 middle)，中断中使用时无需关中断。
+ * 一个队列只能有一个生产者和一个消费者，同一数据需要交给多个消费者时应使用多个队列。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#ifndef __SPSC_QUEUE_H__
+#define __SPSC_QUEUE_H__
+
+#include <stdint.h>
+
+/**
+ * @brief 队列策略
+ */
+typedef enum
+{
+    SPSC_EVERY_VALUE = 0, // 每个数据都要处理
+    SPSC_LATEST_VALUE     // 只处理最新数据
+} spsc_policy_t;
+
+/**
+ * @brief 队列
+ */
+typedef struct
+{
+    uint8_t* storage;         // 数据存储区
+    uint16_t element_size;    // 单个数据的字节数
+    uint16_t capacity;        // 槽数 (SPSC_LATEST_VALUE 固定为3)
+    spsc_policy_t policy;
+
+    volatile uint32_t head;   // 已写入的数据个数 (生产者)
+    volatile uint32_t tail;   // 已读出的数据个数 (消费者)
+    volatile uint32_t middle; // 三缓冲：已发布的槽号，SPSC_FRESH 表示消费者尚未读取
+    uint8_t back;             // 三缓冲：生产者正在写的槽号
+    uint8_t front;            // 三缓冲：消费者持有的槽号
+
+    uint32_t dropped;         // 被丢弃或被覆盖的数据个数
+} spsc_queue_t;
+
+#define SPSC_FRESH 0x80U // middle 中的新数据标志
+
+/**
+ * @brief 定义一个带存储区的队列
+ * @param name 队列变量名
+ * @param type 数据类型
+ * @param slots 槽数 (SPSC_LATEST_VALUE 时忽略，固定为3)
+ * @param policy 队列策略
+ */
+#define SPSC_QUEUE_DEFINE(name, type, slots, policy)                                              \
+    static type name##_storage[((policy) == SPSC_LATEST_VALUE) ? 3 : (slots)];                     \
+    spsc_queue_t name = {(uint8_t*)name##_storage, sizeof(type),                                  \
+                         ((policy) == SPSC_LATEST_VALUE) ? 3 : (slots), (policy), 0, 0, 1, 0, 2, 0}
+
+/**
+ * @brief 按类型写入/读出，数据大小与队列不一致时失败
+ */
+#define SPSC_PUSH(queue, item) spsc_push(&(queue), &(item), sizeof(item))
+#define SPSC_POP(queue, item) spsc_pop(&(queue), &(item), sizeof(item))
+
+/**
+ * @brief 三缓冲按类型直接访问槽，省去大数据的一次拷贝和调用方的副本
+ */
+#define SPSC_WRITE_SLOT(queue, type) ((type*)spsc_write_slot(&(queue), sizeof(type)))
+#define SPSC_READ_SLOT(queue, type) ((type*)spsc_read_slot(&(queue), sizeof(type)))
+
+/**
+ * @brief 写入一个数据 (生产者)
+ * @return 1=成功，0=大小不符或队列满 (SPSC_EVERY_VALUE)
+ */
+uint8_t spsc_push(spsc_queue_t* queue, const void* item, uint16_t size);
+
+/**
+ * @brief 读出一个数据 (消费者)
+ * @details SPSC_EVERY_VALUE 读出最早的数据；SPSC_LATEST_VALUE 读出最新的数据。
+ * @return 1=读到新数据，0=大小不符或没有新数据 (item 不变)
+ */
+uint8_t spsc_pop(spsc_queue_t* queue, void* item, uint16_t size);
+
+/**
+ * @brief 三缓冲：取得生产者正在写的槽 (生产者)，写完后调用 spsc_commit() 发布
+ * @return 槽地址，大小不符或不是 SPSC_LATEST_VALUE 队列时返回 NULL
+ */
+void* spsc_write_slot(spsc_queue_t* queue, uint16_t size);
+
+/**
+ * @brief 三缓冲：发布 spsc_write_slot() 取得的槽 (生产者)
+ */
+void spsc_commit(spsc_queue_t* queue);
+
+/**
+ * @brief 三缓冲：取得最新数据所在的槽 (消费者)
+ * @details 槽归消费者所有，下一次调用 spsc_read_slot()/spsc_pop() 之前内容不变，可以直接读写。
+ * @return 槽地址，大小不符、不是 SPSC_LATEST_VALUE 队列或没有新数据时返回 NULL
+ */
+void* spsc_read_slot(spsc_queue_t* queue, uint16_t size);
+
+/**
+ * @brief 队列中未读的数据个数
+ */
+uint32_t spsc_count(const spsc_queue_t* queue);
+
+#endif // __SPSC_QUEUE_H__
@@ -29,6 +29,26 @@ void DA_FPGA_STOP()
 {
     CTRL_DATA = CTRL_DATA & (~DA_FREQ_EN); // 清零 DA 使能位，停止DA输出
 }
+
+/**
+ * @brief 开启DA杂散抑制
+ * @details 置位 DA_DITHER_EN 位。FPGA在NCO输出时钟上加入LFSR相位抖动，
+ * 并对幅度缩放后的截断误差做一阶噪声整形，把确定性杂散打散为底噪，
+ * 减少频谱分析中由DA自身杂散产生的虚假谱峰。
+ */
+void DA_DITHER_ENABLE()
+{
+    CTRL_DATA = CTRL_DATA | DA_DITHER_EN; // 置位杂散抑制使能位
+}
+
+/**
+ * @brief 关闭DA杂散抑制
+ * @details 清零 DA_DITHER_EN 位，NCO和幅度截断恢复为确定性方式。
+ */
+void DA_DITHER_DISABLE()
+{
+    CTRL_DATA = CTRL_DATA & (~DA_DITHER_EN); // 清零杂散抑制使能位
+}
 //----- AD测频系列 ------
 /**
  * @brief 启用AD测频清除
@@ -0,0 +1,127 @@
+/**
+ * @file spsc_queue.c
+ * @brief 单生产者/单消费者无锁队列实现
+ * @details
+ * 环形队列：head、tail 为不回绕的计数，槽号取余得到；先写数据再用DMB保证顺序后更新计数。
+ * 三缓冲：三个槽分别由生产者、消费者和 middle 持有，双方各自用 LDREX/STREX 交换自己与 middle 的槽号，
+ * 任何时刻双方都不会访问同一个槽。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#include "spsc_queue.h"
+#include "stm32f4xx.h"
+#include <string.h>
+
+/**
+ * @brief 原子交换
+ * @return 交换前的值
+ */
+static uint32_t spsc_exchange(volatile uint32_t* target, uint32_t value)
+{
+    uint32_t old;
+
+    do
+    {
+        old = __LDREXW(target);
+    } while(__STREXW(value, target) != 0);
+
+    return old;
+}
+
+uint8_t spsc_push(spsc_queue_t* queue, const void* item, uint16_t size)
+{
+    if(size != queue->element_size)
+    {
+        return 0;
+    }
+
+    if(queue->policy == SPSC_LATEST_VALUE)
+    {
+        memcpy(queue->storage + queue->back * size, item, size);
+        spsc_commit(queue);
+        return 1;
+    }
+
+    uint32_t head = queue->head;
+    if(head - queue->tail >= queue->capacity)
+    {
+        queue->dropped++;
+        return 0;
+    }
+    memcpy(queue->storage + (head % queue->capacity) * size, item, size);
+    __DMB();
+    queue->head = head + 1;
+    return 1;
+}
+
+uint8_t spsc_pop(spsc_queue_t* queue, void* item, uint16_t size)
+{
+    if(size != queue->element_size)
+    {
+        return 0;
+    }
+
+    if(queue->policy == SPSC_LATEST_VALUE)
+    {
+        const void* slot = spsc_read_slot(queue, size);
+        if(slot == NULL)
+        {
+            return 0;
+        }
+        memcpy(item, slot, size);
+        return 1;
+    }
+
+    uint32_t tail = queue->tail;
+    if(tail == queue->head)
+    {
+        return 0;
+    }
+    __DMB();
+    memcpy(item, queue->storage + (tail % queue->capacity) * size, size);
+    __DMB();
+    queue->tail = tail + 1;
+    return 1;
+}
+
+void* spsc_write_slot(spsc_queue_t* queue, uint16_t size)
+{
+    if(size != queue->element_size || queue->policy != SPSC_LATEST_VALUE)
+    {
+        return NULL;
+    }
+    return queue->storage + queue->back * size;
+}
+
+void spsc_commit(spsc_queue_t* queue)
+{
+    __DMB();
+    uint32_t old = spsc_exchange(&queue->middle, queue->back | SPSC_FRESH);
+    queue->back = old & ~SPSC_FRESH;
+    if(old & SPSC_FRESH)
+    {
+        queue->dropped++; // 上一个数据未被读取就被覆盖
+    }
+}
+
+void* spsc_read_slot(spsc_queue_t* queue, uint16_t size)
+{
+    if(size != queue->element_size || queue->policy != SPSC_LATEST_VALUE || !(queue->middle & SPSC_FRESH))
+    {
+        return NULL;
+    }
+    uint32_t old = spsc_exchange(&queue->middle, queue->front);
+    queue->front = old & ~SPSC_FRESH;
+    __DMB();
+    return queue->storage + queue->front * size;
+}
+
+uint32_t spsc_count(const spsc_queue_t* queue)
+{
+    if(queue->policy == SPSC_LATEST_VALUE)
+    {
+        return (queue->middle & SPSC_FRESH) ? 1 : 0;
+    }
+    return queue->head - queue->tail;
+}
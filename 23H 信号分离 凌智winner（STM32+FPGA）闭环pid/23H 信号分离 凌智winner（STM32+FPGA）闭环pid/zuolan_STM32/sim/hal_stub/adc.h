@@ -0,0 +1,10 @@
+/* 主机仿真用的 Core/Inc/adc.h 替身 */
+#ifndef __SIM_ADC_H__
+#define __SIM_ADC_H__
+
+#include "main.h"
+
+extern ADC_HandleTypeDef hadc1;
+extern ADC_HandleTypeDef hadc2;
+
+#endif /* __SIM_ADC_H__ */
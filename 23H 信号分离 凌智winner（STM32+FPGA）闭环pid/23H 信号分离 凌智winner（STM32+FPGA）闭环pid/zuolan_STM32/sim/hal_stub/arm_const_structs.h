@@ -0,0 +1,13 @@
+/* 主机仿真用的 arm_const_structs.h 替身 */
+#ifndef __SIM_ARM_CONST_STRUCTS_H__
+#define __SIM_ARM_CONST_STRUCTS_H__
+
+#include "arm_math.h"
+
+extern const arm_cfft_instance_f32 arm_cfft_sR_f32_len256;
+extern const arm_cfft_instance_f32 arm_cfft_sR_f32_len512;
+extern const arm_cfft_instance_f32 arm_cfft_sR_f32_len1024;
+extern const arm_cfft_instance_f32 arm_cfft_sR_f32_len2048;
+extern const arm_cfft_instance_f32 arm_cfft_sR_f32_len4096;
+
+#endif /* __SIM_ARM_CONST_STRUCTS_H__ */
@@ -0,0 +1,58 @@
+/**
+ * @file arm_math.h
+ * @brief 主机仿真用的CMSIS-DSP接口
+ * @details
+ * 工程自带的 arm_math.h 依赖Cortex-M内核头文件，不能在主机上编译，
+ * 这里只声明固件在仿真中用到的类型和函数，用标准C实现 (见 sim_dsp.c)，结果与CMSIS-DSP一致到浮点舍入。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#ifndef __SIM_ARM_MATH_H__
+#define __SIM_ARM_MATH_H__
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+typedef float float32_t;
+typedef int8_t q7_t;
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+typedef int64_t q63_t;
+
+#define PI 3.14159265358979f
+
+typedef enum
+{
+    ARM_MATH_SUCCESS = 0,
+    ARM_MATH_ARGUMENT_ERROR = -1
+} arm_status;
+
+typedef struct
+{
+    uint16_t fftLen;
+} arm_cfft_instance_f32;
+
+typedef struct
+{
+    uint16_t fftLenRFFT;
+} arm_rfft_fast_instance_f32; // 只用于编译 my_fft.h
+
+static inline q31_t clip_q63_to_q31(q63_t x)
+{
+    return ((q31_t)(x >> 32) != ((q31_t)x >> 31)) ? ((0x7FFFFFFF ^ ((q31_t)(x >> 63)))) : (q31_t)x;
+}
+
+float32_t arm_sin_f32(float32_t x);
+float32_t arm_cos_f32(float32_t x);
+void arm_cfft_f32(const arm_cfft_instance_f32* S, float32_t* p1, uint8_t ifftFlag, uint8_t bitReverseFlag);
+void arm_cmplx_mag_f32(const float32_t* pSrc, float32_t* pDst, uint32_t numSamples);
+void arm_dot_prod_f32(const float32_t* pSrcA, const float32_t* pSrcB, uint32_t blockSize, float32_t* result);
+void arm_mean_f32(const float32_t* pSrc, uint32_t blockSize, float32_t* pResult);
+void arm_rms_f32(const float32_t* pSrc, uint32_t blockSize, float32_t* pResult);
+void arm_offset_f32(const float32_t* pSrc, float32_t offset, float32_t* pDst, uint32_t blockSize);
+void arm_scale_f32(const float32_t* pSrc, float32_t scale, float32_t* pDst, uint32_t blockSize);
+void arm_sub_f32(const float32_t* pSrcA, const float32_t* pSrcB, float32_t* pDst, uint32_t blockSize);
+
+#endif // __SIM_ARM_MATH_H__
@@ -0,0 +1,9 @@
+/* 主机仿真用的 Core/Inc/dac.h 替身 */
+#ifndef __SIM_DAC_H__
+#define __SIM_DAC_H__
+
+#include "main.h"
+
+extern DAC_HandleTypeDef hdac;
+
+#endif /* __SIM_DAC_H__ */
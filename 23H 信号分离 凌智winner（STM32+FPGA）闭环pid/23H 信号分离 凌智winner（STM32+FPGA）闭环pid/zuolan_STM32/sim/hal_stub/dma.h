@@ -0,0 +1,7 @@
+/* 主机仿真用的 Core/Inc/dma.h 替身 */
+#ifndef __SIM_DMA_H__
+#define __SIM_DMA_H__
+
+#include "main.h"
+
+#endif /* __SIM_DMA_H__ */
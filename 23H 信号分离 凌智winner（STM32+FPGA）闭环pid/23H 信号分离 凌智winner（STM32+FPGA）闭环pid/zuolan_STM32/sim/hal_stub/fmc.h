@@ -0,0 +1,7 @@
+/* 主机仿真用的 Core/Inc/fmc.h 替身 */
+#ifndef __SIM_FMC_H__
+#define __SIM_FMC_H__
+
+#include "main.h"
+
+#endif /* __SIM_FMC_H__ */
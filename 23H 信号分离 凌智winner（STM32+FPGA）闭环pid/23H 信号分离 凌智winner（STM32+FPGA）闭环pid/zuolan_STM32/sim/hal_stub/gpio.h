@@ -0,0 +1,7 @@
+/* 主机仿真用的 Core/Inc/gpio.h 替身 */
+#ifndef __SIM_GPIO_H__
+#define __SIM_GPIO_H__
+
+#include "main.h"
+
+#endif /* __SIM_GPIO_H__ */
@@ -0,0 +1,9 @@
+/* 主机仿真用的 Core/Inc/main.h 替身 */
+#ifndef __SIM_MAIN_H__
+#define __SIM_MAIN_H__
+
+#include "stm32f4xx_hal.h"
+
+void Error_Handler(void);
+
+#endif /* __SIM_MAIN_H__ */
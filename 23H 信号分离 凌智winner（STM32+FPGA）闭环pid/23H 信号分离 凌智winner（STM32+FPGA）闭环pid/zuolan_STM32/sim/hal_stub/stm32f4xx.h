@@ -0,0 +1,62 @@
+/**
+ * @file stm32f4xx.h
+ * @brief 主机仿真用的器件头文件替身
+ * @details
+ * 只提供固件在仿真中用到的类型、寄存器和内核函数：
+ * - FPGA寄存器区重定向到 sim_fpga_regs 数组，FMC读写变为内存读写；
+ * - RCC 只保留 CFGR，用于计算ADC采样率；
+ * - 仿真是单线程的，LDREX/STREX 退化为普通读写，屏障为空操作。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#ifndef __SIM_STM32F4XX_H__
+#define __SIM_STM32F4XX_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define __IO volatile
+#define __I volatile const
+
+// FPGA寄存器区 (16位字地址 0x00~0xFF)
+#define SIM_FPGA_REGS 0x100
+extern uint16_t sim_fpga_regs[SIM_FPGA_REGS];
+#define FPGA_REG_BASE ((uintptr_t)sim_fpga_regs)
+
+// RCC
+typedef struct
+{
+    volatile uint32_t CFGR;
+} RCC_TypeDef;
+extern RCC_TypeDef sim_rcc;
+#define RCC (&sim_rcc)
+#define RCC_CFGR_PPRE1 0x00001C00U
+
+// GPIO (只用于声明)
+typedef struct
+{
+    volatile uint32_t ODR;
+    volatile uint32_t IDR;
+} GPIO_TypeDef;
+
+// 内核函数
+static inline uint32_t __LDREXW(volatile uint32_t* addr)
+{
+    return *addr;
+}
+
+static inline uint32_t __STREXW(uint32_t value, volatile uint32_t* addr)
+{
+    *addr = value;
+    return 0;
+}
+
+#define __DMB()
+#define __DSB()
+#define __disable_irq()
+#define __enable_irq()
+#define __get_PRIMASK() 0U
+#define __set_PRIMASK(x) ((void)(x))
+
+#endif // __SIM_STM32F4XX_H__
@@ -0,0 +1,104 @@
+/**
+ * @file stm32f4xx_hal.h
+ * @brief 主机仿真用的HAL替身
+ * @details
+ * 句柄只保留固件访问到的字段，外设启停函数为空操作 (实现见 sim_hal.c)。
+ * ADC采样由仿真对象模型直接写入 adc_buffer 并置位 adc_flag，代替DMA完成中断。
+ * HAL_GetTick() 返回仿真时间。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#ifndef __SIM_STM32F4XX_HAL_H__
+#define __SIM_STM32F4XX_HAL_H__
+
+#include "stm32f4xx.h"
+
+typedef enum
+{
+    HAL_OK = 0,
+    HAL_ERROR,
+    HAL_BUSY,
+    HAL_TIMEOUT
+} HAL_StatusTypeDef;
+
+#define HAL_MAX_DELAY 0xFFFFFFFFU
+
+// DMA
+typedef enum
+{
+    HAL_DMA_STATE_RESET = 0,
+    HAL_DMA_STATE_READY,
+    HAL_DMA_STATE_BUSY
+} HAL_DMA_StateTypeDef;
+
+typedef struct
+{
+    HAL_DMA_StateTypeDef State;
+} DMA_HandleTypeDef;
+
+// ADC
+#define HAL_ADC_STATE_READY 0x00000001U
+#define ADC_FLAG_AWD 0x01U
+#define ADC_FLAG_EOC 0x02U
+#define ADC_FLAG_JEOC 0x04U
+#define ADC_FLAG_OVR 0x20U
+
+typedef struct
+{
+    uint32_t State;
+    DMA_HandleTypeDef* DMA_Handle;
+} ADC_HandleTypeDef;
+
+#define __HAL_ADC_CLEAR_FLAG(handle, flag) ((void)(handle), (void)(flag))
+
+// TIM
+typedef struct
+{
+    uint32_t Prescaler;
+    uint32_t Period;
+} TIM_Base_InitTypeDef;
+
+typedef struct
+{
+    TIM_Base_InitTypeDef Init;
+} TIM_HandleTypeDef;
+
+// UART
+typedef struct
+{
+    uint32_t Instance;
+} UART_HandleTypeDef;
+
+// DAC
+typedef struct
+{
+    uint32_t State;
+} DAC_HandleTypeDef;
+
+// GPIO
+typedef enum
+{
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+// RCC
+#define RCC_HCLK_DIV1 0x00000000U
+#define RCC_HCLK_DIV4 0x00001400U
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t delay);
+uint32_t HAL_RCC_GetPCLK1Freq(void);
+
+HAL_StatusTypeDef HAL_ADC_Start(ADC_HandleTypeDef* hadc);
+HAL_StatusTypeDef HAL_ADCEx_MultiModeStart_DMA(ADC_HandleTypeDef* hadc, uint32_t* data, uint32_t length);
+HAL_StatusTypeDef HAL_ADCEx_MultiModeStop_DMA(ADC_HandleTypeDef* hadc);
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef* hdma);
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef* htim);
+HAL_StatusTypeDef HAL_TIM_Base_Stop(TIM_HandleTypeDef* htim);
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef* huart, const uint8_t* data, uint16_t size, uint32_t timeout);
+void HAL_GPIO_WritePin(GPIO_TypeDef* port, uint16_t pin, GPIO_PinState state);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef* port, uint16_t pin);
+
+#endif // __SIM_STM32F4XX_HAL_H__
@@ -0,0 +1,9 @@
+/* 主机仿真用的 Core/Inc/tim.h 替身 */
+#ifndef __SIM_TIM_H__
+#define __SIM_TIM_H__
+
+#include "main.h"
+
+extern TIM_HandleTypeDef htim2;
+
+#endif /* __SIM_TIM_H__ */
@@ -0,0 +1,11 @@
+/* 主机仿真用的 Core/Inc/usart.h 替身 */
+#ifndef __SIM_USART_H__
+#define __SIM_USART_H__
+
+#include "main.h"
+
+extern UART_HandleTypeDef huart1;
+extern UART_HandleTypeDef huart2;
+extern UART_HandleTypeDef huart3;
+
+#endif /* __SIM_USART_H__ */
@@ -0,0 +1,114 @@
+/**
+ * @file sim.h
+ * @brief 主机闭环仿真：仿真时钟、被控对象模型
+ * @details
+ * 固件源文件 (stm_sig.c、app_pid.c、da_output.c 及算法库) 不做修改，直接与 hal_stub/ 中的替身一起在主机上编译：
+ * - FMC：FPGA寄存器区是内存数组，被控对象模型从中读取DA频率字、相位字；
+ * - ADC/DMA：对象模型生成一帧双通道采样写入 adc_buffer，置位 adc_flag 代替DMA完成中断；
+ * - 并行AD：对象模型生成峰峰值直接送入 amp_queue，代替 ad_proc；
+ * - SysTick：HAL_GetTick() 返回仿真时间；
+ * - Flash：param_store 总是读不到记录，固件使用代码中的默认增益。
+ *
+ * 对象模型：
+ * - DDS：按频率字计算输出频率 (保留频率字截断误差)，1024点波表的相位量化，相位累加器连续；
+ * - 模拟通道：DA到ADC有纯延时和一阶低通 (幅度和相移随频率变化)，信号源直接接ADC；
+ * - ADC：12位，中点偏置，高斯噪声后量化，双通道同步采样；
+ * - 信号源：频率线性漂移，每帧相位随机游走；
+ * - 幅度环：AD9959幅度字 -> 一阶惯性 -> 并行AD峰峰值 (12位量化和噪声)。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#ifndef __SIM_H__
+#define __SIM_H__
+
+#include <stdint.h>
+
+#define SIM_TONES 2 // 信号源分量数 (与DA通道数相同)
+
+/**
+ * @brief 仿真参数
+ */
+typedef struct
+{
+    // 信号源 (ADC通道2)
+    float src_freq[SIM_TONES]; // 分量频率 (Hz)，单通道跟踪只用第一个
+    float src_amp;             // 每个分量在ADC输入端的峰值 (V)
+    float src_drift;           // 频率线性漂移 (ppm/s)
+    float src_phase_noise;     // 每帧相位随机游走 (rad RMS)
+
+    // DA -> ADC通道1
+    float da_amp;              // 每路DA在ADC输入端的峰值 (V)
+    float delay;               // 纯延时 (s)
+    float cutoff;              // 一阶低通截止频率 (Hz)
+
+    // STM32 ADC
+    float adc_noise;           // 噪声 (LSB RMS)
+    float latency;             // 采集完成到写入FPGA寄存器的处理时间 (s)
+
+    // 幅度环
+    float amp_gain;            // 并行AD2峰峰值 / AD9959幅度字 (V)
+    float amp_tau;             // 一阶惯性时间常数 (s)
+    float amp_noise;           // 并行AD噪声 (LSB RMS)
+} sim_config_t;
+
+extern double sim_time;     // 仿真时间 (s)
+extern uint8_t sim_verbose; // 1=输出固件的串口打印
+
+/**
+ * @brief 均匀分布随机数 [0, 1)
+ */
+float sim_random(void);
+
+/**
+ * @brief 标准正态分布随机数
+ */
+float sim_gauss(void);
+
+/**
+ * @brief 设置随机数种子
+ */
+void sim_seed(uint32_t seed);
+
+/**
+ * @brief 复位对象模型：随机初相，清除漂移和幅度环状态
+ * @param config 仿真参数 (仿真期间保持有效)
+ * @param amp_word 幅度环初始幅度字 (对象从该值的稳态开始)
+ */
+void sim_plant_reset(const sim_config_t* config, uint32_t amp_word);
+
+/**
+ * @brief 采集一帧双通道ADC数据写入 adc_buffer，仿真时间前进一帧
+ * @param tones 1=DA1与分量1，2=两路DA之和与两个分量之和
+ */
+void sim_plant_capture(uint8_t tones);
+
+/**
+ * @brief 按当前频率字让DDS和信号源空转一段时间 (处理耗时)
+ */
+void sim_plant_advance(double dt);
+
+/**
+ * @brief DA通道的实际输出频率 (由FPGA频率字换算)
+ */
+double sim_plant_da_frequency(uint8_t channel);
+
+/**
+ * @brief ADC输入端DA分量与信号源对应分量的真实相位差 phase_DA - phase_Source (rad，[-pi, pi])
+ */
+float sim_plant_phase_error(uint8_t channel);
+
+/**
+ * @brief 幅度环对象前进一步
+ * @param amp_word AD9959幅度字 (固件输出 pid_vin)
+ * @param dt 步长 (s)
+ * @return 并行AD2输入端的真实峰峰值 (V)
+ */
+float sim_plant_amp_step(uint32_t amp_word, double dt);
+
+/**
+ * @brief 按 vpp_adc_parallel() 的方法测量并行AD2峰峰值：一帧带噪声的12位采样取最大减最小
+ */
+float sim_plant_amp_measure(void);
+
+#endif // __SIM_H__
@@ -0,0 +1,147 @@
+/**
+ * @file sim_dsp.c
+ * @brief 主机仿真用的CMSIS-DSP函数 (标准C实现)
+ * @details
+ * 约定与CMSIS-DSP相同：arm_cfft_f32 为交错存放的复数原位变换，正变换不归一化，逆变换除以N，
+ * 输出总是自然顺序 (固件只使用 bitReverseFlag = 1)。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#include "arm_math.h"
+#include "arm_const_structs.h"
+
+const arm_cfft_instance_f32 arm_cfft_sR_f32_len256 = {256};
+const arm_cfft_instance_f32 arm_cfft_sR_f32_len512 = {512};
+const arm_cfft_instance_f32 arm_cfft_sR_f32_len1024 = {1024};
+const arm_cfft_instance_f32 arm_cfft_sR_f32_len2048 = {2048};
+const arm_cfft_instance_f32 arm_cfft_sR_f32_len4096 = {4096};
+
+float32_t arm_sin_f32(float32_t x)
+{
+    return sinf(x);
+}
+
+float32_t arm_cos_f32(float32_t x)
+{
+    return cosf(x);
+}
+
+/**
+ * @brief 基2按时间抽取FFT
+ */
+void arm_cfft_f32(const arm_cfft_instance_f32* S, float32_t* p1, uint8_t ifftFlag, uint8_t bitReverseFlag)
+{
+    uint32_t n = S->fftLen;
+    uint32_t i, j, k, len;
+    double sign = ifftFlag ? 1.0 : -1.0;
+
+    // 位反转重排放在蝶形运算之前，输出为自然顺序
+    for(i = 1, j = 0; i < n; i++)
+    {
+        uint32_t bit = n >> 1;
+        for(; j & bit; bit >>= 1)
+        {
+            j ^= bit;
+        }
+        j ^= bit;
+        if(i < j)
+        {
+            float32_t re = p1[2 * i], im = p1[2 * i + 1];
+            p1[2 * i] = p1[2 * j];
+            p1[2 * i + 1] = p1[2 * j + 1];
+            p1[2 * j] = re;
+            p1[2 * j + 1] = im;
+        }
+    }
+    (void)bitReverseFlag;
+
+    for(len = 2; len <= n; len <<= 1)
+    {
+        double angle = sign * 2.0 * 3.14159265358979323846 / len;
+        for(k = 0; k < len / 2; k++)
+        {
+            double wr = cos(angle * k), wi = sin(angle * k);
+            for(i = k; i < n; i += len)
+            {
+                uint32_t m = i + len / 2;
+                double tr = wr * p1[2 * m] - wi * p1[2 * m + 1];
+                double ti = wr * p1[2 * m + 1] + wi * p1[2 * m];
+                p1[2 * m] = (float32_t)(p1[2 * i] - tr);
+                p1[2 * m + 1] = (float32_t)(p1[2 * i + 1] - ti);
+                p1[2 * i] = (float32_t)(p1[2 * i] + tr);
+                p1[2 * i + 1] = (float32_t)(p1[2 * i + 1] + ti);
+            }
+        }
+    }
+
+    if(ifftFlag)
+    {
+        for(i = 0; i < 2 * n; i++)
+        {
+            p1[i] /= (float32_t)n;
+        }
+    }
+}
+
+void arm_cmplx_mag_f32(const float32_t* pSrc, float32_t* pDst, uint32_t numSamples)
+{
+    for(uint32_t i = 0; i < numSamples; i++)
+    {
+        pDst[i] = sqrtf(pSrc[2 * i] * pSrc[2 * i] + pSrc[2 * i + 1] * pSrc[2 * i + 1]);
+    }
+}
+
+void arm_dot_prod_f32(const float32_t* pSrcA, const float32_t* pSrcB, uint32_t blockSize, float32_t* result)
+{
+    float32_t sum = 0.0f;
+    for(uint32_t i = 0; i < blockSize; i++)
+    {
+        sum += pSrcA[i] * pSrcB[i];
+    }
+    *result = sum;
+}
+
+void arm_mean_f32(const float32_t* pSrc, uint32_t blockSize, float32_t* pResult)
+{
+    float32_t sum = 0.0f;
+    for(uint32_t i = 0; i < blockSize; i++)
+    {
+        sum += pSrc[i];
+    }
+    *pResult = sum / (float32_t)blockSize;
+}
+
+void arm_rms_f32(const float32_t* pSrc, uint32_t blockSize, float32_t* pResult)
+{
+    float32_t sum = 0.0f;
+    for(uint32_t i = 0; i < blockSize; i++)
+    {
+        sum += pSrc[i] * pSrc[i];
+    }
+    *pResult = sqrtf(sum / (float32_t)blockSize);
+}
+
+void arm_offset_f32(const float32_t* pSrc, float32_t offset, float32_t* pDst, uint32_t blockSize)
+{
+    for(uint32_t i = 0; i < blockSize; i++)
+    {
+        pDst[i] = pSrc[i] + offset;
+    }
+}
+
+void arm_scale_f32(const float32_t* pSrc, float32_t scale, float32_t* pDst, uint32_t blockSize)
+{
+    for(uint32_t i = 0; i < blockSize; i++)
+    {
+        pDst[i] = pSrc[i] * scale;
+    }
+}
+
+void arm_sub_f32(const float32_t* pSrcA, const float32_t* pSrcB, float32_t* pDst, uint32_t blockSize)
+{
+    for(uint32_t i = 0; i < blockSize; i++)
+    {
+        pDst[i] = pSrcA[i] - pSrcB[i];
+    }
+}
@@ -0,0 +1,153 @@
+/**
+ * @file sim_hal.c
+ * @brief 主机仿真用的HAL、串口和参数存储替身
+ * @details
+ * 外设句柄的初值与 Core/Src 中的配置一致：TIM2 不分频、周期60，APB1 四分频 (PCLK1 = 45MHz，定时器时钟90MHz)，
+ * 因此 stm32_adc_sampling_freq() 在仿真中同样得到1.5MHz。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#include "sim.h"
+#include "stm32f4xx_hal.h"
+#include "my_usart.h"
+#include "param_store.h"
+#include <stdarg.h>
+#include <stdio.h>
+
+#define SIM_PCLK1 45000000U // APB1时钟 (Hz)
+
+double sim_time = 0.0;
+uint8_t sim_verbose = 0;
+
+uint16_t sim_fpga_regs[SIM_FPGA_REGS];
+RCC_TypeDef sim_rcc = {RCC_HCLK_DIV4};
+
+static DMA_HandleTypeDef hdma_adc1 = {HAL_DMA_STATE_READY};
+ADC_HandleTypeDef hadc1 = {HAL_ADC_STATE_READY, &hdma_adc1};
+ADC_HandleTypeDef hadc2 = {HAL_ADC_STATE_READY, NULL};
+TIM_HandleTypeDef htim2 = {{0, 60 - 1}};
+DAC_HandleTypeDef hdac;
+UART_HandleTypeDef huart1, huart2, huart3;
+
+uint32_t pid_vin = 38; // AD9959幅度字，原定义在 AD9959.c (仿真不编译AD9959驱动)
+
+uint32_t HAL_GetTick(void)
+{
+    return (uint32_t)(sim_time * 1000.0);
+}
+
+void HAL_Delay(uint32_t delay)
+{
+    sim_time += delay * 0.001;
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void)
+{
+    return SIM_PCLK1;
+}
+
+HAL_StatusTypeDef HAL_ADC_Start(ADC_HandleTypeDef* hadc)
+{
+    (void)hadc;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADCEx_MultiModeStart_DMA(ADC_HandleTypeDef* hadc, uint32_t* data, uint32_t length)
+{
+    (void)hadc;
+    (void)data;
+    (void)length;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADCEx_MultiModeStop_DMA(ADC_HandleTypeDef* hadc)
+{
+    (void)hadc;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef* hdma)
+{
+    (void)hdma;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef* htim)
+{
+    (void)htim;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Stop(TIM_HandleTypeDef* htim)
+{
+    (void)htim;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef* huart, const uint8_t* data, uint16_t size, uint32_t timeout)
+{
+    (void)huart;
+    (void)timeout;
+    if(sim_verbose)
+    {
+        fwrite(data, 1, size, stdout);
+    }
+    return HAL_OK;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef* port, uint16_t pin, GPIO_PinState state)
+{
+    (void)port;
+    (void)pin;
+    (void)state;
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef* port, uint16_t pin)
+{
+    (void)port;
+    (void)pin;
+    return GPIO_PIN_SET;
+}
+
+void Error_Handler(void)
+{
+}
+
+/**
+ * @brief 串口打印：-v 时带仿真时间输出到标准输出
+ */
+int my_printf(UART_HandleTypeDef* huart, const char* format, ...)
+{
+    va_list args;
+    int len;
+
+    (void)huart;
+    if(!sim_verbose)
+    {
+        return 0;
+    }
+
+    printf("[%9.3fs] ", sim_time);
+    va_start(args, format);
+    len = vprintf(format, args);
+    va_end(args);
+    return len;
+}
+
+/**
+ * @brief 仿真没有Flash，总是使用固件默认增益
+ */
+uint8_t param_store_load(param_loop_t loop, param_gains_t* gains)
+{
+    (void)loop;
+    (void)gains;
+    return 0;
+}
+
+uint8_t param_store_save(param_loop_t loop, const param_gains_t* gains)
+{
+    (void)loop;
+    (void)gains;
+    return 1;
+}
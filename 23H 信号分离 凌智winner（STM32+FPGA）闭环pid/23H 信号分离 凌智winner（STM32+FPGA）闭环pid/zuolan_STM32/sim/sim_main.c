@@ -0,0 +1,433 @@
+/**
+ * @file sim_main.c
+ * @brief 主机闭环仿真命令行：批量运行锁定试验并统计锁定时间、稳态误差和抖动的分布
+ * @details
+ * 三种模式：
+ * - track：单通道相位跟踪 (stm32_adc_proc()，track_pid 按频率增益调度)，DA1 跟踪信号源分量1；
+ * - dpll：双通道锁相环 (stm32_dpll_start())，DA1/DA2 分别锁定信号源的两个分量；
+ * - amp：幅度环 (Pid_Proc())，AD9959幅度字闭环到目标电压。
+ * 每次试验随机初相、初始频率偏差 (±offset) 和幅度环对象增益 (±spread)，仿真时间不在试验间复位。
+ *
+ * 锁定判据：误差最后一次超出门限之后，连续 hold 帧都在门限内，锁定时间为该段的起点；
+ * 稳态误差和抖动取锁定之后 (至少是后一半时长) 的误差均值和标准差。
+ *
+ * 编译 (在 zuolan_STM32 目录下)：
+ *   gcc -O2 -std=gnu99 -Isim/hal_stub -IMY_APP -IMY_Utilities/Inc -IMY_Hardware_Drivers/Inc \
+ *       -IMY_Algorithms/Inc -IMY_Communication/Inc -o zuolan_sim \
+ *       sim/sim_main.c sim/sim_plant.c sim/sim_hal.c sim/sim_dsp.c \
+ *       MY_APP/stm_sig.c MY_APP/app_pid.c MY_APP/pipeline.c MY_Utilities/Src/spsc_queue.c \
+ *       MY_Utilities/Src/cmd_to_fun.c MY_Hardware_Drivers/Src/da_output.c MY_Algorithms/Src/sine_fit.c \
+ *       MY_Algorithms/Src/pid_controller.c MY_Algorithms/Src/pid_autotune.c MY_Algorithms/Src/dpll.c \
+ *       MY_Algorithms/Src/gain_schedule.c -lm
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#include "sim.h"
+#include "bsp_system.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SIM_DEFAULT_TRIALS 200
+#define SIM_MAX_FRAME_STEP 0.0005 // 帧周期下限 (s)，用于估计误差缓冲区大小
+
+extern uint8_t adc_flag;
+extern pid_ctrl_t track_pid;
+
+typedef enum
+{
+    SIM_MODE_TRACK = 0,
+    SIM_MODE_DPLL,
+    SIM_MODE_AMP
+} sim_mode_t;
+
+/**
+ * @brief 命令行参数
+ */
+typedef struct
+{
+    sim_mode_t mode;
+    uint32_t trials;
+    float duration;  // 每次试验时长 (s)
+    float offset;    // 初始频率偏差范围 ± (Hz)
+    float spread;    // 幅度环对象增益偏差范围 ± (比例)
+    float threshold; // 锁定门限 (相位：度，幅度：%)
+    uint32_t hold;   // 锁定需要连续在门限内的帧数
+    uint32_t seed;
+    const char* csv; // 逐次结果输出文件
+} sim_options_t;
+
+/**
+ * @brief 一次试验一个通道的结果
+ */
+typedef struct
+{
+    uint8_t locked;
+    float lock_time; // 锁定时间 (ms)
+    float error;     // 稳态误差均值
+    float jitter;    // 稳态误差标准差
+} sim_result_t;
+
+static float* err_series;  // 每帧误差
+static double* time_series; // 每帧时刻
+static uint32_t series_size;
+
+/**
+ * @brief 由误差序列判定锁定并计算稳态统计
+ */
+static void sim_evaluate(const float* err, uint32_t count, double start, const sim_options_t* opt, sim_result_t* result)
+{
+    int32_t last = (int32_t)count - 1;
+    uint32_t from, i;
+    double sum = 0.0, sum2 = 0.0;
+
+    while(last >= 0 && fabsf(err[last]) <= opt->threshold)
+    {
+        last--;
+    }
+    result->locked = (count - 1 - last >= opt->hold);
+    result->lock_time = result->locked ? (float)((time_series[last + 1] - start) * 1000.0) : 0.0f;
+
+    from = (uint32_t)(last + 1);
+    if(!result->locked || from < count / 2)
+    {
+        from = count / 2;
+    }
+    for(i = from; i < count; i++)
+    {
+        sum += err[i];
+        sum2 += (double)err[i] * err[i];
+    }
+    sum /= (count - from);
+    result->error = (float)sum;
+    result->jitter = (float)sqrt(fmax(sum2 / (count - from) - sum * sum, 0.0));
+}
+
+/**
+ * @brief 一次相位跟踪或锁相环试验
+ * @return 通道数
+ */
+static uint8_t sim_phase_trial(const sim_config_t* config, const sim_options_t* opt, sim_result_t* result)
+{
+    uint8_t tones = (opt->mode == SIM_MODE_DPLL) ? 2 : 1;
+    uint32_t count = 0;
+    double start;
+    uint8_t k;
+
+    for(k = 0; k < tones; k++)
+    {
+        float freq = config->src_freq[k] + opt->offset * (2.0f * sim_random() - 1.0f);
+        DA_SetConfig(k, freq, da_channels[k].amplitude, da_channels[k].phase, WAVE_SINE);
+    }
+    DA_Apply_Settings();
+    sim_plant_reset(config, PID_OUT_MIN);
+
+    if(opt->mode == SIM_MODE_DPLL)
+    {
+        stm32_dpll_start(); // 以当前DA频率为中心重新初始化两个环
+    }
+    else
+    {
+        pid_reset(&track_pid, 0.0f);
+        track_pid_init();
+    }
+
+    start = sim_time;
+    while(sim_time - start < opt->duration && count < series_size)
+    {
+        sim_plant_capture(tones);
+        adc_flag = 1; // DMA完成
+        stm32_adc_proc();
+        stm32_report_proc();
+        sim_plant_advance(config->latency);
+
+        time_series[count] = sim_time;
+        for(k = 0; k < tones; k++)
+        {
+            err_series[k * series_size + count] = sim_plant_phase_error(k) * 180.0f / PI;
+        }
+        count++;
+    }
+
+    for(k = 0; k < tones; k++)
+    {
+        sim_evaluate(&err_series[k * series_size], count, start, opt, &result[k]);
+    }
+    return tones;
+}
+
+/**
+ * @brief 一次幅度环试验
+ * @return 通道数 (1)
+ */
+static uint8_t sim_amp_trial(const sim_config_t* config, const sim_options_t* opt, sim_result_t* result)
+{
+    sim_config_t plant = *config;
+    double step = ((PID_FORM == PID_FORM_INCREMENTAL) ? INCR_SAMPLE_MS : LOCT_SAMPLE_MS) * 0.001;
+    uint32_t count = 0;
+    double start;
+
+    plant.amp_gain *= 1.0f + opt->spread * (2.0f * sim_random() - 1.0f);
+    PID_Init();
+    pid_vin = PID_OUT_MIN;
+    sim_plant_reset(&plant, pid_vin);
+
+    start = sim_time;
+    while(sim_time - start < opt->duration && count < series_size)
+    {
+        float vpp = sim_plant_amp_step(pid_vin, step);
+        amp_sample_t sample = {0.0f, sim_plant_amp_measure(), HAL_GetTick()};
+        SPSC_PUSH(amp_queue, sample); // 代替 ad_proc
+        Pid_Proc();
+        PID_Report_Proc();
+
+        time_series[count] = sim_time;
+        err_series[count] = (vpp / 2 * 10 - PID_SETPOINT) / PID_SETPOINT * 100.0f; // 与 Pid_Proc() 中 vin 的换算一致
+        count++;
+    }
+
+    sim_evaluate(err_series, count, start, opt, result);
+    return 1;
+}
+
+static int sim_compare(const void* a, const void* b)
+{
+    float x = *(const float*)a, y = *(const float*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief 按显示宽度补齐输出 (汉字占两列，printf 的 %-16s 按字节计数会错位)
+ * @param text  UTF-8字符串
+ * @param width 显示宽度
+ * @param left  1：左对齐；0：右对齐
+ */
+static void sim_print_padded(const char* text, int width, uint8_t left)
+{
+    const unsigned char* p;
+    int columns = 0;
+
+    for(p = (const unsigned char*)text; *p; p++)
+    {
+        if((*p & 0xC0) != 0x80) // 只数每个字符的首字节
+        {
+            columns += (*p >= 0xE0) ? 2 : 1;
+        }
+    }
+    if(left) fputs(text, stdout);
+    for(; columns < width; columns++)
+    {
+        putchar(' ');
+    }
+    if(!left) fputs(text, stdout);
+}
+
+/**
+ * @brief 输出一行分布统计：均值、P50、P90、P99、最大
+ */
+static void sim_print_distribution(const char* name, float* values, uint32_t count)
+{
+    double sum = 0.0;
+    uint32_t i;
+
+    if(count == 0)
+    {
+        sim_print_padded(name, 16, 1);
+        printf(" %10s\n", "-");
+        return;
+    }
+    qsort(values, count, sizeof(float), sim_compare);
+    for(i = 0; i < count; i++)
+    {
+        sum += values[i];
+    }
+    sim_print_padded(name, 16, 1);
+    printf(" %10.3f %10.3f %10.3f %10.3f %10.3f\n", sum / count, values[count / 2],
+           values[(count * 90) / 100], values[(count * 99) / 100], values[count - 1]);
+}
+
+static void sim_usage(const char* name)
+{
+    printf("用法: %s [track|dpll|amp] [选项]\n"
+           "  -n 次数       试验次数 (默认 %d)\n"
+           "  -t 秒         每次试验时长 (默认 track 3, dpll 2, amp 2)\n"
+           "  -f Hz         信号源分量1频率 (默认 20000)\n"
+           "  -F Hz         信号源分量2频率 (dpll，默认 50000)\n"
+           "  -o Hz         DA初始频率偏差范围 ± (默认 10)\n"
+           "  -a 比例       幅度环对象增益偏差范围 ± (默认 0.2)\n"
+           "  -d us         DA到ADC的延时 (默认 1)\n"
+           "  -c Hz         DA到ADC的一阶低通截止频率 (默认 500000)\n"
+           "  -N LSB        STM32 ADC噪声 RMS (默认 1)\n"
+           "  -M LSB        并行AD噪声 RMS (默认 0.5)\n"
+           "  -g V/字       幅度环对象增益，AD9959幅度字到输出峰峰值 (默认 0.0012)\n"
+           "  -l ms         采集完成到写入DA的处理时间 (默认 1)\n"
+           "  -p 度         信号源每帧相位随机游走 RMS (默认 0.05)\n"
+           "  -r ppm/s      信号源频率漂移 (默认 0)\n"
+           "  -T ms         幅度环对象时间常数 (默认 5)\n"
+           "  -e 门限       锁定门限，相位为度，幅度为%% (默认 track/dpll 5, amp 2)\n"
+           "  -H 帧         锁定需连续在门限内的帧数 (默认 20)\n"
+           "  -s 种子       随机数种子 (默认 1)\n"
+           "  -C 文件       逐次结果写入CSV\n"
+           "  -v            输出固件串口打印\n",
+           name, SIM_DEFAULT_TRIALS);
+}
+
+int main(int argc, char** argv)
+{
+    static const char* mode_names[] = {"相位跟踪", "双通道锁相环", "幅度环"};
+    static const char* units[][3] = {{"锁定时间(ms)", "稳态误差(度)", "抖动(度)"},
+                                     {"锁定时间(ms)", "稳态误差(度)", "抖动(度)"},
+                                     {"稳定时间(ms)", "稳态误差(%)", "抖动(%)"}};
+    sim_config_t config = {
+        .src_freq = {20000.0f, 50000.0f},
+        .src_amp = 0.5f,
+        .src_drift = 0.0f,
+        .src_phase_noise = 0.05f * PI / 180.0f,
+        .da_amp = 0.5f,
+        .delay = 1e-6f,
+        .cutoff = 500000.0f,
+        .adc_noise = 1.0f,
+        .latency = 0.001f,
+        .amp_gain = 1.2e-3f,
+        .amp_tau = 0.005f,
+        .amp_noise = 0.5f,
+    };
+    sim_options_t opt = {SIM_MODE_TRACK, SIM_DEFAULT_TRIALS, 0.0f, 10.0f, 0.2f, 0.0f, 20, 1, NULL};
+    sim_result_t result[SIM_TONES];
+    float *lock_times, *errors, *jitters;
+    uint32_t samples = 0, locked = 0, trial;
+    FILE* csv = NULL;
+    clock_t wall;
+    double sim_start;
+    int c;
+
+    while((c = getopt(argc, argv, "n:t:f:F:o:a:d:c:N:M:g:l:p:r:T:e:H:s:C:vh")) != -1)
+    {
+        switch(c)
+        {
+        case 'n': opt.trials = (uint32_t)atoi(optarg); break;
+        case 't': opt.duration = (float)atof(optarg); break;
+        case 'f': config.src_freq[0] = (float)atof(optarg); break;
+        case 'F': config.src_freq[1] = (float)atof(optarg); break;
+        case 'o': opt.offset = (float)atof(optarg); break;
+        case 'a': opt.spread = (float)atof(optarg); break;
+        case 'd': config.delay = (float)atof(optarg) * 1e-6f; break;
+        case 'c': config.cutoff = (float)atof(optarg); break;
+        case 'N': config.adc_noise = (float)atof(optarg); break;
+        case 'M': config.amp_noise = (float)atof(optarg); break;
+        case 'g': config.amp_gain = (float)atof(optarg); break;
+        case 'l': config.latency = (float)atof(optarg) * 0.001f; break;
+        case 'p': config.src_phase_noise = (float)atof(optarg) * PI / 180.0f; break;
+        case 'r': config.src_drift = (float)atof(optarg); break;
+        case 'T': config.amp_tau = (float)atof(optarg) * 0.001f; break;
+        case 'e': opt.threshold = (float)atof(optarg); break;
+        case 'H': opt.hold = (uint32_t)atoi(optarg); break;
+        case 's': opt.seed = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'C': opt.csv = optarg; break;
+        case 'v': sim_verbose = 1; break;
+        default: sim_usage(argv[0]); return (c == 'h') ? 0 : 1;
+        }
+    }
+    if(optind < argc)
+    {
+        if(strcmp(argv[optind], "track") == 0) opt.mode = SIM_MODE_TRACK;
+        else if(strcmp(argv[optind], "dpll") == 0) opt.mode = SIM_MODE_DPLL;
+        else if(strcmp(argv[optind], "amp") == 0) opt.mode = SIM_MODE_AMP;
+        else
+        {
+            sim_usage(argv[0]);
+            return 1;
+        }
+    }
+    if(opt.duration <= 0.0f) opt.duration = (opt.mode == SIM_MODE_TRACK) ? 3.0f : 2.0f;
+    if(opt.threshold <= 0.0f) opt.threshold = (opt.mode == SIM_MODE_AMP) ? 2.0f : 5.0f;
+    if(opt.trials == 0 || opt.hold == 0)
+    {
+        sim_usage(argv[0]);
+        return 1;
+    }
+
+    series_size = (uint32_t)(opt.duration / SIM_MAX_FRAME_STEP) + 16;
+    err_series = malloc(sizeof(float) * series_size * SIM_TONES);
+    time_series = malloc(sizeof(double) * series_size);
+    lock_times = malloc(sizeof(float) * opt.trials * SIM_TONES);
+    errors = malloc(sizeof(float) * opt.trials * SIM_TONES);
+    jitters = malloc(sizeof(float) * opt.trials * SIM_TONES);
+    if(!err_series || !time_series || !lock_times || !errors || !jitters)
+    {
+        fprintf(stderr, "内存不足\n");
+        return 1;
+    }
+    if(opt.csv)
+    {
+        csv = fopen(opt.csv, "w");
+        if(!csv)
+        {
+            perror(opt.csv);
+            return 1;
+        }
+        fprintf(csv, "trial,channel,locked,lock_time_ms,error,jitter\n");
+    }
+
+    // 与 main() 中的初始化顺序一致
+    sim_seed(opt.seed);
+    DA_Init();
+    PID_Init();
+    track_pid_init();
+
+    wall = clock();
+    sim_start = sim_time;
+    for(trial = 0; trial < opt.trials; trial++)
+    {
+        uint8_t channels = (opt.mode == SIM_MODE_AMP) ? sim_amp_trial(&config, &opt, result)
+                                                      : sim_phase_trial(&config, &opt, result);
+        for(uint8_t k = 0; k < channels; k++)
+        {
+            if(csv)
+            {
+                fprintf(csv, "%u,%u,%u,%.3f,%.4f,%.4f\n", trial, k + 1, result[k].locked, result[k].lock_time,
+                        result[k].error, result[k].jitter);
+            }
+            samples++;
+            if(result[k].locked)
+            {
+                lock_times[locked] = result[k].lock_time;
+                errors[locked] = fabsf(result[k].error);
+                jitters[locked] = result[k].jitter;
+                locked++;
+            }
+        }
+    }
+    double elapsed = (double)(clock() - wall) / CLOCKS_PER_SEC;
+
+    printf("模式: %s  试验: %u  时长: %.2fs/次  锁定门限: %.2f  种子: %u\n", mode_names[opt.mode], opt.trials,
+           opt.duration, opt.threshold, opt.seed);
+    printf("锁定: %u/%u (%.1f%%)\n", locked, samples, 100.0 * locked / samples);
+    sim_print_padded("", 16, 1);
+    for(uint8_t k = 0; k < 5; k++)
+    {
+        static const char* columns[] = {"均值", "P50", "P90", "P99", "最大"};
+        putchar(' ');
+        sim_print_padded(columns[k], 10, 0);
+    }
+    putchar('\n');
+    sim_print_distribution(units[opt.mode][0], lock_times, locked);
+    sim_print_distribution(units[opt.mode][1], errors, locked);
+    sim_print_distribution(units[opt.mode][2], jitters, locked);
+    printf("用时 %.2fs，%.1f 次/s，仿真/实际时间 %.1f\n", elapsed, opt.trials / fmax(elapsed, 1e-9),
+           (sim_time - sim_start) / fmax(elapsed, 1e-9));
+
+    if(csv)
+    {
+        fclose(csv);
+    }
+    free(err_series);
+    free(time_series);
+    free(lock_times);
+    free(errors);
+    free(jitters);
+    return (locked == samples) ? 0 : 2;
+}
@@ -0,0 +1,236 @@
+/**
+ * @file sim_plant.c
+ * @brief 主机仿真的被控对象模型
+ * @details
+ * 相位以周期为单位用double累加，每次前进后只保留小数部分，长时间仿真不损失精度。
+ * 模拟低通在单频下按当前频率的幅度和相移处理 (准静态)，DDS波表台阶远小于ADC采样间隔，不再另行滤波。
+ *
+ * @author 左岚
+ * @date 2025-07-18
+ */
+#include "sim.h"
+#include "da_output.h"
+#include <math.h>
+
+#define SIM_ADC_LEN 1024           // 与 stm_sig.c 中 adc_buffer 的长度一致
+#define SIM_ADC_MID 2048.0f        // STM32 ADC 中点码值 (12位)
+#define SIM_ADC_MAX 4095
+#define SIM_ADC_LSB (3.3f / 4096.0f)
+#define SIM_TABLE_SIZE 1024        // FPGA波表点数，相位字 0~1023
+#define SIM_PAR_MID 2048.0f        // 并行AD中点码值 (12位)
+#define SIM_PAR_SCALE 204.8f       // 并行AD码值/V，与 ad_measure.c 的 ADC_SCALE / VOLTAGE_OFFSET 一致
+#define SIM_TWO_PI 6.283185307179586
+
+extern uint32_t adc_buffer[SIM_ADC_LEN];
+extern float stm32_adc_sampling_freq(void);
+
+static const sim_config_t* config;
+static double da_phase[NUM_DA_CHANNELS]; // DDS相位 (周期)
+static double src_phase[SIM_TONES];      // 信号源相位 (周期)
+static double src_start;                 // 频率漂移起点 (s)
+static double amp_state;                 // 幅度环对象输出峰峰值 (V)
+static float table_sin[SIM_TABLE_SIZE];  // FPGA波表
+static float table_cos[SIM_TABLE_SIZE];
+static uint32_t rng_state = 1;
+
+/**
+ * @brief xorshift32
+ */
+static uint32_t sim_next(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+float sim_random(void)
+{
+    return (sim_next() >> 8) * (1.0f / 16777216.0f);
+}
+
+float sim_gauss(void)
+{
+    // 4个16位均匀分布之和 (Irwin-Hall) 近似正态分布，尾部截断在±3.46σ，每帧上千个噪声样本时比Box-Muller快得多
+    uint32_t a = sim_next();
+    uint32_t b = sim_next();
+    int32_t sum = (int32_t)((a & 0xFFFF) + (a >> 16) + (b & 0xFFFF) + (b >> 16)) - 2 * 65535;
+    return sum * (1.7320508f / 65536.0f);
+}
+
+void sim_seed(uint32_t seed)
+{
+    rng_state = seed ? seed : 1;
+}
+
+/**
+ * @brief 信号源分量在某时刻的频率 (含线性漂移)
+ */
+static double sim_source_frequency(uint8_t tone, double t)
+{
+    return config->src_freq[tone] * (1.0 + config->src_drift * 1e-6 * (t - src_start));
+}
+
+/**
+ * @brief FPGA相位字 (波表点)
+ */
+static uint16_t sim_da_phase_word(uint8_t channel)
+{
+    return (channel == 0 ? DA1_PHASE : DA2_PHASE) % SIM_TABLE_SIZE;
+}
+
+/**
+ * @brief DA到ADC通道的增益和相移 (rad，滞后为正)
+ */
+static void sim_da_response(double freq, double* gain, double* lag)
+{
+    double x = freq / config->cutoff;
+    *gain = 1.0 / sqrt(1.0 + x * x);
+    *lag = atan(x);
+}
+
+/**
+ * @brief 模拟电压转换为STM32 ADC码值
+ */
+static uint32_t sim_adc_code(float volt)
+{
+    float code = floorf(SIM_ADC_MID + volt / SIM_ADC_LSB + config->adc_noise * sim_gauss() + 0.5f);
+    if(code < 0.0f) return 0;
+    if(code > SIM_ADC_MAX) return SIM_ADC_MAX;
+    return (uint32_t)code;
+}
+
+void sim_plant_reset(const sim_config_t* cfg, uint32_t amp_word)
+{
+    uint16_t i;
+    uint8_t k;
+
+    config = cfg;
+    for(i = 0; i < SIM_TABLE_SIZE; i++)
+    {
+        table_sin[i] = (float)sin(SIM_TWO_PI * i / SIM_TABLE_SIZE);
+        table_cos[i] = (float)cos(SIM_TWO_PI * i / SIM_TABLE_SIZE);
+    }
+    for(k = 0; k < NUM_DA_CHANNELS; k++)
+    {
+        da_phase[k] = sim_random();
+    }
+    for(k = 0; k < SIM_TONES; k++)
+    {
+        src_phase[k] = sim_random();
+    }
+    src_start = sim_time;
+    amp_state = cfg->amp_gain * amp_word;
+}
+
+double sim_plant_da_frequency(uint8_t channel)
+{
+    uint32_t word = (channel == 0) ? ((uint32_t)DA1_H << 16 | DA1_L) : ((uint32_t)DA2_H << 16 | DA2_L);
+    return word * (double)FPGA_BASE_CLK / DA_FREQ_CONSTANT / DA_FIFO_SIZE;
+}
+
+void sim_plant_capture(uint8_t tones)
+{
+    double dt = 1.0 / stm32_adc_sampling_freq();
+    double da_freq[SIM_TONES], da_start[SIM_TONES];
+    float da_sin[SIM_TONES], da_cos[SIM_TONES];
+    double src_re[SIM_TONES], src_im[SIM_TONES], src_step_re[SIM_TONES], src_step_im[SIM_TONES];
+    uint16_t i;
+    uint8_t k;
+
+    for(k = 0; k < tones; k++)
+    {
+        double gain, lag, freq;
+
+        da_freq[k] = sim_plant_da_frequency(k);
+        sim_da_response(da_freq[k], &gain, &lag);
+        da_start[k] = da_phase[k] + sim_da_phase_word(k) / (double)SIM_TABLE_SIZE - da_freq[k] * config->delay;
+        da_sin[k] = (float)(config->da_amp * gain * cos(lag)); // sin(x - lag) = sin(x)cos(lag) - cos(x)sin(lag)
+        da_cos[k] = (float)(config->da_amp * gain * sin(lag));
+
+        // 信号源用旋转相量递推，帧内频率不变
+        src_phase[k] += config->src_phase_noise * sim_gauss() / SIM_TWO_PI;
+        freq = sim_source_frequency(k, sim_time);
+        src_re[k] = config->src_amp * cos(SIM_TWO_PI * src_phase[k]);
+        src_im[k] = config->src_amp * sin(SIM_TWO_PI * src_phase[k]);
+        src_step_re[k] = cos(SIM_TWO_PI * freq * dt);
+        src_step_im[k] = sin(SIM_TWO_PI * freq * dt);
+    }
+
+    for(i = 0; i < SIM_ADC_LEN; i++)
+    {
+        float da = 0.0f, src = 0.0f;
+        for(k = 0; k < tones; k++)
+        {
+            // 波表地址取整：输出为台阶波，基波比理想正弦滞后半个台阶
+            double address = floor((da_start[k] + da_freq[k] * i * dt) * SIM_TABLE_SIZE);
+            uint32_t n = (uint32_t)((int64_t)address & (SIM_TABLE_SIZE - 1));
+            da += table_sin[n] * da_sin[k] - table_cos[n] * da_cos[k];
+
+            double re = src_re[k];
+            src += (float)src_im[k];
+            src_re[k] = re * src_step_re[k] - src_im[k] * src_step_im[k];
+            src_im[k] = re * src_step_im[k] + src_im[k] * src_step_re[k];
+        }
+        adc_buffer[i] = sim_adc_code(da) | (sim_adc_code(src) << 16);
+    }
+
+    sim_plant_advance(SIM_ADC_LEN * dt);
+}
+
+void sim_plant_advance(double dt)
+{
+    uint8_t k;
+
+    for(k = 0; k < NUM_DA_CHANNELS; k++)
+    {
+        da_phase[k] += sim_plant_da_frequency(k) * dt;
+        da_phase[k] -= floor(da_phase[k]);
+    }
+    for(k = 0; k < SIM_TONES; k++)
+    {
+        src_phase[k] += sim_source_frequency(k, sim_time + 0.5 * dt) * dt;
+        src_phase[k] -= floor(src_phase[k]);
+    }
+    sim_time += dt;
+}
+
+float sim_plant_phase_error(uint8_t channel)
+{
+    double freq = sim_plant_da_frequency(channel);
+    double gain, lag;
+    double da, error;
+
+    sim_da_response(freq, &gain, &lag);
+    da = SIM_TWO_PI * (da_phase[channel] + sim_da_phase_word(channel) / (double)SIM_TABLE_SIZE - freq * config->delay) -
+         0.5 * SIM_TWO_PI / SIM_TABLE_SIZE - lag;
+    error = da - SIM_TWO_PI * src_phase[channel];
+    error -= SIM_TWO_PI * floor(error / SIM_TWO_PI + 0.5);
+    return (float)error;
+}
+
+float sim_plant_amp_step(uint32_t amp_word, double dt)
+{
+    amp_state += (config->amp_gain * amp_word - amp_state) * (1.0 - exp(-dt / config->amp_tau));
+    sim_time += dt;
+    return (float)amp_state;
+}
+
+float sim_plant_amp_measure(void)
+{
+    // 并行AD欠采样：相邻采样相差 1025/1024 周期，一帧1024点恰好均匀覆盖一个周期
+    float peak = (float)amp_state * 0.5f * SIM_PAR_SCALE;
+    float start = sim_random();
+    float max = 0.0f, min = 4095.0f;
+    uint16_t i;
+
+    for(i = 0; i < FIFO_SIZE; i++)
+    {
+        float code = floorf(SIM_PAR_MID + peak * sinf((float)SIM_TWO_PI * (start + i / (float)FIFO_SIZE)) +
+                            config->amp_noise * sim_gauss() + 0.5f);
+        code = fminf(fmaxf(code, 0.0f), 4095.0f);
+        max = fmaxf(max, code);
+        min = fminf(min, code);
+    }
+    return (max - min) / SIM_PAR_SCALE;
+}
@@ -7,6 +7,11 @@
 
 #include "my_fft.h"
 #include "my_usart.h"
+#include "goertzel_bank.h"
+#include "clean_separation.h"
+#include "sine_fit.h"
+#include "my_psd.h"
+#include "peak_tracker.h"
 #include <math.h>
 
 // 测试数据生成
@@ -119,6 +124,239 @@ void test_frequency_accuracy(void)
     my_printf(&huart1, "=== 精度测试完成 ===\r\n");
 }
 
+/**
+ * @brief 验证细化频谱对相近频率的分辨能力
+ * @details 两个频率只相差约3个FFT bin，粗寻峰会把它们合并为一个峰值，
+ *          需要由细化频谱分离并给出亚bin精度的频率。
+ */
+void test_zoom_refinement(void)
+{
+    my_printf(&huart1, "\r\n=== 细化频谱测试 ===\r\n");
+    
+    float sampling_freq = 10000.0f;
+    set_current_ad_frequency(sampling_freq);
+    
+    // 频率分辨率约9.77Hz，两个频率间隔约3个bin
+    my_printf(&huart1, "目标频率: 1000.0 Hz + 1030.0 Hz\r\n");
+    generate_dual_sine_signal(1000.0f, 1.0f, 1030.0f, 0.9f, sampling_freq, 0.01f);
+    perform_dual_peak_analysis(test_signal, FFT_LENGTH);
+    my_printf(&huart1, "细化结果: %.2f Hz + %.2f Hz\r\n",
+              dual_peaks.peak1.precise_frequency, dual_peaks.peak2.precise_frequency);
+    
+    my_printf(&huart1, "=== 细化频谱测试完成 ===\r\n");
+}
+
+/**
+ * @brief 验证CLEAN分离对谐波重叠的处理
+ * @details 1kHz方波的3次谐波 (幅度1/3) 与3kHz正弦波重合，单次寻峰容易把谐波当成第二个分量。
+ */
+void test_clean_separation(void)
+{
+    my_printf(&huart1, "\r\n=== CLEAN分离测试 ===\r\n");
+    
+    float sampling_freq = 20000.0f;
+    set_current_ad_frequency(sampling_freq);
+    
+    // 方波由奇次谐波合成 (低于Nyquist频率)，叠加0.5V的3kHz正弦波
+    for(uint16_t i = 0; i < FFT_LENGTH; i++)
+    {
+        float t = i / sampling_freq;
+        float square = 0.0f;
+        for(uint8_t h = 1; h * 1000.0f < 0.5f * sampling_freq; h += 2)
+        {
+            square += sinf(2.0f * 3.14159265f * h * 1000.0f * t) / h;
+        }
+        test_signal[i] = square + 0.5f * sinf(2.0f * 3.14159265f * 3000.0f * t + 1.0f);
+    }
+    
+    clean_result_t result;
+    clean_separate(test_signal, FFT_LENGTH, sampling_freq, 0.15f, &result);
+    for(uint8_t i = 0; i < result.count; i++)
+    {
+        my_printf(&huart1, "分量%d: %.1f Hz, %.3fV, %s\r\n", i + 1, result.components[i].frequency,
+                  result.components[i].amplitude, waveform_name(result.components[i].shape.waveform));
+    }
+    my_printf(&huart1, "期望: 1000 Hz 1.000V SQUARE + 3000 Hz 0.500V SINE\r\n");
+    
+    my_printf(&huart1, "=== CLEAN分离测试完成 ===\r\n");
+}
+
+/**
+ * @brief 验证网格Goertzel检测的频率和波形判定
+ * @details 20kHz正弦波 + 65kHz三角波，2MHz采样，两者都在默认的5kHz网格上。
+ */
+void test_grid_detection(void)
+{
+    my_printf(&huart1, "\r\n=== 网格检测测试 ===\r\n");
+    
+    float sampling_freq = 2000000.0f;
+    float dt = 1.0f / sampling_freq;
+    
+    for(uint16_t i = 0; i < FFT_LENGTH; i++)
+    {
+        float t = i * dt;
+        float phase = fmodf(65000.0f * t, 1.0f);
+        float triangle = (phase < 0.25f) ? 4.0f * phase : ((phase < 0.75f) ? 2.0f - 4.0f * phase : 4.0f * phase - 4.0f);
+        
+        test_signal[i] = sinf(2.0f * 3.14159265f * 20000.0f * t) + triangle
+                       + 0.02f * ((float)rand() / RAND_MAX - 0.5f);
+    }
+    
+    grid_result_t result;
+    goertzel_bank_detect(test_signal, FFT_LENGTH, sampling_freq, 0.15f, &result);
+    goertzel_bank_output(&result);
+    my_printf(&huart1, "期望: 20000 Hz SINE + 65000 Hz TRIANGLE\r\n");
+    
+    // 锯齿波含全部谐波 (1/n)，2次谐波不能当作另一个分量，也不能因奇次谐波判为方波
+    for(uint16_t i = 0; i < FFT_LENGTH; i++)
+    {
+        float t = i * dt;
+        float sawtooth = 2.0f * fmodf(20000.0f * t, 1.0f) - 1.0f;
+        
+        test_signal[i] = sinf(2.0f * 3.14159265f * 30000.0f * t) + sawtooth
+                       + 0.02f * ((float)rand() / RAND_MAX - 0.5f);
+    }
+    
+    goertzel_bank_detect(test_signal, FFT_LENGTH, sampling_freq, 0.15f, &result);
+    goertzel_bank_output(&result);
+    my_printf(&huart1, "期望: 20000 Hz SAWTOOTH + 30000 Hz SINE\r\n");
+    
+    my_printf(&huart1, "=== 网格检测测试完成 ===\r\n");
+}
+
+/**
+ * @brief 验证短记录正弦拟合的幅度、相位和频率
+ * @details 256点、1.5MHz采样的20kHz正弦波 (约3.4个周期)，频率初值偏差0.3%。
+ */
+void test_sine_fit(void)
+{
+    my_printf(&huart1, "\r\n=== 正弦拟合测试 ===\r\n");
+    
+    float sampling_freq = 1500000.0f;
+    uint16_t length = 256;
+    
+    for(uint16_t i = 0; i < length; i++)
+    {
+        float t = i / sampling_freq;
+        test_signal[i] = 1.2f * sinf(2.0f * 3.14159265f * 20000.0f * t + 0.7f) + 1.65f
+                       + 0.01f * ((float)rand() / RAND_MAX - 0.5f);
+    }
+    
+    sine_fit_result_t result;
+    sine_fit_3param(test_signal, length, sampling_freq, 20000.0f, &result);
+    my_printf(&huart1, "三参数: %.4fV, %.4f rad, 偏置 %.4fV, 残差 %.4fV\r\n",
+              result.amplitude, result.phase, result.offset, result.residual_rms);
+    
+    sine_fit_4param(test_signal, length, sampling_freq, 20060.0f, &result);
+    my_printf(&huart1, "四参数: %.2f Hz, %.4fV, %.4f rad, 迭代%d次%s\r\n", result.frequency,
+              result.amplitude, result.phase, result.iterations, result.converged ? "" : " (未收敛)");
+    my_printf(&huart1, "期望: 20000 Hz, 1.2000V, 0.7000 rad, 偏置 1.6500V\r\n");
+    
+    // 双音拟合：两个分量同时求相位
+    length = 1024;
+    for(uint16_t i = 0; i < length; i++)
+    {
+        float t = i / sampling_freq;
+        test_signal[i] = 0.5f * sinf(2.0f * 3.14159265f * 30000.0f * t - 1.0f)
+                       + 0.3f * sinf(2.0f * 3.14159265f * 45000.0f * t + 2.0f) + 1.65f;
+    }
+    
+    sine_fit_result_t tones[2];
+    sine_fit_2tone(test_signal, length, sampling_freq, 30000.0f, 45000.0f, tones);
+    my_printf(&huart1, "双音: %.4fV %.4f rad / %.4fV %.4f rad\r\n",
+              tones[0].amplitude, tones[0].phase, tones[1].amplitude, tones[1].phase);
+    my_printf(&huart1, "期望: 0.5000V -1.0000 rad / 0.3000V 2.0000 rad\r\n");
+    
+    my_printf(&huart1, "=== 正弦拟合测试完成 ===\r\n");
+}
+
+/**
+ * @brief 验证平均功率谱的噪底估计和统计检测门限
+ * @details 10kHz采样，1kHz、0.1V正弦波叠加峰峰值0.4V的均匀噪声 (方差0.4^2/12)，
+ *          单边噪声PSD理论值为 2*方差/fs = 2.67e-6 V^2/Hz。8帧共24段线性平均，
+ *          计入Hanning窗50%重叠的相关性后有效段数约22，z=3.7时门限约为噪底的1.97倍。
+ */
+void test_psd_detection(void)
+{
+    my_printf(&huart1, "\r\n=== 平均功率谱检测测试 ===\r\n");
+    
+    float sampling_freq = 10000.0f;
+    float noise_pp = 0.4f;
+    peak_info_t peaks[MAX_PEAKS];
+    uint8_t count;
+    
+    psd_init(512, 0.5f, WINDOW_HANNING, PSD_AVERAGE_LINEAR, 0.0f);
+    for(uint8_t frame = 0; frame < 8; frame++)
+    {
+        generate_dual_sine_signal(1000.0f, 0.1f, 0.0f, 0.0f, sampling_freq, noise_pp);
+        psd_update(test_signal, FFT_LENGTH, sampling_freq);
+    }
+    
+    float noise = psd_noise_floor();
+    float threshold = psd_detection_threshold(PSD_DEFAULT_Z);
+    my_printf(&huart1, "噪底: %.3e V^2/Hz, 门限/噪底: %.2f\r\n", noise, threshold / noise);
+    my_printf(&huart1, "期望: 噪底 %.3e V^2/Hz, 门限/噪底 1.97\r\n",
+              2.0f * noise_pp * noise_pp / 12.0f / sampling_freq);
+    
+    count = psd_find_peaks(peaks, MAX_PEAKS, PSD_DEFAULT_Z);
+    my_printf(&huart1, "检测到%d个峰值", count);
+    if(count > 0)
+    {
+        my_printf(&huart1, ", 最大: %.1f Hz, %.4fV", peaks[0].precise_frequency, peaks[0].magnitude);
+    }
+    my_printf(&huart1, "\r\n期望: 1个峰值, 1000.0 Hz, 0.1000V\r\n");
+    
+    // 只有噪声时不应检测到峰值 (255个bin，单bin虚警约1e-4，整体约2.5%)
+    psd_reset();
+    for(uint8_t frame = 0; frame < 8; frame++)
+    {
+        generate_dual_sine_signal(0.0f, 0.0f, 0.0f, 0.0f, sampling_freq, noise_pp);
+        psd_update(test_signal, FFT_LENGTH, sampling_freq);
+    }
+    my_printf(&huart1, "纯噪声: 检测到%d个峰值, 期望0\r\n", psd_find_peaks(peaks, MAX_PEAKS, PSD_DEFAULT_Z));
+    
+    // 恢复双峰分析使用的配置
+    psd_init(PSD_ANALYSIS_SEGMENT, 0.5f, WINDOW_HANNING, PSD_AVERAGE_EXPONENTIAL, PSD_ANALYSIS_ALPHA);
+    
+    my_printf(&huart1, "=== 平均功率谱检测测试完成 ===\r\n");
+}
+
+/**
+ * @brief 验证输入信号改变后跟踪结果立即跟随新的检测
+ * @details 前4帧为1000Hz+2000Hz，轨迹确认后输出滤波结果；之后改为1500Hz+2600Hz，
+ *          旧轨迹丢失但尚未删除，不能代替本帧的检测结果。
+ */
+void test_peak_tracker(void)
+{
+    my_printf(&huart1, "\r\n=== 峰值跟踪测试 ===\r\n");
+    
+    const float bin_width = 10.0f;
+    const float freqs[2][2] = {{1000.0f, 2000.0f}, {1500.0f, 2600.0f}};
+    
+    peak_tracker_reset();
+    for(uint8_t frame = 0; frame < 6; frame++)
+    {
+        const float* f = freqs[frame < 4 ? 0 : 1];
+        dual_peak_result_t result;
+        memset(&result, 0, sizeof(result));
+        result.peaks_found = 2;
+        result.peak1.precise_frequency = f[0] + 0.5f * ((float)rand() / RAND_MAX - 0.5f);
+        result.peak1.magnitude = 1.0f;
+        result.peak2.precise_frequency = f[1] + 0.5f * ((float)rand() / RAND_MAX - 0.5f);
+        result.peak2.magnitude = 0.5f;
+        
+        peak_info_t frame_peaks[2] = {result.peak1, result.peak2};
+        uint8_t confirmed = peak_tracker_update(frame_peaks, 2, bin_width);
+        uint8_t applied = peak_tracker_apply(&result);
+        my_printf(&huart1, "帧%d: 确认%d, %s, %.1f Hz + %.1f Hz (期望 %.0f Hz + %.0f Hz)\r\n", frame + 1,
+                  confirmed, applied ? "跟踪值" : "检测值", result.peak1.precise_frequency,
+                  result.peak2.precise_frequency, f[0], f[1]);
+    }
+    peak_tracker_reset();
+    
+    my_printf(&huart1, "=== 峰值跟踪测试完成 ===\r\n");
+}
+
 /**
  * @brief 运行所有测试
  */
@@ -133,6 +371,12 @@ void run_all_dual_peak_tests(void)
     test_dual_peak_detection();
     test_single_peak_detection();
     test_frequency_accuracy();
+    test_zoom_refinement();
+    test_grid_detection();
+    test_clean_separation();
+    test_sine_fit();
+    test_psd_detection();
+    test_peak_tracker();
     
     my_printf(&huart1, "\r\n##### 所有测试完成 #####\r\n");
 }
\ No newline at end of file
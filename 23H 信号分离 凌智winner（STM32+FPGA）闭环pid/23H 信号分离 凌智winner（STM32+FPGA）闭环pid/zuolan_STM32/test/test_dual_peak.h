@@ -16,6 +16,12 @@ void generate_dual_sine_signal(float freq1, float amp1, float freq2, float amp2,
 void test_dual_peak_detection(void);
 void test_single_peak_detection(void);
 void test_frequency_accuracy(void);
+void test_zoom_refinement(void);
+void test_grid_detection(void);
+void test_clean_separation(void);
+void test_sine_fit(void);
+void test_psd_detection(void);
+void test_peak_tracker(void);
 void run_all_dual_peak_tests(void);
 
 #endif /* __TEST_DUAL_PEAK_H */
\ No newline at end of file